@@ -35,9 +35,11 @@ void main()
 
     vec3 normal = normalize(inNormal).rgb;
     if (inTangent != vec4(0.0)) {
-        normal = sampleTexture2DLinear(material.normalTex, inUV).rgb;
-        // normal.y = 1 - normal.y; // flip to make OpenGL normal maps work
-        normal = inTBN * normalize(normal * 2.0 - 1.0);
+        // BC5 normal maps only keep x and y, z is rebuilt for every map
+        vec2 xy = sampleTexture2DLinear(material.normalTex, inUV).rg * 2.0 - 1.0;
+        // xy.y = -xy.y; // flip to make OpenGL normal maps work
+        normal = vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0)));
+        normal = inTBN * normalize(normal);
         normal = normalize(normal);
     }
 
@@ -82,7 +84,7 @@ void main()
     }
 
     vec3 R = reflect(-v, n);
-    vec3 irradiance = sampleTextureCubeLinear(pcs.sceneData.irradianceMapId, n).rgb;
+    vec3 irradiance = shIrradiance(pcs.sceneData.irradianceSH, n);
 
     const float MAX_LOD = 4.0;
     vec3 prefilteredColor = sampleCubeLod(pcs.sceneData.prefilterMapId, R, roughness * MAX_LOD).rgb;
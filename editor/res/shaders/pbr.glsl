@@ -54,3 +54,19 @@ vec3 pbrBRDF(
 
     return Fd + Fr;
 }
+
+// Irradiance / PI around n from the environment's SH9 coefficients, projected and convolved with the cosine
+// lobe on the CPU (math::convolveIrradianceSH9). Ringing can dip below zero opposite a bright sun.
+vec3 shIrradiance(vec3 sh[9], vec3 n) {
+    vec3 irradiance =
+        sh[0] * 0.282095 +
+        sh[1] * 0.488603 * n.y +
+        sh[2] * 0.488603 * n.z +
+        sh[3] * 0.488603 * n.x +
+        sh[4] * 1.092548 * n.x * n.y +
+        sh[5] * 1.092548 * n.y * n.z +
+        sh[6] * 0.315392 * (3.0 * n.y * n.y - 1.0) +
+        sh[7] * 1.092548 * n.x * n.z +
+        sh[8] * 0.546274 * (n.x * n.x - n.z * n.z);
+    return max(irradiance, vec3(0.0));
+}
@@ -25,7 +25,7 @@ layout (buffer_reference, scalar) readonly buffer SceneDataBuffer {
     float ambientIntensity;
 
     //ibl
-    uint irradianceMapId;
+    vec3 irradianceSH[9]; // see shIrradiance
     uint prefilterMapId;
     uint brdfLutId;
 
@@ -389,28 +389,26 @@ void AssetBrowserPopup::updateThumbnails()
         }
 
         // Check if a task for this asset already exists
-        auto existingTask =
-            Application::getTaskManager()->getTask<ImageID>("LoadImage_" + thumbnailInfo.assetPath.string());
-        if (!existingTask)
+        auto &task = m_thumbnailTasks[thumbnailInfo.assetPath];
+        if (!task)
         {
-            // Create a new task to load the image asynchronously
-            auto task =
-                CreateRef<Task<ImageID>>("LoadImage_" + thumbnailInfo.assetPath.string(),
-                                         [&]() -> ImageID { return helper::loadImageFromFile(thumbnailInfo.assetPath); });
-            Application::getTaskManager()->submitTask(task);
+            // Create a new task to load the image asynchronously, behind anything the scene is waiting on
+            task = Task<ImageID>::create(TaskKey{TaskType::ImageLoad, m_nextThumbnailTaskId++},
+                [path = thumbnailInfo.assetPath]() -> ImageID { return helper::loadImageFromFile(path); });
+            Application::getTaskManager()->submitTask(task, TaskPriority::Background);
         }
 
         // Get the task's status and result
-        auto task = Application::getTaskManager()->getTask<ImageID>("LoadImage_" + thumbnailInfo.assetPath.string());
-        if (task->getStatus() == Task<ImageID>::Status::Completed)
+        if (task->isFinished())
         {
             auto result = task->getResult();
-            if (result != NULL_IMAGE_ID)
+            if (result && *result != NULL_IMAGE_ID)
             {
                 auto &cachedImage = m_cachedImages[thumbnailInfo.assetPath];
                 cachedImage.timestamp = thumbnailInfo.timestamp;
                 cachedImage.image = result.value();
             }
+            m_thumbnailTasks.erase(thumbnailInfo.assetPath);
             m_queue.pop(); // Task completed; remove it from the queue
         }
         else
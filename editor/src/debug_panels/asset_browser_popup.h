@@ -61,6 +61,9 @@ class AssetBrowserPopup
     };
     std::map<std::filesystem::path, ThumbnailImage> m_cachedImages;
     std::queue<ThumbnailInfo> m_queue;
+    // loads in flight by full path, their task keys only have to be unique
+    std::map<std::filesystem::path, Ref<Task<ImageID>>> m_thumbnailTasks;
+    uint64_t m_nextThumbnailTaskId = 0;
 
   private:
 	fs::path m_currentDirectory, m_baseDirectory;
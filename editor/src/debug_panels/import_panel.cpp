@@ -1,6 +1,48 @@
 #include "import_panel.h"
 
+#include <imgui.h>
+#include <IconsFontAwesome5.h>
+#include "core/project_management/project_manager.h"
+
 namespace sky
 {
-void ImportPanel::render() {}
-} // namespace sky
\ No newline at end of file
+void ImportPanel::render()
+{
+    auto assetManager = ProjectManager::getEditorAssetManager();
+    if (!ProjectManager::isProjectOpen() || !assetManager) return;
+
+    const auto progress = assetManager->getImportProgress();
+    if (!progress.running) return;
+
+    // small overlay in the bottom right corner of the main viewport
+    const auto *viewport = ImGui::GetMainViewport();
+    const ImVec2 padding{12.0f, 12.0f};
+    ImGui::SetNextWindowPos({viewport->WorkPos.x + viewport->WorkSize.x - padding.x,
+                                viewport->WorkPos.y + viewport->WorkSize.y - padding.y},
+        ImGuiCond_Always, {1.0f, 1.0f});
+    ImGui::SetNextWindowSize({320.0f, 0.0f});
+    ImGui::SetNextWindowBgAlpha(0.85f);
+
+    const auto flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoDocking | ImGuiWindowFlags_NoSavedSettings |
+        ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+    ImGui::Begin("##import_progress", nullptr, flags);
+
+    if (progress.scanning)
+    {
+        ImGui::Text(ICON_FA_SYNC " Scanning assets...");
+    }
+    else
+    {
+        ImGui::Text(ICON_FA_SYNC " Importing assets %zu / %zu", progress.completed, progress.total);
+
+        const auto overlay = progress.completed > 0
+            ? std::format("{:.0f}%  ~{:.0f}s left", progress.getFraction() * 100.0f, progress.etaMs / 1000.0)
+            : std::string("starting");
+        ImGui::ProgressBar(progress.getFraction(), {-1.0f, 0.0f}, overlay.c_str());
+
+        if (progress.failed > 0) ImGui::TextColored({1.0f, 0.4f, 0.4f, 1.0f}, "%zu failed, see the log", progress.failed);
+    }
+
+    ImGui::End();
+}
+} // namespace sky
@@ -231,6 +231,10 @@ void TitlebarPanel::drawMenuBar()
 				if (ImGui::MenuItem("Open Project"))
 				{
                     EditorEventBus::get().pushEvent({EditorEventType::OpenProject});
+				}
+				if (ImGui::MenuItem("Cook Asset Pack"))
+				{
+                    EditorEventBus::get().pushEvent({EditorEventType::CookAssetPack});
 				}
 				ImGui::EndMenu();
 			}
@@ -23,6 +23,10 @@ EditorLayer::EditorLayer()
     m_renderer->init({extent.width, extent.height});
     SceneManager::get().init();
 
+    // started with --packed, everything comes from the project's .skypak instead of its asset folder
+    if (const auto &packedProject = Application::getCommandLine().packedProject; !packedProject.empty())
+        ProjectManager::loadPackedProject(packedProject);
+
     if (!ProjectManager::isProjectOpen())
     {
         if (!ProjectManager::isProjectListEmpty()) m_projectManagerPanel.showOpen();
@@ -133,6 +137,7 @@ void EditorLayer::onImGuiRender()
     m_assetBrowserPopup.render();
     m_logPanel.render();
     m_environmentPanel.render();
+    m_importPanel.render();
 
     ImGui::End();
 }
@@ -198,6 +203,14 @@ void EditorLayer::registerEditorEvents()
             .metadata = std::any_cast<const char *>(event.data), 
         });
     });
+	eventBus.registerHandler(EditorEventType::CookAssetPack, [](const EditorEvent &event){
+        auto assetManager = ProjectManager::getEditorAssetManager();
+        if (!assetManager) return;
+
+        const auto output = ProjectManager::getConfig().getAssetPackPath();
+        Application::getTaskManager()->schedule([assetManager, output] { assetManager->cookAssetPack(output); },
+            TaskPriority::Background, TaskType::AssetImport);
+    });
 }
 
 void EditorLayer::reset() 
@@ -16,6 +16,7 @@
 #include "debug_panels/logs_panel.h"
 #include "debug_panels/titlebar_panel.h"
 #include "debug_panels/viewport_panel.h"
+#include "debug_panels/import_panel.h"
 
 namespace sky
 {
@@ -51,5 +52,6 @@ class EditorLayer : public Layer
     TitlebarPanel       m_titlebarPanel;
     ViewportPanel       m_viewportPanel;
     EnvironmentPanel    m_environmentPanel;
+    ImportPanel         m_importPanel;
 }; 
 } // namespace sky
@@ -40,5 +40,7 @@ class Asset
     AssetHandle handle;
 
     [[nodiscard]] virtual AssetType getType() const = 0;
+    // CPU memory owned by the asset, GPU resources belong to the renderer and are not counted
+    [[nodiscard]] virtual size_t getMemoryUsage() const { return 0; }
 };
 }
\ No newline at end of file
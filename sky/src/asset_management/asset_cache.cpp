@@ -0,0 +1,296 @@
+#include "asset_cache.h"
+
+namespace sky
+{
+struct AssetCache::PendingLoad
+{
+    AssetHandle handle;
+    std::shared_future<Ref<Asset>> future;
+    PendingLoad *parent = nullptr;
+    std::vector<PendingLoad *> children;  // started on its behalf and still loading
+    std::vector<PendingLoad *> waitingOn; // loads its threads are blocked on
+};
+
+static thread_local AssetCache::PendingLoad *s_currentLoad = nullptr;
+
+AssetCache::DependencyScope::DependencyScope(PendingLoad *parent) : m_previous(s_currentLoad)
+{
+    s_currentLoad = parent;
+}
+
+AssetCache::DependencyScope::~DependencyScope()
+{
+    s_currentLoad = m_previous;
+}
+
+AssetCache::PendingLoad *AssetCache::getCurrentLoad()
+{
+    return s_currentLoad;
+}
+
+// true if from can't finish before target has: target is from itself, one of the children from
+// waits for or a load it is blocked on, or one those wait for in turn
+static bool waitsFor(const AssetCache::PendingLoad *from, const AssetCache::PendingLoad *target)
+{
+    std::vector<const AssetCache::PendingLoad *> stack{from};
+    std::unordered_set<const AssetCache::PendingLoad *> visited;
+    while (!stack.empty())
+    {
+        const auto *load = stack.back();
+        stack.pop_back();
+        if (load == target) return true;
+        if (!visited.insert(load).second) continue;
+
+        stack.insert(stack.end(), load->children.begin(), load->children.end());
+        stack.insert(stack.end(), load->waitingOn.begin(), load->waitingOn.end());
+    }
+    return false;
+}
+
+static void eraseOne(std::vector<AssetCache::PendingLoad *> &loads, const AssetCache::PendingLoad *load)
+{
+    auto it = std::find(loads.begin(), loads.end(), load);
+    if (it != loads.end()) loads.erase(it);
+}
+
+AssetCache::AssetCache()
+{
+    for (auto &budget : m_budgets) budget = UNLIMITED_BUDGET;
+    setBudget(AssetType::Texture2D, DEFAULT_TEXTURE_BUDGET);
+    setBudget(AssetType::TextureCube, DEFAULT_TEXTURE_CUBE_BUDGET);
+}
+
+Ref<Asset> AssetCache::find(AssetHandle handle)
+{
+    auto &shard = getShard(handle);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+
+    auto it = shard.assets.find(handle);
+    if (it == shard.assets.end()) return nullptr;
+
+    it->second.lastAccess = tick();
+    m_hits[typeIndex(it->second.asset)]++;
+    return it->second.asset;
+}
+
+bool AssetCache::contains(AssetHandle handle) const
+{
+    const auto &shard = getShard(handle);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    return shard.assets.find(handle) != shard.assets.end();
+}
+
+void AssetCache::insert(AssetHandle handle, const Ref<Asset> &asset)
+{
+    auto &shard = getShard(handle);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    shard.assets[handle] = {asset, tick()};
+}
+
+bool AssetCache::erase(AssetHandle handle)
+{
+    auto &shard = getShard(handle);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    return shard.assets.erase(handle) > 0;
+}
+
+void AssetCache::clear()
+{
+    for (auto &shard : m_shards)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        shard.assets.clear();
+    }
+}
+
+size_t AssetCache::size() const
+{
+    size_t count = 0;
+    for (const auto &shard : m_shards)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        count += shard.assets.size();
+    }
+    return count;
+}
+
+Ref<Asset> AssetCache::getOrLoad(AssetHandle handle, const LoadFn &load)
+{
+    auto &shard = getShard(handle);
+
+    std::promise<Ref<Asset>> promise;
+    Ref<PendingLoad> pending;
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        auto loaded = shard.assets.find(handle);
+        if (loaded != shard.assets.end())
+        {
+            loaded->second.lastAccess = tick();
+            m_hits[typeIndex(loaded->second.asset)]++;
+            return loaded->second.asset;
+        }
+
+        auto it = shard.pending.find(handle);
+        if (it != shard.pending.end())
+        {
+            pending = it->second;
+            lock.unlock();
+            return waitFor(*pending);
+        }
+
+        // linked to its parent before anyone can find it, so a wait on it sees the whole chain
+        pending = CreateRef<PendingLoad>();
+        pending->handle = handle;
+        pending->future = promise.get_future().share();
+        {
+            std::unique_lock<std::mutex> graphLock(m_loadGraphMutex);
+            pending->parent = s_currentLoad;
+            if (pending->parent) pending->parent->children.push_back(pending.get());
+        }
+        shard.pending[handle] = pending;
+    }
+
+    Ref<Asset> asset;
+    try
+    {
+        DependencyScope scope(pending.get());
+        asset = load();
+    }
+    catch (...)
+    {
+        // waiters must not hang on a load that threw
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            removePending(shard, *pending);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        if (asset)
+        {
+            shard.assets[handle] = {asset, tick()};
+            m_misses[typeIndex(asset)]++;
+        }
+        removePending(shard, *pending);
+    }
+    promise.set_value(asset);
+    return asset;
+}
+
+Ref<Asset> AssetCache::waitFor(PendingLoad &pending)
+{
+    // only a thread inside a load can be waited on, anyone else just blocks
+    auto *current = s_currentLoad;
+    if (current)
+    {
+        std::unique_lock<std::mutex> lock(m_loadGraphMutex);
+        if (waitsFor(&pending, current))
+        {
+            SKY_CORE_ERROR("Asset {} depends on itself, the request from within its own load fails",
+                static_cast<uint64_t>(pending.handle));
+            return nullptr;
+        }
+        current->waitingOn.push_back(&pending);
+    }
+
+    pending.future.wait();
+
+    if (current)
+    {
+        std::unique_lock<std::mutex> lock(m_loadGraphMutex);
+        eraseOne(current->waitingOn, &pending);
+    }
+    return pending.future.get();
+}
+
+void AssetCache::removePending(Shard &shard, PendingLoad &pending)
+{
+    shard.pending.erase(pending.handle);
+
+    std::unique_lock<std::mutex> graphLock(m_loadGraphMutex);
+    if (pending.parent) eraseOne(pending.parent->children, &pending);
+    pending.parent = nullptr;
+}
+
+size_t AssetCache::evict()
+{
+    struct Candidate
+    {
+        AssetHandle handle;
+        uint64_t lastAccess;
+        size_t bytes;
+    };
+
+    std::array<size_t, ASSET_TYPE_COUNT> residentBytes{};
+    std::array<std::vector<Candidate>, ASSET_TYPE_COUNT> candidates;
+    for (const auto &shard : m_shards)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        for (const auto &[handle, entry] : shard.assets)
+        {
+            const auto type = typeIndex(entry.asset);
+            const auto bytes = entry.asset->getMemoryUsage();
+            residentBytes[type] += bytes;
+
+            // only the cache holds it, and dropping it actually frees something
+            if (entry.asset.use_count() == 1 && bytes > 0) candidates[type].push_back({handle, entry.lastAccess, bytes});
+        }
+    }
+
+    size_t evicted = 0;
+    for (size_t type = 0; type < ASSET_TYPE_COUNT; ++type)
+    {
+        const size_t budget = m_budgets[type];
+        if (residentBytes[type] <= budget) continue;
+
+        auto &typeCandidates = candidates[type];
+        std::sort(typeCandidates.begin(), typeCandidates.end(),
+            [](const Candidate &a, const Candidate &b) { return a.lastAccess < b.lastAccess; });
+
+        for (const auto &candidate : typeCandidates)
+        {
+            if (residentBytes[type] <= budget) break;
+
+            auto &shard = getShard(candidate.handle);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+
+            // picked up again since the scan
+            auto it = shard.assets.find(candidate.handle);
+            if (it == shard.assets.end() || it->second.asset.use_count() != 1 ||
+                it->second.lastAccess != candidate.lastAccess)
+                continue;
+
+            shard.assets.erase(it);
+            residentBytes[type] -= candidate.bytes;
+            m_evictions[type]++;
+            evicted++;
+        }
+    }
+    return evicted;
+}
+
+AssetResidencyStats AssetCache::getResidencyStats(AssetType type) const
+{
+    const auto index = static_cast<size_t>(type);
+
+    AssetResidencyStats stats;
+    for (const auto &shard : m_shards)
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        for (const auto &[handle, entry] : shard.assets)
+        {
+            if (typeIndex(entry.asset) != index) continue;
+            stats.residentCount++;
+            stats.residentBytes += entry.asset->getMemoryUsage();
+        }
+    }
+    stats.budgetBytes = m_budgets[index];
+    stats.hits = m_hits[index];
+    stats.misses = m_misses[index];
+    stats.evictions = m_evictions[index];
+    return stats;
+}
+} // namespace sky
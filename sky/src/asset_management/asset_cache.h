@@ -0,0 +1,119 @@
+#pragma once
+
+#include <skypch.h>
+#include "asset.h"
+
+namespace sky
+{
+static constexpr size_t ASSET_TYPE_COUNT = static_cast<size_t>(AssetType::Folder) + 1;
+
+struct AssetResidencyStats
+{
+    size_t residentCount = 0;
+    size_t residentBytes = 0;
+    size_t budgetBytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0; // lookups that had to load
+    uint64_t evictions = 0;
+};
+
+// Loaded assets by handle, split over shards so concurrent lookups and loads of different assets
+// rarely share a lock. Every handle is loaded at most once, concurrent requests wait on the
+// same future.
+//
+// Loads started while another one runs, on its thread or in a DependencyScope of it, are its
+// children. A request that would wait on a load which itself waits on the requester, directly or
+// through its children, fails instead of deadlocking.
+//
+// Each asset type has a memory budget. evict() drops the least recently used assets nobody else
+// holds a reference to until every type is back under its budget.
+class AssetCache
+{
+  public:
+    using LoadFn = std::function<Ref<Asset>()>;
+
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t UNLIMITED_BUDGET = std::numeric_limits<size_t>::max();
+    static constexpr size_t DEFAULT_TEXTURE_BUDGET = size_t(1024) << 20;
+    static constexpr size_t DEFAULT_TEXTURE_CUBE_BUDGET = size_t(512) << 20;
+
+    // A load in progress, opaque outside the cache
+    struct PendingLoad;
+
+    // Makes the loads started on this thread children of parent, for work a load hands to other threads
+    class DependencyScope
+    {
+      public:
+        explicit DependencyScope(PendingLoad *parent);
+        ~DependencyScope();
+
+        DependencyScope(const DependencyScope &) = delete;
+        DependencyScope &operator=(const DependencyScope &) = delete;
+
+      private:
+        PendingLoad *m_previous;
+    };
+
+    // The load running on this thread, nullptr outside of any
+    static PendingLoad *getCurrentLoad();
+
+    AssetCache();
+
+    Ref<Asset> find(AssetHandle handle);
+    bool contains(AssetHandle handle) const;
+    void insert(AssetHandle handle, const Ref<Asset> &asset);
+    bool erase(AssetHandle handle);
+    void clear();
+    size_t size() const;
+
+    // Returns the cached asset, or runs load if no other thread is loading it already. Other
+    // callers block until the load finished, a caller the load waits on gets nullptr. Failed
+    // loads (nullptr or an exception) are not cached.
+    Ref<Asset> getOrLoad(AssetHandle handle, const LoadFn &load);
+
+    void setBudget(AssetType type, size_t bytes) { m_budgets[static_cast<size_t>(type)] = bytes; }
+    size_t getBudget(AssetType type) const { return m_budgets[static_cast<size_t>(type)]; }
+
+    // Returns the number of assets evicted
+    size_t evict();
+    AssetResidencyStats getResidencyStats(AssetType type) const;
+
+  private:
+    struct Entry
+    {
+        Ref<Asset> asset;
+        uint64_t lastAccess = 0;
+    };
+
+    struct Shard
+    {
+        std::unordered_map<AssetHandle, Entry> assets;
+        std::unordered_map<AssetHandle, Ref<PendingLoad>> pending;
+        mutable std::mutex mutex;
+    };
+
+    Ref<Asset> waitFor(PendingLoad &pending);
+    // drops a finished load from the shard and from its parent, with the shard locked
+    void removePending(Shard &shard, PendingLoad &pending);
+
+    Shard &getShard(AssetHandle handle) { return m_shards[std::hash<AssetHandle>()(handle) % SHARD_COUNT]; }
+    const Shard &getShard(AssetHandle handle) const
+    {
+        return m_shards[std::hash<AssetHandle>()(handle) % SHARD_COUNT];
+    }
+
+    uint64_t tick() { return m_accessClock.fetch_add(1, std::memory_order_relaxed); }
+    static size_t typeIndex(const Ref<Asset> &asset) { return std::min<size_t>(static_cast<size_t>(asset->getType()), ASSET_TYPE_COUNT - 1); }
+
+  private:
+    std::array<Shard, SHARD_COUNT> m_shards;
+    std::atomic<uint64_t> m_accessClock{1};
+    // guards the children and waits of every pending load, always taken after a shard lock
+    std::mutex m_loadGraphMutex;
+
+    std::array<std::atomic<size_t>, ASSET_TYPE_COUNT> m_budgets;
+    std::array<std::atomic<uint64_t>, ASSET_TYPE_COUNT> m_hits{};
+    std::array<std::atomic<uint64_t>, ASSET_TYPE_COUNT> m_misses{};
+    std::array<std::atomic<uint64_t>, ASSET_TYPE_COUNT> m_evictions{};
+};
+} // namespace sky
@@ -0,0 +1,257 @@
+#include "asset_hot_reloader.h"
+
+#include <FileWatch.h>
+#include <tracy/Tracy.hpp>
+
+#include "asset_importer.h"
+#include "editor_asset_manager.h"
+#include "core/application.h"
+#include "core/helpers/image.h"
+#include "core/helpers/mapped_file.h"
+#include "core/resource/import_data.h"
+#include "core/resource/material_serializer.h"
+#include "core/resource/mesh_serializer.h"
+#include "core/resource/texture_serializer.h"
+
+namespace sky
+{
+static fs::path getCookedPath(const fs::path &source)
+{
+    const auto importDataFile = fs::path(source.string() + ".import");
+    if (!fs::exists(importDataFile)) return {};
+
+    ImportData data;
+    ImportDataSerializer dataSerializer(data);
+    return dataSerializer.deserialize(importDataFile) ? data.destination : fs::path{};
+}
+
+static bool reloadTexture(const Ref<Texture2D> &texture, const fs::path &path)
+{
+    TextureSerializer serializer;
+    auto fresh = serializer.deserialize(getCookedPath(path));
+    if (!fresh) return false;
+
+    const auto imageId = texture->vkImageID;
+    fresh->handle = texture->handle;
+    fresh->vkImageID = NULL_IMAGE_ID;
+    *texture = std::move(*fresh);
+
+    // not uploaded yet, the first use picks up the new pixels
+    if (imageId != NULL_IMAGE_ID) helper::replaceImageFromTexture(texture, imageId);
+    return true;
+}
+
+static bool reloadModel(const Ref<Model> &model, AssetHandle handle, const fs::path &path)
+{
+    helper::MappedFile file;
+    if (!file.open(getCookedPath(path))) return false;
+
+    MeshSerializer serializer;
+    auto meshes = serializer.deserializeWithMaterials({file.data(), file.size()}, handle);
+    if (meshes.empty()) return false;
+
+    auto renderer = Application::getRenderer();
+    const auto oldCount = model->meshes.size();
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        auto &[mesh, material] = meshes[i];
+        if (i < oldCount)
+        {
+            const auto meshId = model->meshes[i];
+            mesh.material = renderer->getMesh(meshId).material;
+            renderer->updateMaterial(mesh.material, material);
+            renderer->replaceMeshInCache(meshId, mesh);
+        }
+        else
+        {
+            mesh.material = renderer->addMaterialToCache(material);
+            model->meshes.push_back(renderer->addMeshToCache(mesh));
+        }
+    }
+
+    // meshes the new version no longer has
+    for (size_t i = meshes.size(); i < oldCount; ++i) renderer->removeMeshFromCache(model->meshes[i]);
+    model->meshes.resize(meshes.size());
+    return true;
+}
+
+static bool reloadMaterial(const Ref<MaterialAsset> &asset, const fs::path &path, const fs::path &relativePath)
+{
+    MaterialSerializer serializer;
+    auto material = serializer.deserialize(path);
+    material.name = relativePath.string();
+    Application::getRenderer()->updateMaterial(asset->material, material);
+    return true;
+}
+
+AssetHotReloader::~AssetHotReloader()
+{
+    stop();
+}
+
+void AssetHotReloader::start(const fs::path &assetDirectory)
+{
+    stop();
+
+    m_assetDirectory = assetDirectory;
+    m_state = CreateRef<State>();
+
+    watchDirectory(m_state, assetDirectory);
+#ifndef _WIN32
+    // inotify watches are not recursive, directories created later are picked up by their parent
+    std::error_code error;
+    for (auto it = fs::recursive_directory_iterator(assetDirectory, error); !error && it != fs::end(it);
+         it.increment(error))
+    {
+        if (it->is_directory()) watchDirectory(m_state, it->path());
+    }
+#endif
+}
+
+void AssetHotReloader::stop()
+{
+    std::vector<Scope<Watcher>> watchers;
+    {
+        std::unique_lock<std::mutex> lock(m_watcherMutex);
+        if (m_state) m_state->token.cancel();
+        watchers = std::move(m_watchers);
+        m_watchers.clear();
+    }
+    // joins the watcher threads, so not under the lock a callback may be waiting on
+    watchers.clear();
+    m_state = nullptr;
+}
+
+void AssetHotReloader::watchDirectory(const Ref<State> &state, const fs::path &directory)
+{
+    auto onEvent = [this, state, directory](const std::string &file, const filewatch::Event event)
+    {
+        if (event == filewatch::Event::removed || event == filewatch::Event::renamed_old) return;
+
+        const auto path = directory / file;
+#ifndef _WIN32
+        if (event == filewatch::Event::added && fs::is_directory(path))
+        {
+            watchDirectory(state, path);
+            return;
+        }
+#endif
+        if (!isReloadable(path)) return;
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->changed[path.generic_string()] = std::chrono::steady_clock::now();
+    };
+
+    std::unique_lock<std::mutex> lock(m_watcherMutex);
+    if (state->token.isCancelled()) return;
+
+    try
+    {
+        m_watchers.push_back(CreateScope<Watcher>(directory.string(), onEvent));
+    }
+    catch (const std::system_error &e)
+    {
+        SKY_CORE_ERROR("Failed to watch {} for changes: {}", directory.string(), e.what());
+    }
+}
+
+void AssetHotReloader::update(EditorAssetManager &assetManager, TaskManager &taskManager)
+{
+    auto state = m_state;
+    if (!state) return;
+
+    std::vector<std::string> ready;
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = state->changed.begin(); it != state->changed.end();)
+        {
+            // a path still being imported is picked up again once that import is done
+            if (now - it->second < COALESCE_DELAY || state->inFlight.contains(it->first))
+            {
+                ++it;
+                continue;
+            }
+            state->inFlight.insert(it->first);
+            ready.push_back(it->first);
+            it = state->changed.erase(it);
+        }
+    }
+
+    for (const auto &path : ready)
+    {
+        const auto handle = assetManager.findAssetHandle(fs::relative(path, m_assetDirectory));
+        reload(assetManager, taskManager, state, path, handle);
+    }
+}
+
+bool AssetHotReloader::isReloadable(const fs::path &path)
+{
+    if (path.extension() == ".import") return false;
+
+    switch (getAssetTypeFromFileExtension(path.extension()))
+    {
+        case AssetType::Mesh:
+        case AssetType::Texture2D:
+        case AssetType::TextureCube:
+        case AssetType::Material: return true;
+        default: return false;
+    }
+}
+
+void AssetHotReloader::reload(EditorAssetManager &assetManager, TaskManager &taskManager, const Ref<State> &state,
+    const fs::path &path, AssetHandle handle)
+{
+    const auto type = getAssetTypeFromFileExtension(path.extension());
+
+    taskManager.schedule([&assetManager, &taskManager, state, path, handle, type]
+        {
+            ZoneScopedN("Hot reload import");
+
+            bool changed = true; // materials are read straight from the source
+            if (AssetImporter::isCookable(type))
+            {
+                const auto before = getCookedPath(path);
+                if (!AssetImporter::cookAsset(type, path))
+                {
+                    SKY_CORE_ERROR("Hot reload of {} failed to import", path.string());
+                    changed = false;
+                }
+                // the cache key is the content hash, a file that was only touched keeps its cooked file
+                else changed = getCookedPath(path) != before;
+            }
+
+            taskManager.postToMainThread([&assetManager, state, path, handle, type, changed]
+                {
+                    if (!state->token.isCancelled() && changed && applyReload(assetManager, handle, type, path))
+                        SKY_CORE_INFO("Hot reloaded {}", path.string());
+
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->inFlight.erase(path.generic_string());
+                });
+        },
+        TaskPriority::Interactive, TaskType::AssetImport);
+}
+
+bool AssetHotReloader::applyReload(EditorAssetManager &assetManager, AssetHandle handle, AssetType type,
+    const fs::path &path)
+{
+    // not loaded, the next load reads the new version anyway
+    if (handle == NULL_UUID || !assetManager.isAssetLoaded(handle)) return false;
+
+    ZoneScopedN("Hot reload swap");
+    auto asset = assetManager.getAsset(handle);
+    switch (type)
+    {
+        case AssetType::Texture2D: return reloadTexture(std::static_pointer_cast<Texture2D>(asset), path);
+        case AssetType::Mesh: return reloadModel(std::static_pointer_cast<Model>(asset), handle, path);
+        case AssetType::Material:
+            return reloadMaterial(std::static_pointer_cast<MaterialAsset>(asset), path,
+                assetManager.getFilePath(handle));
+        default:
+            // the environment bakes its lighting from the cube when it is applied
+            SKY_CORE_INFO("{} was re-imported, apply the environment again to see the change", path.string());
+            return false;
+    }
+}
+} // namespace sky
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <skypch.h>
+#include "asset.h"
+#include "core/tasks/task_manager.h"
+
+namespace filewatch
+{
+template <class T> class FileWatch;
+}
+
+namespace sky
+{
+class EditorAssetManager;
+
+// Watches the asset directory and re-imports sources that changed on disk. The new data is swapped
+// into the loaded asset, so asset handles, mesh and material ids and bindless image slots stay the
+// same and nothing referencing them has to be updated. Events for a path are coalesced until it has
+// been quiet for COALESCE_DELAY, one save that touches a file several times imports it once.
+class AssetHotReloader
+{
+  public:
+    static constexpr std::chrono::milliseconds COALESCE_DELAY{300};
+
+    AssetHotReloader() = default;
+    ~AssetHotReloader();
+
+    AssetHotReloader(const AssetHotReloader &) = delete;
+    AssetHotReloader &operator=(const AssetHotReloader &) = delete;
+
+    void start(const fs::path &assetDirectory);
+    void stop();
+
+    // Main thread, every frame. Cooks paths that went quiet on the task pool and swaps the result in
+    // on the main thread.
+    void update(EditorAssetManager &assetManager, TaskManager &taskManager);
+
+  private:
+    using Watcher = filewatch::FileWatch<std::string>;
+
+    // shared with the jobs, so the reloader can go away while an import is still running
+    struct State
+    {
+        CancellationToken token;
+        std::unordered_map<std::string, std::chrono::steady_clock::time_point> changed; // path -> last event
+        std::unordered_set<std::string> inFlight;
+        std::mutex mutex;
+    };
+
+    void watchDirectory(const Ref<State> &state, const fs::path &directory);
+
+    static bool isReloadable(const fs::path &path);
+    static void reload(EditorAssetManager &assetManager, TaskManager &taskManager, const Ref<State> &state,
+        const fs::path &path, AssetHandle handle);
+    static bool applyReload(EditorAssetManager &assetManager, AssetHandle handle, AssetType type,
+        const fs::path &path);
+
+  private:
+    Ref<State> m_state;
+    fs::path m_assetDirectory;
+    std::vector<Scope<Watcher>> m_watchers;
+    std::mutex m_watcherMutex;
+};
+} // namespace sky
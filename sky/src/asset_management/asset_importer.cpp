@@ -19,6 +19,21 @@ static std::unordered_map<AssetType, AssetImportFn> s_assetImportFns = {
     {AssetType::Material,       MaterialImporter::importAsset},
 };
 
+struct AssetCookFns
+{
+    std::function<bool(const fs::path &)> needsCook;
+    std::function<bool(const fs::path &)> cook;
+};
+
+static std::unordered_map<AssetType, AssetCookFns> s_assetCookFns = {
+    {AssetType::Mesh,           {MeshImporter::needsCook,           MeshImporter::cookAsset}},
+    {AssetType::Texture2D,      {TextureImporter::needsCook,        TextureImporter::cookAsset}},
+    {AssetType::TextureCube,    {TextureCubeImporter::needsCook,    TextureCubeImporter::cookAsset}},
+};
+
+// striped by source path, two threads never write the same .import file at once
+static std::array<std::mutex, 64> s_cookMutexes;
+
 Ref<Asset> AssetImporter::importAsset(AssetHandle handle, AssetMetadata &metadata) 
 {
     if (s_assetImportFns.find(metadata.type) == s_assetImportFns.end())
@@ -30,4 +45,27 @@ Ref<Asset> AssetImporter::importAsset(AssetHandle handle, AssetMetadata &metadat
 
     return s_assetImportFns.at(metadata.type)(handle, metadata);
 }
+
+bool AssetImporter::isCookable(AssetType type)
+{
+    return s_assetCookFns.find(type) != s_assetCookFns.end();
+}
+
+bool AssetImporter::needsCook(AssetType type, const fs::path &path)
+{
+    auto it = s_assetCookFns.find(type);
+    return it != s_assetCookFns.end() && it->second.needsCook(path);
+}
+
+bool AssetImporter::cookAsset(AssetType type, const fs::path &path)
+{
+    auto it = s_assetCookFns.find(type);
+    if (it == s_assetCookFns.end()) return true;
+
+    auto &mutex = s_cookMutexes[std::hash<std::string>()(path.generic_string()) % s_cookMutexes.size()];
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (!it->second.needsCook(path)) return true;
+    return it->second.cook(path);
+}
 } // namespace sky
\ No newline at end of file
@@ -10,5 +10,12 @@ class AssetImporter
 {
   public:
     static Ref<Asset> importAsset(AssetHandle handle, AssetMetadata &metadata);
+
+    // Types whose source files are converted into a binary file in the imported cache first
+    static bool isCookable(AssetType type);
+    static bool needsCook(AssetType type, const fs::path &path);
+    // Brings the cooked file of the source at path up to date. Safe to call from several threads,
+    // cooks of the same source are serialized.
+    static bool cookAsset(AssetType type, const fs::path &path);
 };
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "asset.h"
 #include "core/project_management/project_manager.h"
 #include "core/tasks/task_manager.h"
+#include "core/tasks/async.h"
 #include "core/application.h"
 
 namespace sky
@@ -14,70 +15,110 @@ class AssetManager
   public:
     template <typename T> static Ref<T> getAsset(AssetHandle handle)
     {
-        auto manager = ProjectManager::getEditorAssetManager();
+        auto manager = ProjectManager::getAssetManager();
         auto asset = manager->getAsset(handle);
         return std::static_pointer_cast<T>(asset);
     }
 
+    // The callback runs on the main thread once the asset is loaded, right away when it already is and this
+    // is the main thread. Callers asking for the same asset share one task.
     template <typename T>
-    static Ref<Task<Ref<T>>> getAssetAsync(AssetHandle handle, std::function<void(const Ref<T> &)> callback = nullptr)
+    static Ref<Task<Ref<T>>> getAssetAsync(AssetHandle handle, std::function<void(const Ref<T> &)> callback = nullptr,
+        TaskPriority priority = TaskPriority::Visible)
     {
-        std::string taskName = "AsyncAssetTask_" + std::to_string(handle);
+        const auto key = TaskKey{TaskType::AssetLoad, handle};
+        auto taskManager = Application::getTaskManager();
 
-        auto task = Application::getTaskManager()->getTask<Ref<T>>(taskName);
-        if (task)
+        auto task = taskManager->getTask<Ref<T>>(key);
+        // a load cancelled before it ran (see StreamingManager) is submitted again below
+        if (task == nullptr || task->getStatus() == Task<Ref<T>>::Status::Cancelled)
         {
-            if (task->getStatus() == Task<Ref<T>>::Status::Completed)
+            // the task that loaded it has already been evicted from the registry
+            if (isAssetLoaded(handle))
             {
-                if (callback) callback(*task->getResult());
+                task = Task<Ref<T>>::fromResult(key, getAsset<T>(handle));
+                if (callback) completeOnMainThread(*taskManager, callback, *task->getResult());
                 return task;
             }
-            return task;
-        }
 
-        // Create a new task since none exists
-        task = CreateRef<Task<Ref<T>>>(taskName,
-            [handle]() -> Ref<T>
+            bool created = false;
+            task = taskManager->getOrAddTask<Ref<T>>(key,
+                [&]
+                {
+                    return Task<Ref<T>>::create(key,
+                        [handle]() -> Ref<T>
+                        {
+                            auto asset = ProjectManager::getAssetManager()->getAsset(handle);
+                            return std::static_pointer_cast<T>(asset);
+                        });
+                },
+                created);
+            if (created)
             {
-                auto asset = ProjectManager::getEditorAssetManager()->getAsset(handle);
-                return std::static_pointer_cast<T>(asset);
-            });
+                // callbacks touch renderer and editor state, keep them off the workers
+                if (callback) task->setCallback(callback, CompletionThread::Main);
+                taskManager->submitTask(task, priority);
+                return task;
+            }
+        }
 
-        if (callback) task->setCallback(callback);
+        // another caller's load, finished or on its way, this one may be more urgent
+        if (priority < task->getPriority()) taskManager->reprioritize(key, priority);
+        if (callback)
+        {
+            task->onFinished(
+                [taskManager, task = task.get(), callback]
+                {
+                    if (auto asset = task->getResult()) completeOnMainThread(*taskManager, callback, *asset);
+                });
+        }
+        return task;
+    }
 
-        Application::getTaskManager()->submitTask(task);
+    // Awaitable load, `auto model = co_await AssetManager::load<Model>(handle);` inside an Async coroutine.
+    // The load is submitted right away, the coroutine resumes on resumeOn once it is done.
+    template <typename T>
+    static TaskAwaiter<Ref<T>> load(AssetHandle handle, CompletionThread resumeOn = CompletionThread::Worker,
+        TaskPriority priority = TaskPriority::Visible)
+    {
+        auto &taskManager = *Application::getTaskManager();
 
-        return task;
+        return TaskAwaiter<Ref<T>>(taskManager, getAssetAsync<T>(handle, nullptr, priority), resumeOn);
     }
 
     static AssetHandle getOrCreateAssetHandle(fs::path path, AssetType assetType)
     {
-        return ProjectManager::getEditorAssetManager()->getOrCreateAssetHandle(path, assetType);
+        return ProjectManager::getAssetManager()->getOrCreateAssetHandle(path, assetType);
     }
 
     static AssetMetadata &getMetadata(AssetHandle handle)
     {
-        return ProjectManager::getEditorAssetManager()->getMetadata(handle);
+        return ProjectManager::getAssetManager()->getMetadata(handle);
     }
 
     static void addToDependencyList(AssetHandle handle, AssetHandle dependency)
     {
-        auto &deps = AssetManager::getMetadata(handle).dependencies;
-        if (std::find(deps.begin(), deps.end(), dependency) == deps.end())
-        {
-            deps.push_back(dependency); // Add the dependency if it's not already in the list
-        }
+        ProjectManager::getAssetManager()->addDependency(handle, dependency);
     }
 
     static bool isAssetLoaded(AssetHandle handle)
     {
-        return ProjectManager::getEditorAssetManager()->isAssetLoaded(handle);
+        return ProjectManager::getAssetManager()->isAssetLoaded(handle);
     }
 
-    static bool removeAsset(AssetHandle handle) { return ProjectManager::getEditorAssetManager()->removeAsset(handle); }
+    static bool removeAsset(AssetHandle handle) { return ProjectManager::getAssetManager()->removeAsset(handle); }
 
-    static void unloadAllAssets() { return ProjectManager::getEditorAssetManager()->unloadAllAssets(); }
+    static void unloadAllAssets() { return ProjectManager::getAssetManager()->unloadAllAssets(); }
 
-    static void serializeAssetDirectory() { ProjectManager::getEditorAssetManager()->serializeAssetRegistry(); }
+    static void serializeAssetDirectory() { ProjectManager::getAssetManager()->serializeAssetRegistry(); }
+
+  private:
+    template <typename T>
+    static void completeOnMainThread(TaskManager &taskManager, const std::function<void(const Ref<T> &)> &callback,
+        const Ref<T> &asset)
+    {
+        if (taskManager.isMainThread()) callback(asset);
+        else taskManager.postToMainThread([callback, asset] { callback(asset); });
+    }
 };
 } // namespace sky
\ No newline at end of file
@@ -21,5 +21,8 @@ class AssetManagerBase
     virtual bool removeAsset(AssetHandle handle) = 0;
     virtual void unloadAllAssets() = 0;
     virtual AssetType getAssetType(AssetHandle handle) const = 0;
+
+    // recorded by the editor, a packed project has its dependencies baked in
+    virtual void addDependency(AssetHandle handle, AssetHandle dependency) {}
 };
 }
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "asset_pack.h"
+
+#include <cstring>
+
+namespace sky
+{
+static_assert(sizeof(AssetPack::Header) == 40);
+static_assert(sizeof(AssetPack::Entry) == 32);
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+bool AssetPack::open(const fs::path &path)
+{
+    if (!m_file.open(path))
+    {
+        SKY_CORE_ERROR("Failed to map asset pack {}", path.string());
+        return false;
+    }
+
+    auto fail = [&](const char *reason)
+    {
+        SKY_CORE_ERROR("Asset pack {} is invalid: {}", path.string(), reason);
+        m_file.close();
+        return false;
+    };
+
+    if (m_file.size() < sizeof(Header)) return fail("truncated header");
+    Header header;
+    std::memcpy(&header, m_file.data(), sizeof(header));
+
+    if (header.magic != MAGIC) return fail("bad magic");
+    if (header.version != VERSION) return fail("unsupported version");
+
+    const uint64_t tocSize = uint64_t(header.entryCount) * sizeof(Entry);
+    if (header.tocOffset % alignof(Entry) != 0 || header.tocOffset + tocSize > m_file.size() ||
+        header.stringsOffset + header.stringsSize > m_file.size())
+        return fail("table of contents out of range");
+
+    m_entries = reinterpret_cast<const Entry *>(m_file.data() + header.tocOffset);
+    m_entryCount = header.entryCount;
+    m_strings = {reinterpret_cast<const char *>(m_file.data() + header.stringsOffset), header.stringsSize};
+
+    for (const auto &entry : getEntries())
+    {
+        if (entry.offset + entry.size > header.tocOffset ||
+            uint64_t(entry.pathOffset) + entry.pathLength > header.stringsSize)
+            return fail("entry out of range");
+    }
+    return true;
+}
+
+const AssetPack::Entry *AssetPack::find(AssetHandle handle) const
+{
+    const auto entries = getEntries();
+    auto it = std::lower_bound(entries.begin(), entries.end(), static_cast<uint64_t>(handle),
+        [](const Entry &entry, uint64_t value) { return entry.handle < value; });
+    return it != entries.end() && it->handle == handle ? &*it : nullptr;
+}
+
+bool AssetPackWriter::write(const fs::path &output, std::vector<Source> sources)
+{
+    std::sort(sources.begin(), sources.end(),
+        [](const Source &a, const Source &b) { return uint64_t(a.handle) < uint64_t(b.handle); });
+
+    const auto tmp = fs::path(output.string() + ".tmp");
+    std::ofstream file(tmp, std::ios::binary);
+    if (!file.is_open())
+    {
+        SKY_CORE_ERROR("Failed to open asset pack {} for writing", tmp.string());
+        return false;
+    }
+
+    auto pad = [&file](uint64_t alignment)
+    {
+        const auto position = static_cast<uint64_t>(file.tellp());
+        const auto padding = alignUp(position, alignment) - position;
+        static const char zeros[AssetPack::BLOB_ALIGNMENT] = {};
+        file.write(zeros, padding);
+    };
+
+    AssetPack::Header header{.magic = AssetPack::MAGIC, .version = AssetPack::VERSION};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    std::vector<AssetPack::Entry> entries;
+    std::string strings;
+    std::vector<char> buffer;
+    for (const auto &source : sources)
+    {
+        std::ifstream blob(source.file, std::ios::binary | std::ios::ate);
+        if (!blob.is_open())
+        {
+            SKY_CORE_ERROR("Failed to pack {}, {} could not be read", source.path.string(), source.file.string());
+            continue;
+        }
+        buffer.resize(static_cast<size_t>(blob.tellg()));
+        blob.seekg(0);
+        blob.read(buffer.data(), buffer.size());
+
+        pad(AssetPack::BLOB_ALIGNMENT);
+        const auto path = source.path.generic_string();
+        entries.push_back({
+            .handle = source.handle,
+            .offset = static_cast<uint64_t>(file.tellp()),
+            .size = buffer.size(),
+            .pathOffset = static_cast<uint32_t>(strings.size()),
+            .pathLength = static_cast<uint16_t>(path.size()),
+            .type = static_cast<uint16_t>(source.type),
+        });
+        strings += path;
+        file.write(buffer.data(), buffer.size());
+    }
+
+    pad(alignof(AssetPack::Entry));
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.tocOffset = static_cast<uint64_t>(file.tellp());
+    file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(AssetPack::Entry));
+
+    header.stringsOffset = static_cast<uint64_t>(file.tellp());
+    header.stringsSize = strings.size();
+    file.write(strings.data(), strings.size());
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+    if (!file)
+    {
+        SKY_CORE_ERROR("Failed to write asset pack {}", tmp.string());
+        return false;
+    }
+
+    std::error_code error;
+    fs::rename(tmp, output, error);
+    if (error)
+    {
+        SKY_CORE_ERROR("Failed to move asset pack to {}: {}", output.string(), error.message());
+        return false;
+    }
+
+    SKY_CORE_INFO("Packed {} assets into {}", entries.size(), output.string());
+    return true;
+}
+} // namespace sky
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <skypch.h>
+#include "asset.h"
+#include "core/helpers/mapped_file.h"
+
+namespace sky
+{
+// Every cooked asset of a project in one memory-mapped file. Blobs are the cooked files (or the
+// source for assets that are not cooked), each aligned to BLOB_ALIGNMENT. The table of contents is
+// sorted by handle and read in place.
+//
+// layout: Header | blobs | Entry[entryCount] | path strings
+class AssetPack
+{
+  public:
+    static constexpr uint32_t MAGIC = 0x50594B53; // "SKYP"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t BLOB_ALIGNMENT = 64;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+        uint64_t tocOffset;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+    };
+
+    struct Entry
+    {
+        uint64_t handle;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t pathOffset; // into the path strings, asset directory relative
+        uint16_t pathLength;
+        uint16_t type;
+    };
+
+    bool open(const fs::path &path);
+    bool isOpen() const { return m_file.isOpen(); }
+
+    const Entry *find(AssetHandle handle) const;
+    std::span<const Entry> getEntries() const { return {m_entries, m_entryCount}; }
+    std::span<const uint8_t> getBlob(const Entry &entry) const { return {m_file.data() + entry.offset, entry.size}; }
+    std::string_view getPath(const Entry &entry) const { return m_strings.substr(entry.pathOffset, entry.pathLength); }
+
+  private:
+    helper::MappedFile m_file;
+    const Entry *m_entries = nullptr;
+    uint32_t m_entryCount = 0;
+    std::string_view m_strings;
+};
+
+class AssetPackWriter
+{
+  public:
+    struct Source
+    {
+        AssetHandle handle;
+        AssetType type;
+        fs::path path; // asset directory relative
+        fs::path file; // whose contents become the blob
+    };
+
+    // Written under a temporary name and renamed, a pack that is in use is never half written
+    static bool write(const fs::path &output, std::vector<Source> sources);
+};
+} // namespace sky
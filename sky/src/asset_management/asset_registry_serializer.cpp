@@ -0,0 +1,218 @@
+#include "asset_registry_serializer.h"
+
+namespace sky
+{
+static void writeMetadata(std::ostream &out, const AssetMetadata &metadata)
+{
+    auto handle = static_cast<uint64_t>(metadata.handle);
+    out.write(reinterpret_cast<char *>(&handle), sizeof(uint64_t));
+
+    auto type = static_cast<uint16_t>(metadata.type);
+    out.write(reinterpret_cast<char *>(&type), sizeof(uint16_t));
+
+    std::string filepath = metadata.filepath.generic_string();
+    auto filepathLength = static_cast<uint32_t>(filepath.length());
+    out.write(reinterpret_cast<char *>(&filepathLength), sizeof(uint32_t));
+    out.write(filepath.c_str(), filepathLength);
+
+    auto dependencyCount = static_cast<uint32_t>(metadata.dependencies.size());
+    out.write(reinterpret_cast<char *>(&dependencyCount), sizeof(uint32_t));
+    for (const auto &dependency : metadata.dependencies)
+    {
+        auto dependencyHandle = static_cast<uint64_t>(dependency);
+        out.write(reinterpret_cast<char *>(&dependencyHandle), sizeof(uint64_t));
+    }
+}
+
+static bool readMetadata(std::istream &in, AssetMetadata &metadata)
+{
+    uint64_t handle;
+    in.read(reinterpret_cast<char *>(&handle), sizeof(uint64_t));
+
+    uint16_t type;
+    in.read(reinterpret_cast<char *>(&type), sizeof(uint16_t));
+
+    uint32_t filepathLength;
+    in.read(reinterpret_cast<char *>(&filepathLength), sizeof(uint32_t));
+    if (!in) return false;
+    std::string filepath(filepathLength, '\0');
+    in.read(filepath.data(), filepathLength);
+
+    uint32_t dependencyCount;
+    in.read(reinterpret_cast<char *>(&dependencyCount), sizeof(uint32_t));
+    if (!in) return false;
+
+    metadata.handle = handle;
+    metadata.type = static_cast<AssetType>(type);
+    metadata.filepath = filepath;
+    metadata.dependencies.clear();
+    for (uint32_t i = 0; i < dependencyCount && in; ++i)
+    {
+        uint64_t dependencyHandle;
+        in.read(reinterpret_cast<char *>(&dependencyHandle), sizeof(uint64_t));
+        metadata.dependencies.push_back(dependencyHandle);
+    }
+
+    return static_cast<bool>(in);
+}
+
+AssetRegistrySerializer::AssetRegistrySerializer(const fs::path &snapshotPath, const fs::path &journalPath)
+    : m_snapshotPath(snapshotPath), m_journalPath(journalPath)
+{
+}
+
+bool AssetRegistrySerializer::loadSnapshot(AssetRegistry &registry)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    std::ifstream snapshot(m_snapshotPath, std::ios::binary);
+    if (!snapshot.is_open())
+    {
+        SKY_CORE_ERROR("Failed to open asset registry: {0}", m_snapshotPath.string());
+        return false;
+    }
+
+    uint32_t magic;
+    snapshot.read(reinterpret_cast<char *>(&magic), sizeof(uint32_t));
+    uint16_t version;
+    snapshot.read(reinterpret_cast<char *>(&version), sizeof(uint16_t));
+    if (!snapshot || magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+    {
+        SKY_CORE_ERROR("Asset registry '{0}' has an unknown format", m_snapshotPath.string());
+        return false;
+    }
+
+    uint32_t count;
+    snapshot.read(reinterpret_cast<char *>(&count), sizeof(uint32_t));
+    registry.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        AssetMetadata metadata;
+        if (!readMetadata(snapshot, metadata))
+        {
+            SKY_CORE_ERROR("Asset registry '{0}' is truncated", m_snapshotPath.string());
+            return false;
+        }
+        registry[metadata.handle] = std::move(metadata);
+    }
+    return true;
+}
+
+void AssetRegistrySerializer::replayJournal(AssetRegistry &registry)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // a record cut short by a crash ends the journal
+    m_journalRecords = 0;
+    std::ifstream journal(m_journalPath, std::ios::binary);
+    while (journal.is_open())
+    {
+        uint8_t type;
+        uint32_t payloadSize;
+        journal.read(reinterpret_cast<char *>(&type), sizeof(uint8_t));
+        journal.read(reinterpret_cast<char *>(&payloadSize), sizeof(uint32_t));
+        if (!journal) break;
+
+        std::string payload(payloadSize, '\0');
+        journal.read(payload.data(), payloadSize);
+        if (!journal) break;
+
+        std::istringstream record(payload);
+        if (static_cast<RecordType>(type) == RecordType::Put)
+        {
+            AssetMetadata metadata;
+            if (!readMetadata(record, metadata)) break;
+            registry[metadata.handle] = std::move(metadata);
+        }
+        else if (static_cast<RecordType>(type) == RecordType::Remove)
+        {
+            uint64_t handle;
+            record.read(reinterpret_cast<char *>(&handle), sizeof(uint64_t));
+            registry.erase(handle);
+        }
+        m_journalRecords++;
+    }
+}
+
+void AssetRegistrySerializer::appendPut(const AssetMetadata &metadata)
+{
+    std::ostringstream payload;
+    writeMetadata(payload, metadata);
+    appendRecord(RecordType::Put, payload.str());
+}
+
+void AssetRegistrySerializer::appendRemove(AssetHandle handle)
+{
+    std::ostringstream payload;
+    auto value = static_cast<uint64_t>(handle);
+    payload.write(reinterpret_cast<char *>(&value), sizeof(uint64_t));
+    appendRecord(RecordType::Remove, payload.str());
+}
+
+void AssetRegistrySerializer::appendRecord(RecordType type, const std::string &payload)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (!m_journal.is_open())
+    {
+        m_journal.open(m_journalPath, std::ios::binary | std::ios::app);
+        if (!m_journal.is_open())
+        {
+            SKY_CORE_ERROR("Failed to open asset registry journal: {0}", m_journalPath.string());
+            return;
+        }
+    }
+
+    auto recordType = static_cast<uint8_t>(type);
+    auto payloadSize = static_cast<uint32_t>(payload.size());
+    m_journal.write(reinterpret_cast<char *>(&recordType), sizeof(uint8_t));
+    m_journal.write(reinterpret_cast<char *>(&payloadSize), sizeof(uint32_t));
+    m_journal.write(payload.data(), payloadSize);
+    m_journal.flush();
+
+    m_journalRecords++;
+}
+
+bool AssetRegistrySerializer::compact(const AssetRegistry &registry)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // written next to the old snapshot and swapped in, a crash leaves the previous one intact
+    auto tempPath = fs::path(m_snapshotPath).concat(".tmp");
+    {
+        std::ofstream file(tempPath, std::ios::binary);
+        if (!file.is_open())
+        {
+            SKY_CORE_ERROR("Failed to open asset registry: {0}", tempPath.string());
+            return false;
+        }
+
+        uint32_t magic = SNAPSHOT_MAGIC;
+        file.write(reinterpret_cast<char *>(&magic), sizeof(uint32_t));
+        uint16_t version = SNAPSHOT_VERSION;
+        file.write(reinterpret_cast<char *>(&version), sizeof(uint16_t));
+
+        auto count = static_cast<uint32_t>(registry.size());
+        file.write(reinterpret_cast<char *>(&count), sizeof(uint32_t));
+        for (const auto &[handle, metadata] : registry)
+        {
+            auto entry = metadata;
+            entry.handle = handle;
+            writeMetadata(file, entry);
+        }
+    }
+
+    std::error_code error;
+    fs::rename(tempPath, m_snapshotPath, error);
+    if (error)
+    {
+        SKY_CORE_ERROR("Failed to replace asset registry '{0}': {1}", m_snapshotPath.string(), error.message());
+        return false;
+    }
+
+    if (m_journal.is_open()) m_journal.close();
+    m_journal.open(m_journalPath, std::ios::binary | std::ios::trunc);
+    m_journalRecords = 0;
+    return true;
+}
+} // namespace sky
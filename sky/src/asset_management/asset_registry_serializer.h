@@ -0,0 +1,61 @@
+#pragma once
+
+#include <skypch.h>
+#include "core/filesystem.h"
+#include "asset.h"
+
+namespace sky
+{
+using AssetRegistry = std::unordered_map<AssetHandle, AssetMetadata>;
+
+// Binary asset registry: a snapshot of every entry plus an append-only journal of the changes
+// made since. Changes only append a small record, the snapshot is rewritten when the journal
+// is compacted.
+class AssetRegistrySerializer
+{
+  public:
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x52594B53; // "SKYR"
+    static constexpr uint16_t SNAPSHOT_VERSION = 0x0001U;
+    static constexpr size_t MIN_RECORDS_BEFORE_COMPACT = 1024;
+
+    AssetRegistrySerializer(const fs::path &snapshotPath, const fs::path &journalPath);
+
+    // Loads the snapshot, false when it is missing or unreadable
+    bool loadSnapshot(AssetRegistry &registry);
+    // Replays the journal on top of the registry, whether that came from the snapshot or the yaml export
+    void replayJournal(AssetRegistry &registry);
+
+    void appendPut(const AssetMetadata &metadata);
+    void appendRemove(AssetHandle handle);
+
+    // Writes a fresh snapshot and truncates the journal
+    bool compact(const AssetRegistry &registry);
+
+    // Once the journal holds more records than half the registry, replaying it costs more than
+    // rewriting the snapshot
+    bool shouldCompact(size_t registrySize) const
+    {
+        return m_journalRecords > std::max(MIN_RECORDS_BEFORE_COMPACT, registrySize / 2);
+    }
+
+    bool hasSnapshot() const { return fs::exists(m_snapshotPath); }
+    // a journal without a snapshot still holds every change made since the last yaml export
+    bool exists() const { return hasSnapshot() || fs::exists(m_journalPath); }
+
+  private:
+    enum class RecordType : uint8_t
+    {
+        Put = 1,
+        Remove = 2,
+    };
+
+    void appendRecord(RecordType type, const std::string &payload);
+
+  private:
+    fs::path m_snapshotPath;
+    fs::path m_journalPath;
+    std::ofstream m_journal;
+    size_t m_journalRecords = 0;
+    std::mutex m_mutex;
+};
+} // namespace sky
@@ -0,0 +1,141 @@
+#include "background_importer.h"
+
+#include "asset_importer.h"
+#include "editor_asset_manager.h"
+
+namespace sky
+{
+void BackgroundImporter::start(TaskManager &taskManager, const fs::path &assetDirectory)
+{
+    cancel();
+
+    auto state = CreateRef<State>();
+    state->start = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_state = state;
+    }
+
+    const size_t maxConcurrentImports = m_maxConcurrentImports > 0
+        ? m_maxConcurrentImports
+        : std::max<size_t>(1, taskManager.getWorkerCount() / 2);
+
+    taskManager.schedule([&taskManager, state, assetDirectory, maxConcurrentImports]
+        { scan(taskManager, state, assetDirectory, maxConcurrentImports); },
+        TaskPriority::Background, TaskType::AssetImport);
+}
+
+void BackgroundImporter::cancel()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_state) m_state->token.cancel();
+}
+
+ImportProgress BackgroundImporter::getProgress() const
+{
+    Ref<State> state;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        state = m_state;
+    }
+    if (!state) return {};
+
+    ImportProgress progress;
+    progress.scanning = state->scanning;
+    progress.running = state->running;
+    progress.total = progress.scanning ? 0 : state->sources.size();
+    progress.completed = state->completed;
+    progress.failed = state->failed;
+    progress.elapsedMs = progress.running
+        ? std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - state->start).count()
+        : state->elapsedMs.load();
+
+    if (progress.running && progress.completed > 0)
+    {
+        const double msPerAsset = progress.elapsedMs / progress.completed;
+        progress.etaMs = msPerAsset * (progress.total - progress.completed);
+    }
+    return progress;
+}
+
+void BackgroundImporter::scan(TaskManager &taskManager, const Ref<State> &state, const fs::path &assetDirectory,
+    size_t maxConcurrentImports)
+{
+    std::error_code error;
+    for (auto it = fs::recursive_directory_iterator(assetDirectory, error); !error && it != fs::end(it);
+         it.increment(error))
+    {
+        if (state->token.isCancelled()) break;
+        if (!it->is_regular_file()) continue;
+
+        const auto &path = it->path();
+        const auto type = getAssetTypeFromFileExtension(path.extension());
+        if (!AssetImporter::isCookable(type) || !AssetImporter::needsCook(type, path)) continue;
+
+        state->sources.push_back({type, path});
+    }
+    if (error) SKY_CORE_ERROR("Failed to scan '{}' for imports: {}", assetDirectory.string(), error.message());
+
+    state->scanning = false;
+    if (state->sources.empty() || state->token.isCancelled())
+    {
+        state->activeLanes = 1;
+        finishLane(state);
+        return;
+    }
+
+    SKY_CORE_INFO("Importing {} assets in the background", state->sources.size());
+
+    const size_t lanes = std::min(maxConcurrentImports, state->sources.size());
+    state->activeLanes = lanes;
+    for (size_t i = 0; i < lanes; ++i)
+    {
+        taskManager.schedule([&taskManager, state] { runLane(taskManager, state); }, TaskPriority::Background,
+            TaskType::AssetImport);
+    }
+}
+
+void BackgroundImporter::runLane(TaskManager &taskManager, const Ref<State> &state)
+{
+    const size_t index = state->next++;
+    if (state->token.isCancelled() || index >= state->sources.size())
+    {
+        finishLane(state);
+        return;
+    }
+
+    const auto &source = state->sources[index];
+    bool cooked = false;
+    try
+    {
+        cooked = AssetImporter::cookAsset(source.type, source.path);
+    }
+    catch (const std::exception &e)
+    {
+        SKY_CORE_ERROR("Import of {} failed: {}", source.path.string(), e.what());
+    }
+
+    if (!cooked) state->failed++;
+    state->completed++;
+
+    // back to the pool between imports, anything more urgent that arrived meanwhile runs first
+    taskManager.schedule([&taskManager, state] { runLane(taskManager, state); }, TaskPriority::Background,
+        TaskType::AssetImport);
+}
+
+void BackgroundImporter::finishLane(const Ref<State> &state)
+{
+    if (state->activeLanes.fetch_sub(1) != 1) return;
+
+    const double elapsedMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - state->start).count();
+    state->elapsedMs = elapsedMs;
+    state->running = false;
+
+    if (state->completed > 0)
+    {
+        SKY_CORE_INFO("Background import finished: {} assets in {:.2f} s, {} failed{}", state->completed.load(),
+            elapsedMs / 1000.0, state->failed.load(), state->token.isCancelled() ? " (cancelled)" : "");
+    }
+}
+} // namespace sky
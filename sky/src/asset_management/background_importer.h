@@ -0,0 +1,75 @@
+#pragma once
+
+#include <skypch.h>
+#include "asset.h"
+#include "core/tasks/task_manager.h"
+
+namespace sky
+{
+struct ImportProgress
+{
+    size_t total = 0;     // stale assets found by the scan
+    size_t completed = 0; // cooked, failed ones included
+    size_t failed = 0;
+    double elapsedMs = 0.0;
+    double etaMs = 0.0;
+    bool scanning = false;
+    bool running = false;
+
+    float getFraction() const { return total ? static_cast<float>(completed) / total : 1.0f; }
+};
+
+// Cooks every stale asset of a project on the task pool, so the first load of a scene does not
+// have to. Imports run at background priority and only a few at a time, each one goes back to
+// the pool before the next starts so interactive work is never stuck behind the pass.
+class BackgroundImporter
+{
+  public:
+    BackgroundImporter() = default;
+    ~BackgroundImporter() { cancel(); }
+
+    BackgroundImporter(const BackgroundImporter &) = delete;
+    BackgroundImporter &operator=(const BackgroundImporter &) = delete;
+
+    // Scans the directory and cooks whatever is stale, a pass that is still running is cancelled
+    void start(TaskManager &taskManager, const fs::path &assetDirectory);
+    void cancel();
+
+    ImportProgress getProgress() const;
+
+    // 0 uses half of the task workers
+    void setMaxConcurrentImports(size_t count) { m_maxConcurrentImports = count; }
+
+  private:
+    struct Source
+    {
+        AssetType type;
+        fs::path path;
+    };
+
+    // shared with the jobs, so the importer can go away while a pass is still winding down
+    struct State
+    {
+        CancellationToken token;
+        std::vector<Source> sources;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> completed{0};
+        std::atomic<size_t> failed{0};
+        std::atomic<size_t> activeLanes{0};
+        std::atomic<bool> scanning{true};
+        std::atomic<bool> running{true};
+        std::chrono::steady_clock::time_point start;
+        std::atomic<double> elapsedMs{0.0}; // set once the pass has finished
+    };
+
+    static void scan(TaskManager &taskManager, const Ref<State> &state, const fs::path &assetDirectory,
+        size_t maxConcurrentImports);
+    static void runLane(TaskManager &taskManager, const Ref<State> &state);
+    static void finishLane(const Ref<State> &state);
+
+  private:
+    Ref<State> m_state;
+    size_t m_maxConcurrentImports = 0;
+    mutable std::mutex m_mutex;
+};
+} // namespace sky
@@ -1,10 +1,14 @@
 #include "editor_asset_manager.h"
 
 #include <yaml-cpp/yaml.h>
+#include <tracy/Tracy.hpp>
 
 #include "assert.h"
 #include "asset_importer.h"
+#include "asset_pack.h"
+#include "core/resource/import_data.h"
 #include "core/project_management/project_manager.h"
+#include "core/application.h"
 
 namespace sky
 {
@@ -42,62 +46,103 @@ Ref<Asset> EditorAssetManager::getAsset(AssetHandle handle)
     // 1. check if handle is valid
     if (!isAssetHandleValid(handle)) return nullptr;
 
-    // 2. check if asset needs load (and if so, load)
-    Ref<Asset> asset;
-    if (isAssetLoaded(handle))
-    {
-        asset = m_loadedAssets.at(handle);
-    }
-    else
-    {
-        // Load dependencies first
-        auto metadata = getMetadata(handle);
-		if (metadata.dependencies.size() > 0) SKY_CORE_INFO("Loading asset dependecies");
-        for (const auto &dependencyHandle : metadata.dependencies) // Assuming metadata contains a list of dependencies
+    // 2. return it right away if it is already loaded
+    if (auto asset = m_loadedAssets.find(handle)) return asset;
+
+    // 3. load it, together with whatever it depends on
+    double loadTimeMs = 0.0;
+    return loadAsset(handle, loadTimeMs);
+}
+
+Ref<Asset> EditorAssetManager::loadAsset(AssetHandle handle, double &loadTimeMs)
+{
+    return m_loadedAssets.getOrLoad(handle, [&]() -> Ref<Asset>
         {
-            // Recursively load each dependency (if not loaded)
-            if (!isAssetLoaded(dependencyHandle))
+            const auto start = std::chrono::steady_clock::now();
+            auto metadata = getMetadataCopy(handle);
+
+            // Load dependencies first, independent ones side by side on the task pool
+            std::vector<AssetHandle> dependencies;
+            for (const auto &dependencyHandle : metadata.dependencies)
             {
-                Ref<Asset> dependencyAsset = getAsset(dependencyHandle);
-                if (!dependencyAsset)
+                if (!isAssetLoaded(dependencyHandle)) dependencies.push_back(dependencyHandle);
+            }
+
+            if (!dependencies.empty())
+            {
+                SKY_CORE_INFO("Loading {} asset dependencies", dependencies.size());
+
+                std::vector<Ref<Asset>> dependencyAssets(dependencies.size());
+                std::vector<double> dependencyLoadTimes(dependencies.size(), 0.0);
+                auto *parentLoad = AssetCache::getCurrentLoad();
+                Application::getTaskManager()->parallelFor(0, dependencies.size(),
+                    [&](size_t i)
+                    {
+                        // part of this load, a dependency that needs it back is a cycle and fails
+                        AssetCache::DependencyScope scope(parentLoad);
+                        dependencyAssets[i] = loadAsset(dependencies[i], dependencyLoadTimes[i]);
+                    },
+                    1);
+
+                for (size_t i = 0; i < dependencies.size(); ++i)
                 {
-                    SKY_CORE_ERROR("Failed to load dependency for asset {}!", static_cast<uint64_t>(handle));
-                    return nullptr; // Abort if dependency failed to load
+                    if (!dependencyAssets[i])
+                    {
+                        SKY_CORE_ERROR("Failed to load dependency for asset {}!", static_cast<uint64_t>(handle));
+                        return nullptr; // Abort if dependency failed to load
+                    }
+                    loadTimeMs += dependencyLoadTimes[i];
                 }
             }
-        }
 
-        // 3. Load the main asset
-        asset = AssetImporter::importAsset(handle, metadata);
-        if (!asset)
-        {
-            SKY_CORE_ERROR("EditorAssetManager::GetAsset - asset import failed!");
-            return nullptr;
-        }
+            // 4. Load the main asset
+            const auto importStart = std::chrono::steady_clock::now();
+            auto asset = AssetImporter::importAsset(handle, metadata);
+            const auto importEnd = std::chrono::steady_clock::now();
+            loadTimeMs += std::chrono::duration<double, std::milli>(importEnd - importStart).count();
 
-        // Store the loaded asset
-        asset->handle = handle;
-        m_loadedAssets[handle] = asset;
-        serializeAssetRegistry();
-    }
-    // 3. return asset
-    return asset;
+            if (!asset)
+            {
+                SKY_CORE_ERROR("EditorAssetManager::GetAsset - asset import failed!");
+                return nullptr;
+            }
+
+            if (!dependencies.empty())
+            {
+                SKY_CORE_INFO("Loaded {} with {} dependencies in {:.2f} ms, {:.2f} ms of summed load time",
+                    metadata.filepath.string(), dependencies.size(),
+                    std::chrono::duration<double, std::milli>(importEnd - start).count(), loadTimeMs);
+            }
+
+            asset->handle = handle;
+            return asset;
+        });
 }
 
 AssetHandle EditorAssetManager::getOrCreateAssetHandle(fs::path path, AssetType assetType)
 {
     if (assetType == AssetType::None) return NULL_UUID;
 
-    for (const auto& [key, value] : m_assetRegistry)
+    const auto key = path.generic_string();
     {
-        if (value.filepath == path) return key;
+        std::shared_lock<std::shared_mutex> lock(m_registryMutex);
+        auto it = m_pathIndex.find(key);
+        if (it != m_pathIndex.end()) return it->second;
     }
 
+    std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+    // another thread may have registered the path between the two locks
+    auto it = m_pathIndex.find(key);
+    if (it != m_pathIndex.end()) return it->second;
+
     const auto handle = UUID::generate();
     m_assetRegistry[handle] = AssetMetadata{
         .type = assetType,
+        .handle = handle,
         .filepath = path,
     };
+    m_pathIndex[key] = handle;
+    recordRegistryChange(handle);
     return handle;
 }
 
@@ -105,9 +150,18 @@ bool EditorAssetManager::removeAsset(AssetHandle handle)
 {
     if (isAssetHandleValid(handle))
     {
+        {
+            std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+            auto it = m_assetRegistry.find(handle);
+            if (it != m_assetRegistry.end())
+            {
+                auto indexed = m_pathIndex.find(it->second.filepath.generic_string());
+                if (indexed != m_pathIndex.end() && indexed->second == handle) m_pathIndex.erase(indexed);
+                m_assetRegistry.erase(it);
+            }
+            getRegistrySerializer().appendRemove(handle);
+        }
 		m_loadedAssets.erase(handle);
-		m_assetRegistry.erase(handle);
-		serializeAssetRegistry();
     }
     return true;
 }
@@ -116,18 +170,25 @@ bool EditorAssetManager::removeAsset(AssetHandle handle)
 void EditorAssetManager::unloadAllAssets() 
 {
     m_loadedAssets.clear();
+
+    std::unique_lock<std::shared_mutex> lock(m_registryMutex);
     m_assetRegistry.clear();
+    m_pathIndex.clear();
 }
 
 bool EditorAssetManager::isAssetHandleValid(AssetHandle handle) const 
 {
-    return handle != NULL_UUID || m_assetRegistry.find(handle) != m_assetRegistry.end();
+    if (handle != NULL_UUID) return true;
+
+    std::shared_lock<std::shared_mutex> lock(m_registryMutex);
+    return m_assetRegistry.find(handle) != m_assetRegistry.end();
 }
 
 AssetType EditorAssetManager::getAssetType(AssetHandle handle) const 
 {
     if (!isAssetHandleValid(handle)) return AssetType::None;
 
+    std::shared_lock<std::shared_mutex> lock(m_registryMutex);
     return m_assetRegistry.at(handle).type;
 }
 
@@ -145,24 +206,60 @@ void EditorAssetManager::importAsset(const fs::path &filepath)
     if (asset)
     {
         asset->handle = handle;
-        m_assetRegistry[handle] = metadata;
-        m_loadedAssets[handle] = asset;
-        serializeAssetRegistry();
+        {
+            std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+            m_assetRegistry[handle] = metadata;
+            m_pathIndex[filepath.generic_string()] = handle;
+            recordRegistryChange(handle);
+        }
+        m_loadedAssets.insert(handle, asset);
     }
 }
 
+void EditorAssetManager::addDependency(AssetHandle handle, AssetHandle dependency)
+{
+    std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+
+    auto it = m_assetRegistry.find(handle);
+    if (it == m_assetRegistry.end()) return;
+
+    auto &deps = it->second.dependencies;
+    if (std::find(deps.begin(), deps.end(), dependency) != deps.end()) return;
+
+    deps.push_back(dependency);
+    recordRegistryChange(handle);
+}
+
+AssetHandle EditorAssetManager::findAssetHandle(const fs::path &path) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_registryMutex);
+    auto it = m_pathIndex.find(path.generic_string());
+    return it != m_pathIndex.end() ? it->second : NULL_UUID;
+}
+
 AssetMetadata &EditorAssetManager::getMetadata(AssetHandle handle) 
 {
     static AssetMetadata s_NullMetadata;
+
+    std::shared_lock<std::shared_mutex> lock(m_registryMutex);
     auto it = m_assetRegistry.find(handle);
     if (it == m_assetRegistry.end()) return s_NullMetadata;
 
     return it->second;
 }
 
+AssetMetadata EditorAssetManager::getMetadataCopy(AssetHandle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_registryMutex);
+    auto it = m_assetRegistry.find(handle);
+    if (it == m_assetRegistry.end()) return {};
+
+    return it->second;
+}
+
 bool EditorAssetManager::isAssetLoaded(AssetHandle handle) 
 {
-    return m_loadedAssets.find(handle) != m_loadedAssets.end();
+    return m_loadedAssets.contains(handle);
 }
 
 const fs::path &EditorAssetManager::getFilePath(AssetHandle handle) 
@@ -170,10 +267,157 @@ const fs::path &EditorAssetManager::getFilePath(AssetHandle handle)
     return getMetadata(handle).filepath;
 }
 
+void EditorAssetManager::startBackgroundImport()
+{
+    m_backgroundImporter.start(*Application::getTaskManager(), ProjectManager::getConfig().getAssetDirectory());
+}
+
+void EditorAssetManager::startHotReload()
+{
+    m_hotReloader.start(ProjectManager::getConfig().getAssetDirectory());
+}
+
+void EditorAssetManager::updateHotReload()
+{
+    m_hotReloader.update(*this, *Application::getTaskManager());
+}
+
+static bool isPackable(AssetType type)
+{
+    switch (type)
+    {
+        case AssetType::Mesh:
+        case AssetType::Texture2D:
+        case AssetType::TextureCube:
+        case AssetType::Material:
+        case AssetType::Scene: return true;
+        default: return false;
+    }
+}
+
+bool EditorAssetManager::cookAssetPack(const fs::path &output)
+{
+    ZoneScopedN("Cook asset pack");
+    const auto assetDirectory = ProjectManager::getConfig().getAssetDirectory();
+
+    // textures referenced by meshes are registered on first load, the pack needs them up front
+    std::error_code error;
+    for (auto it = fs::recursive_directory_iterator(assetDirectory, error); !error && it != fs::end(it);
+         it.increment(error))
+    {
+        if (!it->is_regular_file()) continue;
+        const auto type = getAssetTypeFromFileExtension(it->path().extension());
+        if (isPackable(type)) getOrCreateAssetHandle(fs::relative(it->path(), assetDirectory), type);
+    }
+
+    std::vector<AssetMetadata> assets;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_registryMutex);
+        for (const auto &[handle, metadata] : m_assetRegistry)
+        {
+            if (isPackable(metadata.type)) assets.push_back(metadata);
+        }
+    }
+
+    std::vector<AssetPackWriter::Source> sources(assets.size());
+    std::vector<char> packed(assets.size(), 0);
+    Application::getTaskManager()->parallelFor(0, assets.size(),
+        [&](size_t i)
+        {
+            const auto &metadata = assets[i];
+            const auto path = assetDirectory / metadata.filepath;
+            auto file = path;
+            if (AssetImporter::isCookable(metadata.type))
+            {
+                if (!AssetImporter::cookAsset(metadata.type, path)) return;
+
+                ImportData data;
+                ImportDataSerializer dataSerializer(data);
+                if (!dataSerializer.deserialize(path.string() + ".import")) return;
+                file = data.destination;
+            }
+            if (!fs::exists(file)) return;
+
+            sources[i] = {metadata.handle, metadata.type, metadata.filepath, file};
+            packed[i] = 1;
+        },
+        1);
+
+    std::vector<AssetPackWriter::Source> packable;
+    packable.reserve(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        if (packed[i]) packable.push_back(std::move(sources[i]));
+        else SKY_CORE_WARN("{} could not be cooked and is left out of the asset pack", assets[i].filepath.string());
+    }
+    return AssetPackWriter::write(output, std::move(packable));
+}
+
+void EditorAssetManager::enforceMemoryBudgets()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastEviction < EVICTION_INTERVAL) return;
+    m_lastEviction = now;
+
+    ZoneScopedN("Asset eviction");
+    const auto evicted = m_loadedAssets.evict();
+    if (evicted > 0)
+    {
+        SKY_CORE_INFO("Evicted {} assets to stay within memory budgets", evicted);
+        logResidencyStats();
+    }
+
+    TracyPlot("Asset memory (textures)",
+        static_cast<int64_t>(m_loadedAssets.getResidencyStats(AssetType::Texture2D).residentBytes));
+    TracyPlot("Asset memory (texture cubes)",
+        static_cast<int64_t>(m_loadedAssets.getResidencyStats(AssetType::TextureCube).residentBytes));
+}
+
+void EditorAssetManager::logResidencyStats() const
+{
+    for (size_t i = 1; i < ASSET_TYPE_COUNT; ++i)
+    {
+        const auto type = static_cast<AssetType>(i);
+        const auto stats = m_loadedAssets.getResidencyStats(type);
+        if (stats.residentCount == 0 && stats.evictions == 0) continue;
+
+        const auto budget = stats.budgetBytes == AssetCache::UNLIMITED_BUDGET
+            ? std::string("unlimited")
+            : std::format("{:.1f} MiB", stats.budgetBytes / (1024.0 * 1024.0));
+        SKY_CORE_INFO("{}: {} resident, {:.1f} MiB of {}, {} hits, {} loads, {} evictions", assetTypeToString(type),
+            stats.residentCount, stats.residentBytes / (1024.0 * 1024.0), budget, stats.hits, stats.misses,
+            stats.evictions);
+    }
+}
+
+AssetRegistrySerializer &EditorAssetManager::getRegistrySerializer()
+{
+    if (!m_registrySerializer)
+    {
+        const auto config = ProjectManager::getConfig();
+        m_registrySerializer = CreateScope<AssetRegistrySerializer>(config.getAssetRegistryCachePath(),
+            config.getAssetRegistryJournalPath());
+    }
+    return *m_registrySerializer;
+}
+
+void EditorAssetManager::recordRegistryChange(AssetHandle handle)
+{
+    auto &serializer = getRegistrySerializer();
+    serializer.appendPut(m_assetRegistry.at(handle));
+    if (serializer.shouldCompact(m_assetRegistry.size())) serializer.compact(m_assetRegistry);
+}
+
 void EditorAssetManager::serializeAssetRegistry() 
 {
-    auto path = ProjectManager::getConfig().getAssetRegistryPath();
+    // compacting rewrites the snapshot and truncates the journal, nothing else may write to them meanwhile
+    std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+    getRegistrySerializer().compact(m_assetRegistry);
+    exportAssetRegistryYaml(ProjectManager::getConfig().getAssetRegistryPath());
+}
 
+void EditorAssetManager::exportAssetRegistryYaml(const fs::path &path)
+{
     YAML::Emitter out;
     {
         out << YAML::BeginMap; // Root
@@ -206,13 +450,40 @@ void EditorAssetManager::serializeAssetRegistry()
 
 bool EditorAssetManager::deserializeAssetRegistry() 
 {
-    auto path = ProjectManager::getConfig().getAssetRegistryPath();
+    const auto config = ProjectManager::getConfig();
+
+    std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+    auto &serializer = getRegistrySerializer();
+    const bool fromSnapshot = serializer.hasSnapshot() && serializer.loadSnapshot(m_assetRegistry);
+    if (!fromSnapshot)
+    {
+        // older project (or a lost cache), start from the yaml export
+        m_assetRegistry.clear();
+        const auto yamlPath = config.getAssetRegistryPath();
+        if (fs::exists(yamlPath) && !importAssetRegistryYaml(yamlPath)) return false;
+    }
+
+    // the changes made since either of them are only in the journal
+    serializer.replayJournal(m_assetRegistry);
+    // compacting truncates the journal, the binary registry is only written once it has been replayed
+    if (!fromSnapshot) serializer.compact(m_assetRegistry);
+
+    m_pathIndex.clear();
+    m_pathIndex.reserve(m_assetRegistry.size());
+    for (const auto &[handle, metadata] : m_assetRegistry) m_pathIndex[metadata.filepath.generic_string()] = handle;
+
+    SKY_CORE_INFO("Asset registry loaded, {0} assets", m_assetRegistry.size());
+    return true;
+}
+
+bool EditorAssetManager::importAssetRegistryYaml(const fs::path &path) 
+{
     YAML::Node data;
     try
     {
         data = YAML::LoadFile(path.string());
     }
-    catch (YAML::ParserException e)
+    catch (YAML::Exception e)
     {
         SKY_CORE_ERROR("Failed to load project file '{0}'\n     {1}", path.string(), e.what());
         return false;
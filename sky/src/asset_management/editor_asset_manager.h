@@ -4,19 +4,26 @@
 
 #include "asset.h"
 #include "asset_manager_base.h"
+#include "asset_registry_serializer.h"
+#include "asset_cache.h"
+#include "background_importer.h"
+#include "asset_hot_reloader.h"
 
 namespace sky
 {
-using AssetRegistry = std::unordered_map<AssetHandle, AssetMetadata>;
-
 AssetType getAssetTypeFromFileExtension(const fs::path &extension);
 
+// Safe to use from several threads. References returned by getMetadata stay valid until the
+// asset is removed, but the metadata itself is only safe to change from the main thread.
 class EditorAssetManager : public AssetManagerBase
 {
   public:
+    static constexpr std::chrono::milliseconds EVICTION_INTERVAL{1000};
 
     Ref<Asset> getAsset(AssetHandle handle) override;
     AssetHandle getOrCreateAssetHandle(fs::path path, AssetType assetType) override;
+    // NULL_UUID if the path is not registered
+    AssetHandle findAssetHandle(const fs::path &path) const;
     AssetMetadata &getMetadata(AssetHandle handle) override;
 
     bool isAssetHandleValid(AssetHandle handle) const override;
@@ -25,19 +32,62 @@ class EditorAssetManager : public AssetManagerBase
     void unloadAllAssets() override;
     AssetType getAssetType(AssetHandle handle) const override;
 
+    // The binary registry in the project cache is the one that is loaded, the yaml file in the asset
+    // directory is an export kept for diffs. Projects with only the yaml file are migrated.
     bool deserializeAssetRegistry() override;
     void serializeAssetRegistry() override;
+    void exportAssetRegistryYaml(const fs::path &path);
 
     void importAsset(const fs::path &filepath);
+    void addDependency(AssetHandle handle, AssetHandle dependency) override;
+
+    // Evicts least recently used, unreferenced assets of every type that is over its budget.
+    // Called every frame, the actual pass runs at most every EVICTION_INTERVAL.
+    void enforceMemoryBudgets();
+    void setMemoryBudget(AssetType type, size_t bytes) { m_loadedAssets.setBudget(type, bytes); }
+    AssetResidencyStats getResidencyStats(AssetType type) const { return m_loadedAssets.getResidencyStats(type); }
+    void logResidencyStats() const;
+
+    // Cooks every stale asset of the project on the task pool, started when a project is opened
+    void startBackgroundImport();
+    ImportProgress getImportProgress() const { return m_backgroundImporter.getProgress(); }
+
+    // Re-imports sources edited on disk and swaps them into the loaded assets, started when a
+    // project is opened. updateHotReload is called every frame.
+    void startHotReload();
+    void updateHotReload();
+
+    // Cooks every asset of the project and writes them into one pack for RuntimeAssetManager.
+    // Sources not registered yet are registered first. Slow, run it off the main thread.
+    bool cookAssetPack(const fs::path &output);
 
     const fs::path &getFilePath(AssetHandle handle);
+    // not synchronised, main thread only
     const AssetRegistry &getAssetRegistry() const { return m_assetRegistry; }
 
   private:
+    // loadTimeMs accumulates the time spent importing the asset and the dependencies it loaded
+    Ref<Asset> loadAsset(AssetHandle handle, double &loadTimeMs);
+
+    AssetMetadata getMetadataCopy(AssetHandle handle) const;
+
+    // the functions below expect m_registryMutex to be held, the serializer ones exclusively
+    bool importAssetRegistryYaml(const fs::path &path);
+    AssetRegistrySerializer &getRegistrySerializer();
+    // journals the current metadata of handle, compacting the journal when it got long
+    void recordRegistryChange(AssetHandle handle);
 
   private:
     AssetRegistry m_assetRegistry;
-    AssetMap m_loadedAssets;
+    std::unordered_map<std::string, AssetHandle> m_pathIndex; // generic path string -> handle
+    Scope<AssetRegistrySerializer> m_registrySerializer;
+    mutable std::shared_mutex m_registryMutex; // guards the three above
+
+    AssetCache m_loadedAssets;
+    std::chrono::steady_clock::time_point m_lastEviction{};
+
+    BackgroundImporter m_backgroundImporter;
+    AssetHotReloader m_hotReloader;
 
     // TODO: memory-only assets
 };
@@ -0,0 +1,111 @@
+#include "import_cache.h"
+
+#include "core/helpers/hash.h"
+#include "core/log/log.h"
+#include "core/project_management/project_manager.h"
+#include "core/resource/import_data.h"
+
+#include <tracy/Tracy.hpp>
+
+namespace sky
+{
+static fs::path getImportDataPath(const fs::path &source) { return source.string() + ".import"; }
+
+static uint64_t hashSettings(const ImportCache::Importer &importer)
+{
+    return helper::hashBytes(importer.settings.data(), importer.settings.size());
+}
+
+static int64_t getWriteTime(const fs::path &path, std::error_code &error)
+{
+    return fs::last_write_time(path, error).time_since_epoch().count();
+}
+
+bool ImportCache::isUpToDate(const fs::path &source, const Importer &importer)
+{
+    const auto importDataFile = getImportDataPath(source);
+    if (!fs::exists(importDataFile)) return false;
+
+    ImportData data;
+    ImportDataSerializer dataSerializer(data);
+    if (!dataSerializer.deserialize(importDataFile)) return false;
+
+    if (data.version != std::to_string(importer.version) || data.settingsHash != hashSettings(importer)) return false;
+    if (!fs::exists(data.destination)) return false;
+
+    std::error_code error;
+    const auto size = fs::file_size(source, error);
+    if (error || size != data.sourceSize) return false;
+    const auto time = getWriteTime(source, error);
+    return !error && time == data.sourceTime;
+}
+
+bool ImportCache::cook(const fs::path &source, const Importer &importer, const CookFn &cookFn)
+{
+    ZoneScopedN("ImportCache::cook");
+
+    const auto importDataFile = getImportDataPath(source);
+
+    ImportData data;
+    ImportDataSerializer dataSerializer(data);
+    if (!fs::exists(importDataFile) || !dataSerializer.deserialize(importDataFile))
+    {
+        data = {};
+        data.id = UUID::generate();
+    }
+
+    std::error_code error;
+    const auto sourceSize = fs::file_size(source, error);
+    const auto sourceTime = error ? 0 : getWriteTime(source, error);
+    const auto sourceHash = error ? std::nullopt : helper::hashFile(source);
+    if (!sourceHash)
+    {
+        SKY_CORE_ERROR("Failed to read {} for import", source.string());
+        return false;
+    }
+
+    const auto key = computeKey(*sourceHash, importer);
+    const auto destination =
+        ProjectManager::getConfig().getImportedCachePath() / std::format("{:016x}{}", key, importer.extension);
+
+    if (!fs::exists(destination))
+    {
+        // identical sources may be cooked at the same time, nobody must see a half written file
+        const auto tmp = fs::path(destination.string() + ".tmp-" + UUID::generate().toString());
+        if (!cookFn(source, tmp))
+        {
+            fs::remove(tmp, error);
+            return false;
+        }
+
+        fs::rename(tmp, destination, error);
+        if (error)
+        {
+            SKY_CORE_ERROR("Failed to move cooked {} into the import cache: {}", source.string(), error.message());
+            fs::remove(tmp, error);
+            return false;
+        }
+    }
+    else if (data.destination != destination)
+    {
+        SKY_CORE_TRACE("Import of {} reuses {}", source.string(), destination.filename().string());
+    }
+
+    data.type = importer.type;
+    data.source = source;
+    data.destination = destination;
+    data.version = std::to_string(importer.version);
+    data.settingsHash = hashSettings(importer);
+    data.sourceHash = *sourceHash;
+    data.sourceSize = sourceSize;
+    data.sourceTime = sourceTime;
+    return dataSerializer.serialize(importDataFile);
+}
+
+uint64_t ImportCache::computeKey(uint64_t sourceHash, const Importer &importer)
+{
+    auto key = helper::hashCombine(sourceHash, static_cast<uint64_t>(importer.type));
+    key = helper::hashCombine(key, importer.version);
+    return helper::hashCombine(key, hashSettings(importer));
+}
+} // namespace sky
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <skypch.h>
+#include "asset.h"
+#include "core/filesystem.h"
+
+namespace sky
+{
+// Cooked files in the imported cache are named after a hash of the source content, the importer
+// version and its settings. A source is only cooked again when one of those changes, and sources
+// with identical content share one cooked file.
+class ImportCache
+{
+  public:
+    using CookFn = std::function<bool(const fs::path &source, const fs::path &destination)>;
+
+    struct Importer
+    {
+        AssetType type;
+        uint32_t version;      // bump when the cooked output changes
+        std::string settings;  // anything else the cooked output depends on
+        std::string extension; // of the cooked file
+    };
+
+    // Only stats the source, a source that was touched but did not change is rehashed by cook
+    static bool isUpToDate(const fs::path &source, const Importer &importer);
+    // Writes the .import file next to the source, cookFn only runs if no matching cooked file exists
+    static bool cook(const fs::path &source, const Importer &importer, const CookFn &cookFn);
+
+    static uint64_t computeKey(uint64_t sourceHash, const Importer &importer);
+};
+} // namespace sky
@@ -3,8 +3,10 @@
 #include "renderer/model_loader.h"
 #include "core/project_management/project_manager.h"
 #include "core/application.h"
+#include "core/helpers/mapped_file.h"
 #include "core/resource/import_data.h"
 #include "core/resource/mesh_serializer.h"
+#include "import_cache.h"
 
 namespace sky
 {
@@ -24,41 +26,37 @@ static bool loadAssimpModel(const fs::path &src, const fs::path &dst)
 	}
 }
 
-static bool createImportFile(const fs::path &path) 
-{
-	ImportData data;
-	data.id = UUID::generate();
-	data.type = AssetType::Mesh;
-	data.source = path;
+// bump when the cooked output changes, every mesh is cooked again
+static constexpr uint32_t IMPORTER_VERSION = 1;
 
-	auto uuid = UUID::generate();
-	std::string dstFileName = std::format("{0}-{1}.mesh", path.filename().string(), uuid.toString());
-	data.destination = ProjectManager::getConfig().getImportedCachePath() / dstFileName;
+static ImportCache::Importer getImporter(const fs::path &path)
+{
+    // the cooked mesh points at its textures relative to the source and embedded textures are
+    // extracted next to it, so unlike textures it depends on where the source lives
+    const auto relativePath = fs::relative(path, ProjectManager::getConfig().getAssetDirectory());
+    return {AssetType::Mesh, IMPORTER_VERSION, "assimp " + relativePath.generic_string(), ".mesh"};
+}
 
-	ImportDataSerializer dataSerializer(data);
-	dataSerializer.serialize(path.string() + ".import");
+bool MeshImporter::needsCook(const fs::path &path)
+{
+    return !ImportCache::isUpToDate(path, getImporter(path));
+}
 
-	return loadAssimpModel(data.source, data.destination);
+bool MeshImporter::cookAsset(const fs::path &path)
+{
+    return ImportCache::cook(path, getImporter(path), loadAssimpModel);
 }
 
 Ref<Model> MeshImporter::importAsset(AssetHandle handle, AssetMetadata &metadata) 
 {
     const auto path = ProjectManager::getConfig().getAssetDirectory() / metadata.filepath;
 
-    auto importDataFile = metadata.filepath.string() + ".import";
-    if (!fs::exists(ProjectManager::getConfig().getAssetDirectory() / importDataFile))
-    {
-        createImportFile(path);
-    }
+    // usually a no-op, the background import pass has cooked it already
+    AssetImporter::cookAsset(metadata.type, path);
 
 	ImportData data;
 	ImportDataSerializer dataSerializer(data);
-	dataSerializer.deserialize(ProjectManager::getConfig().getAssetDirectory() / importDataFile);
-
-	if (!fs::exists(data.destination))
-    {
-		loadAssimpModel(data.source, data.destination);	
-    }
+	dataSerializer.deserialize(path.string() + ".import");
 
 	return loadModel(handle, data.destination);
 }
@@ -69,7 +67,15 @@ Ref<Model> MeshImporter::loadModel(AssetHandle handle, const fs::path &path)
     std::vector<MeshID> meshes;
 	auto renderer = Application::getRenderer();
 
-	for (auto &mesh : serializer.deserialize(path, handle))
+	// parsed in place, the vertices go from the mapping straight into the staging buffer
+	helper::MappedFile file;
+	if (!file.open(path))
+	{
+		SKY_CORE_ERROR("Failed to open mesh file: {0}", path.string());
+		return CreateRef<Model>(meshes);
+	}
+
+	for (auto &mesh : serializer.deserialize({file.data(), file.size()}, handle))
 	{
 		// add mesh to cache
 		auto meshID = renderer->addMeshToCache(mesh);
@@ -11,6 +11,10 @@ class MeshImporter
   public:
     static Ref<Model> importAsset(AssetHandle handle, AssetMetadata &metadata);
 
+    // Cooking writes the .import file next to the source and the binary file in the imported cache
+    static bool needsCook(const fs::path &path);
+    static bool cookAsset(const fs::path &path);
+
     static Ref<Model> loadModel(AssetHandle handle, const fs::path &path);
 };
 }
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "runtime_asset_manager.h"
+
+#include <tracy/Tracy.hpp>
+
+#include "core/application.h"
+#include "core/resource/material_serializer.h"
+#include "core/resource/mesh_serializer.h"
+#include "core/resource/texture_cube_serializer.h"
+#include "core/resource/texture_serializer.h"
+#include "core/project_management/project_manager.h"
+#include "renderer/image_based_lighting.h"
+#include "scene/scene_serializer.h"
+
+namespace sky
+{
+static std::string_view asText(std::span<const uint8_t> blob)
+{
+    return {reinterpret_cast<const char *>(blob.data()), blob.size()};
+}
+
+bool RuntimeAssetManager::open(const fs::path &packPath)
+{
+    ZoneScopedN("Open asset pack");
+    unloadAllAssets();
+
+    auto pack = CreateRef<AssetPack>();
+    if (!pack->open(packPath)) return false;
+
+    m_pathIndex.clear();
+    m_pathIndex.reserve(pack->getEntries().size());
+    for (const auto &entry : pack->getEntries()) m_pathIndex[pack->getPath(entry)] = entry.handle;
+
+    m_pack = pack;
+    SKY_CORE_INFO("Asset pack {} opened, {} assets", packPath.string(), m_pack->getEntries().size());
+    return true;
+}
+
+bool RuntimeAssetManager::deserializeAssetRegistry()
+{
+    return open(ProjectManager::getConfig().getAssetPackPath());
+}
+
+Ref<Asset> RuntimeAssetManager::getAsset(AssetHandle handle)
+{
+    if (!m_pack) return nullptr;
+    if (auto asset = m_loadedAssets.find(handle)) return asset;
+
+    const auto entry = m_pack->find(handle);
+    if (!entry)
+    {
+        SKY_CORE_ERROR("Asset {} is not in the asset pack", static_cast<uint64_t>(handle));
+        return nullptr;
+    }
+
+    return m_loadedAssets.getOrLoad(handle, [&]() { return loadAsset(handle, *entry); });
+}
+
+Ref<Asset> RuntimeAssetManager::loadAsset(AssetHandle handle, const AssetPack::Entry &entry)
+{
+    ZoneScopedN("Load packed asset");
+    const auto blob = m_pack->getBlob(entry);
+
+    Ref<Asset> asset;
+    switch (static_cast<AssetType>(entry.type))
+    {
+        case AssetType::Texture2D:
+        {
+            TextureSerializer serializer;
+            asset = serializer.deserialize(blob, m_pack);
+            break;
+        }
+        case AssetType::TextureCube:
+        {
+            TextureCubeSerializer serializer;
+            auto texture = serializer.deserialize(blob, m_pack);
+            if (texture) ImageBasedLighting::prepareEnvironment(*texture);
+            asset = texture;
+            break;
+        }
+        case AssetType::Mesh:
+        {
+            MeshSerializer serializer;
+            std::vector<MeshID> meshes;
+            auto renderer = Application::getRenderer();
+            for (auto &mesh : serializer.deserialize(blob, handle)) meshes.push_back(renderer->addMeshToCache(mesh));
+            asset = CreateRef<Model>(meshes);
+            break;
+        }
+        case AssetType::Material:
+        {
+            MaterialSerializer serializer;
+            auto material = serializer.deserializeFromMemory(asText(blob));
+            material.name = std::string(m_pack->getPath(entry));
+            asset = CreateRef<MaterialAsset>(Application::getRenderer()->addMaterialToCache(material));
+            break;
+        }
+        case AssetType::Scene:
+        {
+            auto scene = CreateRef<Scene>();
+            SceneSerializer serializer(scene);
+            if (serializer.deserializeFromMemory(asText(blob))) asset = scene;
+            break;
+        }
+        default: break;
+    }
+
+    if (!asset)
+    {
+        SKY_CORE_ERROR("Failed to load {} from the asset pack", m_pack->getPath(entry));
+        return nullptr;
+    }
+
+    asset->handle = handle;
+    return asset;
+}
+
+AssetHandle RuntimeAssetManager::getOrCreateAssetHandle(fs::path path, AssetType assetType)
+{
+    if (assetType == AssetType::None) return NULL_UUID;
+
+    auto it = m_pathIndex.find(path.generic_string());
+    if (it != m_pathIndex.end()) return it->second;
+
+    SKY_CORE_WARN("{} is not in the asset pack, cook the pack again", path.string());
+    return NULL_UUID;
+}
+
+AssetMetadata &RuntimeAssetManager::getMetadata(AssetHandle handle)
+{
+    static AssetMetadata s_NullMetadata;
+
+    const auto entry = m_pack ? m_pack->find(handle) : nullptr;
+    if (!entry) return s_NullMetadata;
+
+    std::unique_lock<std::mutex> lock(m_metadataMutex);
+    auto [it, inserted] = m_metadata.try_emplace(handle);
+    if (inserted)
+    {
+        it->second.type = static_cast<AssetType>(entry->type);
+        it->second.handle = handle;
+        it->second.filepath = m_pack->getPath(*entry);
+    }
+    it->second.isLoaded = m_loadedAssets.contains(handle);
+    return it->second;
+}
+
+bool RuntimeAssetManager::isAssetHandleValid(AssetHandle handle) const
+{
+    return handle != NULL_UUID && m_pack && m_pack->find(handle);
+}
+
+bool RuntimeAssetManager::isAssetLoaded(AssetHandle handle)
+{
+    return m_loadedAssets.contains(handle);
+}
+
+bool RuntimeAssetManager::removeAsset(AssetHandle handle)
+{
+    // the pack is read-only, only the loaded copy goes away
+    return m_loadedAssets.erase(handle);
+}
+
+void RuntimeAssetManager::unloadAllAssets()
+{
+    m_loadedAssets.clear();
+
+    std::unique_lock<std::mutex> lock(m_metadataMutex);
+    m_metadata.clear();
+}
+
+AssetType RuntimeAssetManager::getAssetType(AssetHandle handle) const
+{
+    const auto entry = m_pack ? m_pack->find(handle) : nullptr;
+    return entry ? static_cast<AssetType>(entry->type) : AssetType::None;
+}
+} // namespace sky
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <skypch.h>
+
+#include "asset.h"
+#include "asset_manager_base.h"
+#include "asset_cache.h"
+#include "asset_pack.h"
+
+namespace sky
+{
+// Loads a shipped project straight from its memory-mapped asset pack. Nothing is parsed at startup,
+// the table of contents is read in place and textures point into the mapping. Read-only, handles
+// that are not in the pack are never created.
+class RuntimeAssetManager : public AssetManagerBase
+{
+  public:
+    bool open(const fs::path &packPath);
+
+    Ref<Asset> getAsset(AssetHandle handle) override;
+    AssetHandle getOrCreateAssetHandle(fs::path path, AssetType assetType) override;
+    AssetMetadata &getMetadata(AssetHandle handle) override;
+    bool deserializeAssetRegistry() override;
+    void serializeAssetRegistry() override {}
+
+    bool isAssetHandleValid(AssetHandle handle) const override;
+    bool isAssetLoaded(AssetHandle handle) override;
+    bool removeAsset(AssetHandle handle) override;
+    void unloadAllAssets() override;
+    AssetType getAssetType(AssetHandle handle) const override;
+
+  private:
+    Ref<Asset> loadAsset(AssetHandle handle, const AssetPack::Entry &entry);
+
+  private:
+    Ref<AssetPack> m_pack;
+    std::unordered_map<std::string_view, AssetHandle> m_pathIndex; // views into the pack
+
+    // built on first use, the pack itself only has what loading needs
+    std::unordered_map<AssetHandle, AssetMetadata> m_metadata;
+    std::mutex m_metadataMutex;
+
+    AssetCache m_loadedAssets;
+};
+} // namespace sky
@@ -1,19 +1,69 @@
 #include "texture_cube_importer.h"
+#include "core/application.h"
+#include "core/helpers/block_compression.h"
+#include "core/helpers/pixel_conversion.h"
 #include "core/resource/import_data.h"
 #include "core/resource/texture_cube_serializer.h"
+#include "import_cache.h"
+#include "renderer/image_based_lighting.h"
 #include "renderer/texture.h"
 #include "core/project_management/project_manager.h"
 #include "skypch.h"
 
 #include <stb_image.h>
+#include <tracy/Tracy.hpp>
 
 namespace sky 
 {
+static TextureFormat getStorageFormat(helper::HdrStorage storage)
+{
+    switch (storage)
+    {
+    case helper::HdrStorage::Half: return TextureFormat::RGBA16Float;
+    case helper::HdrStorage::BC6H: return TextureFormat::BC6HUfloat;
+    default: return TextureFormat::RGB9E5Float;
+    }
+}
+
+// float RGBA is four times the size of what the GPU needs to sample an environment
+static void convertPixels(TextureCube &texture, TextureFormat format)
+{
+    ZoneScopedN("Convert HDR pixels");
+    const auto *floats = reinterpret_cast<const float *>(texture.pixels);
+    const size_t count = size_t(texture.width) * texture.height;
+    auto *pixels = new unsigned char[getTextureLevelSize(format, texture.width, texture.height)];
+
+    if (format == TextureFormat::RGBA16Float)
+        helper::convertToHalf(floats, count * 4, reinterpret_cast<uint16_t *>(pixels));
+    else if (format == TextureFormat::RGB9E5Float)
+        helper::convertToRGB9E5(floats, count, reinterpret_cast<uint32_t *>(pixels));
+    else
+    {
+        std::vector<uint16_t> halves(count * 4);
+        helper::convertToHalf(floats, halves.size(), halves.data());
+
+        const auto quality = ProjectManager::getConfig().textureCompression;
+        helper::BlockCompressionReport report;
+        const auto blocks = helper::compressBC6H(halves, texture.width, texture.height, quality,
+            Application::getTaskManager(), &report);
+        std::memcpy(pixels, blocks.data(), blocks.size());
+        SKY_CORE_INFO("Cube texture: BC6H {}, {:.2f} dB PSNR, {} KB -> {} KB in {:.1f} ms", helper::toString(quality),
+            report.psnr, count * 16 / 1024, blocks.size() / 1024, report.milliseconds);
+    }
+
+    texture.releasePixels();
+    texture.shouldSTBFree = false;
+    texture.pixels = pixels;
+    texture.format = format;
+}
+
 static bool loadTextureFromSrc(const fs::path &src, const fs::path &dst)
 {
     // load texture from file
 	auto texture = TextureCubeImporter::loadTexture(src);
-   
+	if (!texture) return false;
+    convertPixels(*texture, getStorageFormat(ProjectManager::getConfig().hdrStorage));
+
 	TextureCubeSerializer serializer;
 	if (serializer.serialize(dst, texture)) return true;
     else
@@ -23,45 +73,46 @@ static bool loadTextureFromSrc(const fs::path &src, const fs::path &dst)
 	}
 }
 
-static bool createImportFile(const fs::path &path)
-{
-    ImportData data;
-	data.id = UUID::generate();
-	data.type = AssetType::Mesh;
-	data.source = path;
+// bump when the cooked output changes, every cube texture is cooked again
+static constexpr uint32_t IMPORTER_VERSION = 2;
 
-	auto uuid = UUID::generate();
-	std::string dstFileName = std::format("{0}-{1}.texture3d", path.filename().string(), uuid.toString());
-	data.destination = ProjectManager::getConfig().getImportedCachePath() / dstFileName;
+static ImportCache::Importer getImporter()
+{
+    const auto &config = ProjectManager::getConfig();
+    auto settings = std::string(helper::toString(config.hdrStorage));
+    if (config.hdrStorage == helper::HdrStorage::BC6H)
+        settings += std::string(" ") + helper::toString(config.textureCompression);
+    return {AssetType::TextureCube, IMPORTER_VERSION, settings, ".texture3d"};
+}
 
-	ImportDataSerializer dataSerializer(data);
-	dataSerializer.serialize(path.string() + ".import");
+bool TextureCubeImporter::needsCook(const fs::path &path)
+{
+    return !ImportCache::isUpToDate(path, getImporter());
+}
 
-	return loadTextureFromSrc(data.source, data.destination);
+bool TextureCubeImporter::cookAsset(const fs::path &path)
+{
+    return ImportCache::cook(path, getImporter(), loadTextureFromSrc);
 }
 
 Ref<TextureCube> TextureCubeImporter::importAsset(AssetHandle handle, AssetMetadata &metadata)
 {
     const auto path = ProjectManager::getConfig().getAssetDirectory() / metadata.filepath;
 
-    auto importDataFile = metadata.filepath.string() + ".import";
-    if (!fs::exists(ProjectManager::getConfig().getAssetDirectory() / importDataFile))
-    {
-        createImportFile(path);
-    }
+    // usually a no-op, the background import pass has cooked it already
+    AssetImporter::cookAsset(metadata.type, path);
 
 	ImportData data;
 	ImportDataSerializer dataSerializer(data);
-	dataSerializer.deserialize(ProjectManager::getConfig().getAssetDirectory() / importDataFile);
-
-	if (!fs::exists(data.destination))
-    {
-		loadTextureFromSrc(data.source, data.destination);    
-	}
+	dataSerializer.deserialize(path.string() + ".import");
 
 	TextureCubeSerializer serializer;
 	auto asset = serializer.deserialize(data.destination);
-	if (asset != nullptr) SKY_CORE_INFO("Texture: {} successfully loaded", path.string());
+	if (asset != nullptr)
+	{
+		ImageBasedLighting::prepareEnvironment(*asset);
+		SKY_CORE_INFO("Texture: {} successfully loaded", path.string());
+	}
 	
 	return asset;
 }
@@ -69,12 +120,14 @@ Ref<TextureCube> TextureCubeImporter::importAsset(AssetHandle handle, AssetMetad
 Ref<TextureCube> TextureCubeImporter::loadTexture(const fs::path &path)
 {
     auto data = CreateRef<TextureCube>();
+    data->shouldSTBFree = true;
+    data->format = TextureFormat::RGBA32Float;
 
-    data->pixels = stbi_loadf(path.string().c_str(), 
+    data->pixels = reinterpret_cast<unsigned char *>(stbi_loadf(path.string().c_str(), 
         &data->width, 
         &data->height, 
         &data->channels, 
-        STBI_rgb_alpha);
+        STBI_rgb_alpha));
     if (!data->pixels)
     {
         SKY_CORE_ERROR("Failed to load image {}: {}", path.string(), stbi_failure_reason());
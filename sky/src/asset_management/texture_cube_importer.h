@@ -11,6 +11,11 @@ class TextureCubeImporter
 {
   public:
     static Ref<TextureCube> importAsset(AssetHandle handle, AssetMetadata &metadata);
+
+    // Cooking writes the .import file next to the source and the binary file in the imported cache
+    static bool needsCook(const fs::path &path);
+    static bool cookAsset(const fs::path &path);
+    // float RGBA as decoded, cooking converts it to the project's HDR storage
     static Ref<TextureCube> loadTexture(const fs::path &texturePath);
 };
 }
\ No newline at end of file
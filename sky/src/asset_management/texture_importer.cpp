@@ -1,19 +1,163 @@
 #include "texture_importer.h"
 
+#include "core/application.h"
 #include "core/log/log.h"
+#include "core/helpers/block_compression.h"
+#include "core/helpers/mipmap.h"
+#include "core/helpers/pixel_conversion.h"
 #include "core/project_management/project_manager.h"
 #include "core/resource/import_data.h"
 #include "core/resource/texture_serializer.h"
+#include "import_cache.h"
 
 #include <stb_image.h>
+#include <tracy/Tracy.hpp>
 
 namespace sky
 {
+// What a texture holds decides how it is filtered and compressed, taken from the suffix of its name
+enum class TextureUsage
+{
+    Color,   // sRGB color, albedo and emissive
+    Normal,  // tangent space normals, only x and y are kept
+    Channel, // one channel of data (roughness, AO...), packed ones fall back to Data
+    Data,    // several channels of linear data
+};
+
+// "Rock_Wall-NormalMap_2K" -> rock, wall, normal, map, 2, k. Splits on anything that isn't a letter or a
+// digit and where a lowercase letter or digit is followed by an uppercase one.
+static std::vector<std::string> splitNameTokens(const std::string &name)
+{
+    std::vector<std::string> tokens;
+    std::string token;
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        const auto c = static_cast<unsigned char>(name[i]);
+        if (!std::isalnum(c) || (std::isupper(c) && i > 0 && !std::isupper(static_cast<unsigned char>(name[i - 1]))))
+        {
+            if (!token.empty()) tokens.push_back(std::move(token));
+            token.clear();
+        }
+        if (std::isalnum(c)) token += static_cast<char>(std::tolower(c));
+    }
+    if (!token.empty()) tokens.push_back(std::move(token));
+    return tokens;
+}
+
+static TextureUsage getTextureUsage(const fs::path &path)
+{
+    auto tokens = splitNameTokens(path.stem().string());
+
+    // "_map", "_tex" and resolutions like "_2k" come after the part that names the usage
+    static const std::unordered_set<std::string_view> s_trailingTokens = {"map", "tex", "texture", "k"};
+    while (!tokens.empty() && (s_trailingTokens.contains(tokens.back()) || std::isdigit(tokens.back()[0])))
+        tokens.pop_back();
+    if (tokens.empty()) return TextureUsage::Color;
+
+    // only whole tokens at the end count, "platform" is not an ORM map and "normalized_albedo" is color
+    const auto &last = tokens.back();
+    static const std::unordered_set<std::string_view> s_normalTokens = {"normal", "normals", "nrm", "nor", "n"};
+    if (s_normalTokens.contains(last)) return TextureUsage::Normal;
+
+    // glTF's metallicRoughness packs both into one texture
+    if (last == "roughness" && tokens.size() > 1 && tokens[tokens.size() - 2] == "metallic") return TextureUsage::Data;
+    static const std::unordered_set<std::string_view> s_dataTokens = {"orm", "arm", "rma", "mra", "mask"};
+    if (s_dataTokens.contains(last)) return TextureUsage::Data;
+
+    static const std::unordered_set<std::string_view> s_channelTokens = {"roughness", "rough", "metallic",
+        "metalness", "metal", "occlusion", "ao", "height", "displacement", "disp", "bump", "gloss", "glossiness"};
+    if (s_channelTokens.contains(last)) return TextureUsage::Channel;
+    return TextureUsage::Color;
+}
+
+static const char *toString(TextureUsage usage)
+{
+    switch (usage)
+    {
+    case TextureUsage::Color: return "color";
+    case TextureUsage::Normal: return "normal";
+    case TextureUsage::Channel: return "channel";
+    case TextureUsage::Data: return "data";
+    }
+    return "color";
+}
+
+static bool isOpaque(const Texture2D &texture)
+{
+    const size_t count = size_t(texture.width) * texture.height;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (texture.pixels[i * 4 + 3] != 255) return false;
+    }
+    return true;
+}
+
+static bool isGrayscale(const Texture2D &texture)
+{
+    const size_t count = size_t(texture.width) * texture.height;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto *px = texture.pixels + i * 4;
+        if (px[0] != px[1] || px[0] != px[2]) return false;
+    }
+    return true;
+}
+
+// BC7 (BC1/BC3 when fast) for color and packed data, BC5 for normals and BC4 for single channel maps
+static TextureFormat chooseFormat(const Texture2D &texture, TextureUsage usage, helper::BlockCompressionQuality quality)
+{
+    const bool srgb = usage == TextureUsage::Color;
+    if (quality == helper::BlockCompressionQuality::None)
+        return srgb ? TextureFormat::RGBA8Srgb : TextureFormat::RGBA8Unorm;
+
+    if (usage == TextureUsage::Normal) return TextureFormat::BC5Unorm;
+    if (usage == TextureUsage::Channel && isGrayscale(texture)) return TextureFormat::BC4Unorm;
+
+    if (quality == helper::BlockCompressionQuality::Fast)
+    {
+        if (isOpaque(texture)) return srgb ? TextureFormat::BC1Srgb : TextureFormat::BC1Unorm;
+        return srgb ? TextureFormat::BC3Srgb : TextureFormat::BC3Unorm;
+    }
+    return srgb ? TextureFormat::BC7Srgb : TextureFormat::BC7Unorm;
+}
+
 static bool loadTextureFromSrc(const fs::path &src, const fs::path &dst) 
 {
 	// load texture from file
 	auto texture = TextureImporter::loadTexture(src);
-   
+	if (!texture) return false;
+
+    // the whole chain is cooked, uploads copy it level by level
+    {
+        ZoneScopedN("Generate mips");
+        const auto usage = getTextureUsage(src);
+        const auto quality = ProjectManager::getConfig().textureCompression;
+        const auto format = chooseFormat(*texture, usage, quality);
+
+        // data maps are filtered as they are, uncompressed ones sampled the other way get their mips
+        // blitted on the GPU instead
+        const bool srgb = usage == TextureUsage::Color;
+        std::vector<gfx::ImageMipLevel> mips;
+        auto chain = helper::generateMipChain(texture->pixels, texture->width, texture->height, srgb, mips);
+
+        if (isBlockCompressed(format))
+        {
+            const uint64_t uncompressedSize = chain.size();
+            helper::BlockCompressionReport report;
+            chain = helper::compressMipChain(chain, mips, format, quality, Application::getTaskManager(), &report);
+            SKY_CORE_INFO("Texture {}: {} {}, {:.2f} dB PSNR, {} KB -> {} KB in {:.1f} ms", src.filename().string(),
+                toString(format), helper::toString(quality), report.psnr, uncompressedSize / 1024, chain.size() / 1024,
+                report.milliseconds);
+        }
+
+        texture->releasePixels();
+        texture->shouldSTBFree = false;
+        texture->pixels = new unsigned char[chain.size()];
+        std::memcpy(texture->pixels, chain.data(), chain.size());
+        texture->mips = std::move(mips);
+        texture->format = format;
+    }
+
 	TextureSerializer serializer;
 	if (serializer.serialize(dst, texture))
     {  
@@ -27,41 +171,36 @@ static bool loadTextureFromSrc(const fs::path &src, const fs::path &dst)
 	}
 }
 
-static bool createImportFile(const fs::path &path) 
-{
-	ImportData data;
-	data.id = UUID::generate();
-	data.type = AssetType::Mesh;
-	data.source = path;
+// bump when the cooked output changes, every texture is cooked again
+static constexpr uint32_t IMPORTER_VERSION = 3;
 
-	auto uuid = UUID::generate();
-	std::string dstFileName = std::format("{0}-{1}.texture", path.filename().string(), uuid.toString());
-	data.destination = ProjectManager::getConfig().getImportedCachePath() / dstFileName;
+static ImportCache::Importer getImporter(const fs::path &path)
+{
+    const auto settings = std::string("flip_y mips ") + toString(getTextureUsage(path)) + " " +
+        helper::toString(ProjectManager::getConfig().textureCompression);
+    return {AssetType::Texture2D, IMPORTER_VERSION, settings, ".texture"};
+}
 
-	ImportDataSerializer dataSerializer(data);
-	dataSerializer.serialize(path.string() + ".import");
+bool TextureImporter::needsCook(const fs::path &path)
+{
+    return !ImportCache::isUpToDate(path, getImporter(path));
+}
 
-	return loadTextureFromSrc(data.source, data.destination);
+bool TextureImporter::cookAsset(const fs::path &path)
+{
+    return ImportCache::cook(path, getImporter(path), loadTextureFromSrc);
 }
 
 Ref<Texture2D> TextureImporter::importAsset(AssetHandle handle, AssetMetadata &metadata)
 {
     const auto path = ProjectManager::getConfig().getAssetDirectory() / metadata.filepath;
 
-    auto importDataFile = metadata.filepath.string() + ".import";
-    if (!fs::exists(ProjectManager::getConfig().getAssetDirectory() / importDataFile))
-    {
-        createImportFile(path);
-    }
+    // usually a no-op, the background import pass has cooked it already
+    AssetImporter::cookAsset(metadata.type, path);
 
 	ImportData data;
 	ImportDataSerializer dataSerializer(data);
-	dataSerializer.deserialize(ProjectManager::getConfig().getAssetDirectory() / importDataFile);
-
-	if (!fs::exists(data.destination))
-    {
-		loadTextureFromSrc(data.source, data.destination);    
-	}
+	dataSerializer.deserialize(path.string() + ".import");
 
 	TextureSerializer serializer;
 	auto asset = serializer.deserialize(data.destination);
@@ -70,30 +209,51 @@ Ref<Texture2D> TextureImporter::importAsset(AssetHandle handle, AssetMetadata &m
 	return asset;
 }
 
-Ref<Texture2D> TextureImporter::loadTexture(const fs::path &path) 
+// stb decodes at the file's own channel count, the expansion to RGBA8 is done here with SIMD instead of
+// by stb's per pixel conversion
+static Ref<Texture2D> toRGBA8Texture(stbi_uc *decoded, int width, int height, int channels)
 {
     auto data = CreateRef<Texture2D>();
-    data->shouldSTBFree = true;
+    data->width = width;
+    data->height = height;
+    data->channels = 4;
+    if (channels == 4)
+    {
+        data->pixels = decoded;
+        data->shouldSTBFree = true;
+        return data;
+    }
 
+    const auto count = size_t(width) * height;
+    data->pixels = new unsigned char[count * 4];
+    helper::convertToRGBA8(decoded, channels, count, data->pixels);
+    stbi_image_free(decoded);
+    return data;
+}
+
+Ref<Texture2D> TextureImporter::loadTexture(const fs::path &path) 
+{
+    ZoneScopedN("Decode texture");
+    int width, height, channels;
     stbi_set_flip_vertically_on_load(1);
-    data->pixels = stbi_load(path.string().c_str(), &data->width, &data->height, &data->channels, 4);
-    if (!data->pixels)
+    auto *decoded = stbi_load(path.string().c_str(), &width, &height, &channels, 0);
+    if (!decoded)
     {
         SKY_CORE_ERROR("Failed to load image {}: {}", path.string(), stbi_failure_reason());
         return nullptr;
     }
-
-    data->channels = 4;
-    return data;
+    return toRGBA8Texture(decoded, width, height, channels);
 }
 
 Ref<Texture2D> TextureImporter::loadTexture(const void *buffer, uint64_t length) 
 {
-	auto data = CreateRef<Texture2D>();
-
-    data->pixels = stbi_load_from_memory((const stbi_uc *)buffer, length, &data->width, &data->height, &data->channels, 4);
-    
-	data->channels = 4;
-    return data;
+    int width, height, channels;
+    auto *decoded = stbi_load_from_memory((const stbi_uc *)buffer, length, &width, &height, &channels, 0);
+    if (!decoded)
+    {
+        SKY_CORE_ERROR("Failed to load image from memory: {}", stbi_failure_reason());
+        return nullptr;
+    }
+    return toRGBA8Texture(decoded, width, height, channels);
 }
-} // namespace sky
\ No newline at end of file
+} // namespace sky
@@ -11,6 +11,10 @@ class TextureImporter
 {
   public:
     static Ref<Texture2D> importAsset(AssetHandle handle, AssetMetadata &metadata);
+
+    // Cooking writes the .import file next to the source and the binary file in the imported cache
+    static bool needsCook(const fs::path &path);
+    static bool cookAsset(const fs::path &path);
     static Ref<Texture2D> loadTexture(const fs::path &texturePath);
     static Ref<Texture2D> loadTexture(const void *buffer, uint64_t length);
 };
@@ -14,6 +14,7 @@
 #include "scene/scene_manager.h"
 #include "core/events/event_bus.h"
 #include "core/resource/custom_thumbnail.h"
+#include "core/project_management/project_manager.h"
 
 namespace sky {
 Ref<Window>         Application::m_window       = nullptr;
@@ -54,6 +55,18 @@ void Application::run()
         glfwPollEvents();
         if (m_window->isWindowMinimized()) continue;
 
+        {
+            ZoneScopedN("Task completions");
+            m_taskManager->drainMainThreadQueue();
+            m_taskManager->sampleTelemetry();
+        }
+
+        if (auto assetManager = ProjectManager::getEditorAssetManager(); assetManager && ProjectManager::isProjectOpen())
+        {
+            assetManager->updateHotReload();
+            assetManager->enforceMemoryBudgets();
+        }
+
         // imgui new frame
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -74,7 +87,7 @@ void Application::run()
         // Render each target with its own command buffer
         {
             // Render scene targets
-            m_renderer->update(SceneManager::get().getEditorScene());
+            m_renderer->update(SceneManager::get().getEditorScene(), RenderMode::Scene);
             {
                 auto cmd = m_gfxDevice->beginOffscreenFrame();
                 m_renderer->render(cmd, SceneManager::get().getEditorScene(), RenderMode::Scene);
@@ -83,13 +96,15 @@ void Application::run()
             m_renderer->clearDrawCommands();
 
             // Render game targets  
-            m_renderer->update(SceneManager::get().getGameScene());
+            m_renderer->update(SceneManager::get().getGameScene(), RenderMode::Game);
             {
                 auto cmd = m_gfxDevice->beginOffscreenFrame();
                 m_renderer->render(cmd, SceneManager::get().getGameScene(), RenderMode::Game);
                 m_gfxDevice->endOffscreenFrame(cmd);
             }
             m_renderer->clearDrawCommands();
+
+            m_renderer->updateStreaming();
         }
 
         {
@@ -118,6 +133,9 @@ void Application::run()
         EditorEventBus::get().processEvents();
         m_fps.frameRendered();
     }
+
+    if (m_taskManager->getTelemetry().writeJson(TASK_TELEMETRY_PATH))
+        SKY_CORE_INFO("Task telemetry written to {0}", TASK_TELEMETRY_PATH);
     m_window->destroy();
 }
 
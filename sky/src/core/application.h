@@ -11,6 +11,12 @@ int main(int argc, char** argv);
 
 namespace sky 
 {
+// Options given on the command line, parsed before the application is created
+struct CommandLine
+{
+    fs::path packedProject; // --packed <project file>, plays the project from its cooked asset pack
+};
+
 class Application
 {
   public:
@@ -23,6 +29,7 @@ class Application
     static constexpr int WIDTH = 1;
     static constexpr int HEIGHT = 1;
     static constexpr const char* TITLE = "Sky Engine";
+    static constexpr const char* TASK_TELEMETRY_PATH = "task_telemetry.json";
 
     void onEvent(Event &e);
 
@@ -33,6 +40,7 @@ class Application
     static Ref<SceneRenderer> getRenderer() { return m_renderer; }
     static Ref<TaskManager> getTaskManager() { return m_taskManager; }
     static std::vector<fs::path> &getDroppedFiles() { return m_droppedFiles; }
+    static const CommandLine &getCommandLine() { return m_commandLine; }
     static void quit();
     static double getFPS() { return m_fps.getFPS(); }
 
@@ -45,6 +53,7 @@ class Application
   private:
     inline static bool m_isRunning = true;
     inline static std::vector<fs::path> m_droppedFiles;
+    inline static CommandLine m_commandLine;
     inline static FPSCounter m_fps;
 
     LayerStack m_layerStack{};
@@ -0,0 +1,18 @@
+#include "benchmark.h"
+
+#include "core/log/log.h"
+
+namespace sky::benchmark
+{
+int run(std::string_view name)
+{
+    Log::Init();
+
+    if (name == "tasks") return runTasks();
+    if (name == "physics") return runPhysics();
+    if (name == "textures") return runTextures();
+
+    SKY_CORE_ERROR("Unknown benchmark '{}', expected one of: tasks, physics, textures", name);
+    return 1;
+}
+} // namespace sky::benchmark
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <skypch.h>
+
+namespace sky::benchmark
+{
+// Headless benchmarks, started with `--benchmark <name>` instead of opening the application.
+// Every benchmark logs its results and returns the process exit code.
+int run(std::string_view name);
+
+// Scheduling overhead of a single job, task and parallelFor index, and parallelFor scaling from 1 to N workers
+int runTasks();
+// Physics step times of a falling pile of boxes, on Jolt's own thread pool and on the TaskManager while
+// its workers are busy with background jobs
+int runPhysics();
+// Decode time of the textures of a 100 material model, one after another and as tasks joined once
+int runTextures();
+} // namespace sky::benchmark
@@ -0,0 +1,198 @@
+#include "benchmark.h"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/RegisterTypes.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+
+#include "core/log/log.h"
+#include "core/tasks/task_manager.h"
+#include "physics/physics_job_system.h"
+
+namespace sky::benchmark
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int PILE_SIZE = 10; // boxes along each side of the falling pile
+constexpr int STEPS = 300;
+constexpr float STEP_DURATION = 1.f / 60.f;
+constexpr auto BACKGROUND_JOB_DURATION = std::chrono::microseconds(500);
+
+// the minimal static/moving layer setup, as in PhysicsWorld
+namespace Layers
+{
+constexpr JPH::ObjectLayer NON_MOVING = 0;
+constexpr JPH::ObjectLayer MOVING = 1;
+} // namespace Layers
+
+class BroadPhaseLayers final : public JPH::BroadPhaseLayerInterface
+{
+  public:
+    JPH::uint GetNumBroadPhaseLayers() const override { return 2; }
+    JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override
+    {
+        return JPH::BroadPhaseLayer(JPH::BroadPhaseLayer::Type(inLayer));
+    }
+#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+    const char *GetBroadPhaseLayerName(JPH::BroadPhaseLayer inLayer) const override
+    {
+        return JPH::BroadPhaseLayer::Type(inLayer) == Layers::NON_MOVING ? "NON_MOVING" : "MOVING";
+    }
+#endif
+};
+
+class ObjectVsBroadPhaseLayerFilter final : public JPH::ObjectVsBroadPhaseLayerFilter
+{
+  public:
+    bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override
+    {
+        return inLayer1 == Layers::MOVING || JPH::BroadPhaseLayer::Type(inLayer2) == Layers::MOVING;
+    }
+};
+
+class ObjectLayerPairFilter final : public JPH::ObjectLayerPairFilter
+{
+  public:
+    bool ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const override
+    {
+        return inObject1 == Layers::MOVING || inObject2 == Layers::MOVING;
+    }
+};
+
+struct StepTimes
+{
+    double mean = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+// a pile of boxes dropped onto the ground, timed for every step
+StepTimes simulate(JPH::JobSystem &jobSystem)
+{
+    const BroadPhaseLayers broadPhaseLayers;
+    const ObjectVsBroadPhaseLayerFilter objectVsBroadPhaseFilter;
+    const ObjectLayerPairFilter objectPairFilter;
+
+    JPH::PhysicsSystem physicsSystem;
+    physicsSystem.Init(2048, 0, 65536, 10240, broadPhaseLayers, objectVsBroadPhaseFilter, objectPairFilter);
+    JPH::TempAllocatorImpl tempAllocator(32 << 20);
+
+    auto &bodyInterface = physicsSystem.GetBodyInterface();
+    std::vector<JPH::BodyID> bodies;
+    bodies.push_back(bodyInterface.CreateAndAddBody(
+        JPH::BodyCreationSettings(new JPH::BoxShape(JPH::Vec3(100.f, 1.f, 100.f)), JPH::RVec3(0.f, -1.f, 0.f),
+            JPH::Quat::sIdentity(), JPH::EMotionType::Static, Layers::NON_MOVING),
+        JPH::EActivation::DontActivate));
+
+    const JPH::RefConst<JPH::Shape> box = new JPH::BoxShape(JPH::Vec3(0.5f, 0.5f, 0.5f));
+    for (int x = 0; x < PILE_SIZE; ++x)
+        for (int y = 0; y < PILE_SIZE; ++y)
+            for (int z = 0; z < PILE_SIZE; ++z)
+            {
+                // offset every layer a little so the pile topples instead of settling as a block
+                const JPH::RVec3 position(x * 1.1f + y * 0.2f, 2.f + y * 1.2f, z * 1.1f + y * 0.2f);
+                bodies.push_back(bodyInterface.CreateAndAddBody(
+                    JPH::BodyCreationSettings(box, position, JPH::Quat::sIdentity(), JPH::EMotionType::Dynamic,
+                        Layers::MOVING),
+                    JPH::EActivation::Activate));
+            }
+    physicsSystem.OptimizeBroadPhase();
+
+    std::vector<double> times;
+    times.reserve(STEPS);
+    for (int i = 0; i < STEPS; ++i)
+    {
+        const auto start = Clock::now();
+        physicsSystem.Update(STEP_DURATION, 1, &tempAllocator, &jobSystem);
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+
+    bodyInterface.RemoveBodies(bodies.data(), int(bodies.size()));
+    bodyInterface.DestroyBodies(bodies.data(), int(bodies.size()));
+
+    StepTimes result;
+    for (const double time : times) result.mean += time / times.size();
+    std::sort(times.begin(), times.end());
+    result.p99 = times[times.size() * 99 / 100];
+    result.max = times.back();
+    return result;
+}
+
+// keeps every worker busy with background jobs, as while a project streams in its assets
+class BackgroundLoad
+{
+  public:
+    explicit BackgroundLoad(TaskManager &taskManager) : m_taskManager(taskManager)
+    {
+        for (size_t i = 0; i < taskManager.getWorkerCount() * 2; ++i) queue();
+    }
+
+    ~BackgroundLoad()
+    {
+        m_stop = true;
+        while (m_running.load() > 0) std::this_thread::yield();
+    }
+
+  private:
+    void queue()
+    {
+        m_running.fetch_add(1);
+        m_taskManager.schedule(
+            [this]
+            {
+                const auto until = Clock::now() + BACKGROUND_JOB_DURATION;
+                while (Clock::now() < until) {}
+                if (!m_stop) queue();
+                m_running.fetch_sub(1);
+            },
+            TaskPriority::Background);
+    }
+
+    TaskManager &m_taskManager;
+    std::atomic<bool> m_stop{false};
+    std::atomic<int> m_running{0};
+};
+
+void report(const char *name, const StepTimes &times)
+{
+    SKY_CORE_INFO("{:<38} mean {:6.2f} ms  p99 {:6.2f} ms  max {:6.2f} ms", name, times.mean, times.p99, times.max);
+}
+} // namespace
+
+int runPhysics()
+{
+    JPH::RegisterDefaultAllocator();
+    JPH::Factory::sInstance = new JPH::Factory();
+    JPH::RegisterTypes();
+
+    const size_t workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    SKY_CORE_INFO("{} boxes, {} steps, {} workers", PILE_SIZE * PILE_SIZE * PILE_SIZE, STEPS, workers);
+    {
+        // Jolt's own pool next to the engine's, as before PhysicsJobSystem, and the engine's pool running both
+        JPH::JobSystemThreadPool threadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, int(workers));
+        TaskManager taskManager(workers);
+        physics::PhysicsJobSystem jobSystem(taskManager, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+
+        report("JobSystemThreadPool, idle pool", simulate(threadPool));
+        report("PhysicsJobSystem, idle pool", simulate(jobSystem));
+        {
+            // while assets stream in, Jolt's own threads compete with the busy workers for the cores
+            BackgroundLoad load(taskManager);
+            report("JobSystemThreadPool, background load", simulate(threadPool));
+            report("PhysicsJobSystem, background load", simulate(jobSystem));
+        }
+    }
+
+    JPH::UnregisterTypes();
+    delete JPH::Factory::sInstance;
+    JPH::Factory::sInstance = nullptr;
+    return 0;
+}
+} // namespace sky::benchmark
@@ -0,0 +1,114 @@
+#include "benchmark.h"
+
+#include "core/log/log.h"
+#include "core/tasks/task_manager.h"
+
+namespace sky::benchmark
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t OVERHEAD_JOBS = 200000;
+constexpr size_t SCALING_ITERATIONS = 4096;
+constexpr int REPEATS = 5;
+
+double nanosecondsSince(Clock::time_point start, size_t count)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / double(count);
+}
+
+// a few microseconds of arithmetic the optimizer can't fold away
+float work(size_t i)
+{
+    float x = float(i);
+    for (int k = 0; k < 2000; ++k) x = x * 0.999f + std::sqrt(x + float(k));
+    return x;
+}
+
+// the best of a few runs, the first one also warms up the workers
+template <typename Fn> double best(Fn fn)
+{
+    double result = std::numeric_limits<double>::max();
+    for (int i = 0; i < REPEATS; ++i) result = std::min(result, fn());
+    return result;
+}
+
+void measureOverhead(size_t workers)
+{
+    TaskManager taskManager(workers);
+
+    // an empty job pushed from outside the pool, until it has run on a worker
+    const double job = best(
+        [&]
+        {
+            std::atomic<size_t> done{0};
+            const auto start = Clock::now();
+            for (size_t i = 0; i < OVERHEAD_JOBS; ++i) taskManager.schedule([&done] { done.fetch_add(1); });
+            while (done.load() < OVERHEAD_JOBS) std::this_thread::yield();
+            return nanosecondsSince(start, OVERHEAD_JOBS);
+        });
+
+    // a task that does nothing, with its registry entry, result and wait
+    const double task = best(
+        [&]
+        {
+            std::vector<Ref<Task<int>>> tasks;
+            tasks.reserve(OVERHEAD_JOBS / 10);
+            const auto start = Clock::now();
+            for (size_t i = 0; i < OVERHEAD_JOBS / 10; ++i)
+            {
+                tasks.push_back(Task<int>::create({TaskType::Generic, i}, [] { return 0; }));
+                taskManager.submitTask(tasks.back());
+            }
+            for (const auto &t : tasks) t->wait();
+            return nanosecondsSince(start, tasks.size());
+        });
+
+    // one index per chunk, the worst case for parallelFor
+    const double index = best(
+        [&]
+        {
+            std::atomic<size_t> done{0};
+            const auto start = Clock::now();
+            taskManager.parallelFor(0, OVERHEAD_JOBS, [&done](size_t) { done.fetch_add(1); }, 1);
+            return nanosecondsSince(start, OVERHEAD_JOBS);
+        });
+
+    SKY_CORE_INFO("{:>2} workers: {:8.1f} ns/job  {:8.1f} ns/task  {:8.1f} ns/parallelFor index", workers, job, task,
+        index);
+}
+
+void measureScaling(size_t maxWorkers)
+{
+    std::vector<float> results(SCALING_ITERATIONS);
+    double single = 0.0;
+    for (size_t workers = 1; workers <= maxWorkers; ++workers)
+    {
+        TaskManager taskManager(workers);
+        const double ms = best(
+            [&]
+            {
+                const auto start = Clock::now();
+                taskManager.parallelFor(0, SCALING_ITERATIONS, [&](size_t i) { results[i] = work(i); });
+                return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            });
+        if (workers == 1) single = ms;
+
+        SKY_CORE_INFO("{:>2} workers: {:8.2f} ms  speedup {:5.2f}x", workers, ms, single / ms);
+    }
+}
+} // namespace
+
+int runTasks()
+{
+    const size_t maxWorkers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    SKY_CORE_INFO("Task scheduling overhead, {} hardware threads", maxWorkers);
+    measureOverhead(1);
+    if (maxWorkers > 1) measureOverhead(maxWorkers);
+
+    SKY_CORE_INFO("parallelFor scaling over {} iterations", SCALING_ITERATIONS);
+    measureScaling(maxWorkers);
+    return 0;
+}
+} // namespace sky::benchmark
@@ -0,0 +1,98 @@
+#include "benchmark.h"
+
+#include <stb_image_write.h>
+
+#include "asset_management/texture_importer.h"
+#include "core/log/log.h"
+#include "core/tasks/task_manager.h"
+
+namespace sky::benchmark
+{
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int MATERIAL_COUNT = 100;
+constexpr int TEXTURE_SIZE = 512;
+constexpr int REPEATS = 3;
+// what a glTF material usually comes with
+constexpr std::array<const char *, 4> TEXTURE_SLOTS = {"albedo", "normal", "orm", "emissive"};
+
+// noise over a gradient, so the PNGs don't compress down to nothing
+std::vector<fs::path> writeTextures(const fs::path &directory)
+{
+    fs::create_directories(directory);
+
+    std::mt19937 random(42);
+    std::vector<uint8_t> pixels(size_t(TEXTURE_SIZE) * TEXTURE_SIZE * 3);
+    std::vector<fs::path> paths;
+    for (int material = 0; material < MATERIAL_COUNT; ++material)
+    {
+        for (const auto *slot : TEXTURE_SLOTS)
+        {
+            for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = uint8_t(i / 3 % TEXTURE_SIZE / 4 + random() % 64);
+
+            auto path = directory / ("material" + std::to_string(material) + "_" + slot + ".png");
+            stbi_write_png(path.string().c_str(), TEXTURE_SIZE, TEXTURE_SIZE, 3, pixels.data(), TEXTURE_SIZE * 3);
+            paths.push_back(std::move(path));
+        }
+    }
+    return paths;
+}
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// the old material path, one texture after another
+double decodeSequentially(const std::vector<fs::path> &paths)
+{
+    const auto start = Clock::now();
+    for (const auto &path : paths) TextureImporter::loadTexture(path);
+    return millisecondsSince(start);
+}
+
+// what the mesh serializer's prefetch does, a task per texture joined once
+double decodeAsTasks(TaskManager &taskManager, const std::vector<fs::path> &paths)
+{
+    const auto start = Clock::now();
+    std::vector<Ref<Task<Ref<Texture2D>>>> tasks;
+    tasks.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        auto task = Task<Ref<Texture2D>>::create(TaskKey{TaskType::ImageLoad, i},
+            [&path = paths[i]] { return TextureImporter::loadTexture(path); });
+        taskManager.submitTask(task, TaskPriority::Visible);
+        tasks.push_back(std::move(task));
+    }
+    taskManager.join(tasks);
+    return millisecondsSince(start);
+}
+} // namespace
+
+int runTextures()
+{
+    const auto directory = fs::temp_directory_path() / "sky_texture_benchmark";
+    const auto paths = writeTextures(directory);
+
+    const size_t workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    TaskManager taskManager(workers);
+
+    double sequential = std::numeric_limits<double>::max();
+    double tasks = std::numeric_limits<double>::max();
+    for (int i = 0; i < REPEATS; ++i)
+    {
+        sequential = std::min(sequential, decodeSequentially(paths));
+        tasks = std::min(tasks, decodeAsTasks(taskManager, paths));
+    }
+
+    SKY_CORE_INFO("{} materials, {} {}x{} PNG textures, {} workers", MATERIAL_COUNT, paths.size(), TEXTURE_SIZE,
+        TEXTURE_SIZE, workers);
+    SKY_CORE_INFO("sequential {:8.1f} ms", sequential);
+    SKY_CORE_INFO("tasks      {:8.1f} ms  speedup {:5.2f}x", tasks, sequential / tasks);
+
+    fs::remove_all(directory);
+    return 0;
+}
+} // namespace sky::benchmark
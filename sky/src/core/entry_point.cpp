@@ -1,9 +1,18 @@
 #include "application.h"
+#include "core/benchmark/benchmark.h"
 
 extern sky::Application *CreateApplication();
 
 int main(int argc, char **argv)
 {
+    // sky --benchmark <name> runs a headless benchmark instead of the application
+    if (argc > 2 && std::string_view(argv[1]) == "--benchmark") return sky::benchmark::run(argv[2]);
+
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::string_view(argv[i]) == "--packed") sky::Application::m_commandLine.packedProject = argv[++i];
+    }
+
     auto app = sky::CreateApplication();
     app->run();
     delete app;
@@ -19,6 +19,7 @@ enum class EditorEventType
     CreateNewMaterialFrom,
     CreateDefaultMaterial,
     ToggleEnvironmentPanel,
+    CookAssetPack,
 };
 
 struct EditorEvent
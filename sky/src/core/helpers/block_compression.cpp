@@ -0,0 +1,930 @@
+#include "block_compression.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <tracy/Tracy.hpp>
+
+#include "core/tasks/task_manager.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKY_BC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sky
+{
+namespace helper
+{
+namespace
+{
+constexpr uint32_t BLOCK_PIXELS = 16;
+
+// 4x4 RGBA8 pixels, edge blocks repeat the last row and column
+struct Block
+{
+    alignas(16) uint8_t pixels[BLOCK_PIXELS][4];
+};
+
+void loadBlock(const uint8_t *level, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, Block &block)
+{
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        const uint32_t sy = std::min(by * 4 + y, height - 1);
+        for (uint32_t x = 0; x < 4; ++x)
+        {
+            const uint32_t sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block.pixels[y * 4 + x], level + (uint64_t(sy) * width + sx) * 4, 4);
+        }
+    }
+}
+
+// Nearest palette entry by squared RGBA distance, error receives the distance. Channels that must not
+// count are zeroed in both the pixel and the palette.
+uint32_t findClosest(const uint8_t *pixel, const uint8_t (*palette)[4], uint32_t count, uint32_t &error)
+{
+    uint32_t best = 0;
+    uint32_t bestError = UINT32_MAX;
+    uint32_t i = 0;
+#ifdef SKY_BC_SSE2
+    // four entries at a time, the pixel is widened to 16 bits once and compared against two per half
+    int32_t packed;
+    std::memcpy(&packed, pixel, sizeof(packed));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i p = _mm_unpacklo_epi8(_mm_set1_epi32(packed), zero);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i entries = _mm_loadu_si128(reinterpret_cast<const __m128i *>(palette[i]));
+        const __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(entries, zero), p);
+        const __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(entries, zero), p);
+
+        // r*r + g*g and b*b + a*a of each entry, then the two halves of every entry added up
+        const __m128 sqLo = _mm_castsi128_ps(_mm_madd_epi16(lo, lo));
+        const __m128 sqHi = _mm_castsi128_ps(_mm_madd_epi16(hi, hi));
+        const __m128i rg = _mm_castps_si128(_mm_shuffle_ps(sqLo, sqHi, _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i ba = _mm_castps_si128(_mm_shuffle_ps(sqLo, sqHi, _MM_SHUFFLE(3, 1, 3, 1)));
+
+        alignas(16) uint32_t errors[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(errors), _mm_add_epi32(rg, ba));
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            if (errors[j] < bestError)
+            {
+                bestError = errors[j];
+                best = i + j;
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        uint32_t distance = 0;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            const int d = int(palette[i][c]) - int(pixel[c]);
+            distance += d * d;
+        }
+        if (distance < bestError)
+        {
+            bestError = distance;
+            best = i;
+        }
+    }
+    error = bestError;
+    return best;
+}
+
+// Endpoints along the principal axis of the first channels of a block of pixels in [0, maxValue],
+// found by power iteration on the covariance. A flat block gives its mean twice.
+template <typename T>
+void computeAxisEndpoints(const T (&pixels)[BLOCK_PIXELS][4], uint32_t channels, float maxValue, float lo[4],
+    float hi[4])
+{
+    float mean[4] = {};
+    for (const auto &px : pixels)
+        for (uint32_t c = 0; c < channels; ++c) mean[c] += px[c];
+    for (uint32_t c = 0; c < channels; ++c) mean[c] /= BLOCK_PIXELS;
+
+    float covariance[4][4] = {};
+    for (const auto &px : pixels)
+    {
+        for (uint32_t a = 0; a < channels; ++a)
+            for (uint32_t b = a; b < channels; ++b) covariance[a][b] += (px[a] - mean[a]) * (px[b] - mean[b]);
+    }
+    for (uint32_t a = 0; a < channels; ++a)
+        for (uint32_t b = 0; b < a; ++b) covariance[a][b] = covariance[b][a];
+
+    // the row of the widest channel is never orthogonal to the axis we are after
+    uint32_t widest = 0;
+    for (uint32_t c = 1; c < channels; ++c)
+        if (covariance[c][c] > covariance[widest][widest]) widest = c;
+
+    float axis[4] = {};
+    for (uint32_t c = 0; c < channels; ++c) axis[c] = covariance[widest][c];
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        float length = 0.f;
+        for (uint32_t a = 0; a < channels; ++a)
+        {
+            for (uint32_t b = 0; b < channels; ++b) next[a] += covariance[a][b] * axis[b];
+            length += next[a] * next[a];
+        }
+        if (length < 1e-12f) break;
+        length = 1.f / std::sqrt(length);
+        for (uint32_t c = 0; c < channels; ++c) axis[c] = next[c] * length;
+    }
+
+    float length = 0.f;
+    for (uint32_t c = 0; c < channels; ++c) length += axis[c] * axis[c];
+    if (length < 1e-12f)
+    {
+        for (uint32_t c = 0; c < 4; ++c) lo[c] = hi[c] = c < channels ? mean[c] : 0.f;
+        return;
+    }
+    length = 1.f / std::sqrt(length);
+    for (uint32_t c = 0; c < channels; ++c) axis[c] *= length;
+
+    float tMin = FLT_MAX, tMax = -FLT_MAX;
+    for (const auto &px : pixels)
+    {
+        float t = 0.f;
+        for (uint32_t c = 0; c < channels; ++c) t += (px[c] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        lo[c] = c < channels ? std::clamp(mean[c] + axis[c] * tMin, 0.f, maxValue) : 0.f;
+        hi[c] = c < channels ? std::clamp(mean[c] + axis[c] * tMax, 0.f, maxValue) : 0.f;
+    }
+}
+
+// Least squares endpoints for pixels that sit at weights between lo (0) and hi (1). False when every
+// pixel has the same weight and the endpoints can not be told apart.
+template <typename T>
+bool solveEndpoints(const T (&pixels)[BLOCK_PIXELS][4], uint32_t channels, float maxValue,
+    const float weights[BLOCK_PIXELS], float lo[4], float hi[4])
+{
+    float aa = 0.f, bb = 0.f, ab = 0.f;
+    float ax[4] = {}, bx[4] = {};
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        const float b = weights[i];
+        const float a = 1.f - b;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            ax[c] += a * pixels[i][c];
+            bx[c] += b * pixels[i][c];
+        }
+    }
+
+    const float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) return false;
+    const float invDet = 1.f / det;
+    for (uint32_t c = 0; c < channels; ++c)
+    {
+        lo[c] = std::clamp((ax[c] * bb - bx[c] * ab) * invDet, 0.f, maxValue);
+        hi[c] = std::clamp((bx[c] * aa - ax[c] * ab) * invDet, 0.f, maxValue);
+    }
+    return true;
+}
+
+uint32_t getRefinePasses(BlockCompressionQuality quality)
+{
+    switch (quality)
+    {
+    case BlockCompressionQuality::High: return 3;
+    case BlockCompressionQuality::Normal: return 1;
+    default: return 0;
+    }
+}
+
+// BC1 color, also the second half of BC3
+
+uint16_t quantize565(const float color[4])
+{
+    const auto r = static_cast<uint16_t>(std::clamp(color[0] * (31.f / 255.f) + 0.5f, 0.f, 31.f));
+    const auto g = static_cast<uint16_t>(std::clamp(color[1] * (63.f / 255.f) + 0.5f, 0.f, 63.f));
+    const auto b = static_cast<uint16_t>(std::clamp(color[2] * (31.f / 255.f) + 0.5f, 0.f, 31.f));
+    return uint16_t(r << 11 | g << 5 | b);
+}
+
+void decode565(uint16_t color, uint8_t out[4])
+{
+    const uint32_t r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+    out[0] = uint8_t(r << 3 | r >> 2);
+    out[1] = uint8_t(g << 2 | g >> 4);
+    out[2] = uint8_t(b << 3 | b >> 2);
+    out[3] = 0;
+}
+
+struct ColorFit
+{
+    uint16_t color0 = 0;
+    uint16_t color1 = 0;
+    uint8_t palette[4][4] = {};
+    uint8_t indices[BLOCK_PIXELS] = {};
+    uint32_t error = UINT32_MAX;
+};
+
+// rgb has its alpha zeroed so it does not count
+ColorFit fitColors(const Block &rgb, uint16_t color0, uint16_t color1)
+{
+    // color0 > color1 selects the four color mode, equal endpoints would select the three color one
+    // and only index 0 is safe to use
+    if (color0 < color1) std::swap(color0, color1);
+
+    ColorFit fit;
+    fit.color0 = color0;
+    fit.color1 = color1;
+    decode565(color0, fit.palette[0]);
+    decode565(color1, fit.palette[1]);
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        fit.palette[2][c] = uint8_t((2 * fit.palette[0][c] + fit.palette[1][c] + 1) / 3);
+        fit.palette[3][c] = uint8_t((fit.palette[0][c] + 2 * fit.palette[1][c] + 1) / 3);
+    }
+
+    const uint32_t count = color0 == color1 ? 1 : 4;
+    fit.error = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        uint32_t error;
+        fit.indices[i] = uint8_t(findClosest(rgb.pixels[i], fit.palette, count, error));
+        fit.error += error;
+    }
+    return fit;
+}
+
+void encodeColorBlock(const Block &block, BlockCompressionQuality quality, uint8_t *out, Block &decoded)
+{
+    Block rgb = block;
+    for (auto &px : rgb.pixels) px[3] = 0;
+
+    float lo[4], hi[4];
+    computeAxisEndpoints(rgb.pixels, 3, 255.f, lo, hi);
+    auto best = fitColors(rgb, quantize565(hi), quantize565(lo));
+
+    // weight of color1 for each index
+    static constexpr float s_weights[4] = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+    for (uint32_t pass = 0, passes = getRefinePasses(quality); pass < passes && best.error > 0; ++pass)
+    {
+        float weights[BLOCK_PIXELS];
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) weights[i] = s_weights[best.indices[i]];
+        // lo sits at weight 0, which is color0
+        if (!solveEndpoints(rgb.pixels, 3, 255.f, weights, lo, hi)) break;
+
+        const auto fit = fitColors(rgb, quantize565(lo), quantize565(hi));
+        if (fit.error >= best.error) break;
+        best = fit;
+    }
+
+    std::memcpy(out, &best.color0, 2);
+    std::memcpy(out + 2, &best.color1, 2);
+    uint32_t indices = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) indices |= uint32_t(best.indices[i]) << (2 * i);
+    std::memcpy(out + 4, &indices, 4);
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) std::memcpy(decoded.pixels[i], best.palette[best.indices[i]], 3);
+}
+
+// BC4 single channel, the alpha half of BC3 and both halves of BC5
+
+struct ChannelFit
+{
+    uint8_t end0 = 0;
+    uint8_t end1 = 0;
+    uint8_t palette[8] = {};
+    uint8_t indices[BLOCK_PIXELS] = {};
+    uint32_t error = UINT32_MAX;
+};
+
+// end0 > end1 interpolates six values between them, otherwise four plus 0 and 255
+ChannelFit fitChannel(const uint8_t values[BLOCK_PIXELS], uint8_t end0, uint8_t end1)
+{
+    ChannelFit fit;
+    fit.end0 = end0;
+    fit.end1 = end1;
+    fit.palette[0] = end0;
+    fit.palette[1] = end1;
+    if (end0 > end1)
+    {
+        for (uint32_t i = 2; i < 8; ++i) fit.palette[i] = uint8_t(((8 - i) * end0 + (i - 1) * end1 + 3) / 7);
+    }
+    else
+    {
+        for (uint32_t i = 2; i < 6; ++i) fit.palette[i] = uint8_t(((6 - i) * end0 + (i - 1) * end1 + 2) / 5);
+        fit.palette[6] = 0;
+        fit.palette[7] = 255;
+    }
+
+    fit.error = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        uint32_t best = 0, bestError = UINT32_MAX;
+        for (uint32_t j = 0; j < 8; ++j)
+        {
+            const int d = int(fit.palette[j]) - int(values[i]);
+            if (uint32_t(d * d) < bestError)
+            {
+                bestError = d * d;
+                best = j;
+            }
+        }
+        fit.indices[i] = uint8_t(best);
+        fit.error += bestError;
+    }
+    return fit;
+}
+
+void encodeChannelBlock(const Block &block, uint32_t channel, BlockCompressionQuality quality, uint8_t *out,
+    Block &decoded)
+{
+    uint8_t values[BLOCK_PIXELS];
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) values[i] = block.pixels[i][channel];
+    const auto [minIt, maxIt] = std::minmax_element(std::begin(values), std::end(values));
+    const int lo = *minIt, hi = *maxIt;
+
+    ChannelFit best = fitChannel(values, uint8_t(hi), uint8_t(lo));
+    if (lo != hi && quality != BlockCompressionQuality::Fast)
+    {
+        // the six value mode keeps exact 0 and 255 for free, the rest spreads over what is in between
+        int innerLo = 255, innerHi = 0;
+        for (const auto v : values)
+        {
+            if (v == 0 || v == 255) continue;
+            innerLo = std::min<int>(innerLo, v);
+            innerHi = std::max<int>(innerHi, v);
+        }
+        if ((lo == 0 || hi == 255) && innerLo <= innerHi)
+        {
+            const auto fit = fitChannel(values, uint8_t(innerLo), uint8_t(innerHi));
+            if (fit.error < best.error) best = fit;
+        }
+
+        // min and max are rarely the best endpoints, the error is spread better a little inside them
+        const int radius = quality == BlockCompressionQuality::High ? 4 : 1;
+        for (int d0 = -radius; d0 <= radius && best.error > 0; ++d0)
+        {
+            for (int d1 = -radius; d1 <= radius; ++d1)
+            {
+                const int end0 = std::clamp(hi + d0, 0, 255), end1 = std::clamp(lo + d1, 0, 255);
+                if (end0 <= end1) continue;
+                const auto fit = fitChannel(values, uint8_t(end0), uint8_t(end1));
+                if (fit.error < best.error) best = fit;
+            }
+        }
+    }
+
+    out[0] = best.end0;
+    out[1] = best.end1;
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) indices |= uint64_t(best.indices[i]) << (3 * i);
+    for (uint32_t i = 0; i < 6; ++i) out[2 + i] = uint8_t(indices >> (8 * i));
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) decoded.pixels[i][channel] = best.palette[best.indices[i]];
+}
+
+// BC7, mode 6 only: one subset, 7 bit RGBA endpoints with a parity bit each and 4 bit indices
+
+constexpr uint8_t BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct Mode6Fit
+{
+    uint8_t endpoints[2][4] = {}; // 7 bit
+    uint8_t parity[2] = {};
+    uint8_t palette[16][4] = {};
+    uint8_t indices[BLOCK_PIXELS] = {};
+    uint32_t error = UINT32_MAX;
+};
+
+uint8_t quantize7(float value, uint32_t parity)
+{
+    return static_cast<uint8_t>(std::clamp((value - parity) * 0.5f + 0.5f, 0.f, 127.f));
+}
+
+// the parity bit that brings the endpoint closest to its unquantized color
+uint8_t chooseParity(const float endpoint[4])
+{
+    float errors[2] = {};
+    for (uint32_t parity = 0; parity < 2; ++parity)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            const float d = float(quantize7(endpoint[c], parity) << 1 | parity) - endpoint[c];
+            errors[parity] += d * d;
+        }
+    }
+    return errors[1] < errors[0] ? 1 : 0;
+}
+
+Mode6Fit fitMode6(const Block &block, const float lo[4], const float hi[4], uint8_t parity0, uint8_t parity1)
+{
+    Mode6Fit fit;
+    fit.parity[0] = parity0;
+    fit.parity[1] = parity1;
+    uint8_t end0[4], end1[4];
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        fit.endpoints[0][c] = quantize7(lo[c], parity0);
+        fit.endpoints[1][c] = quantize7(hi[c], parity1);
+        end0[c] = uint8_t(fit.endpoints[0][c] << 1 | parity0);
+        end1[c] = uint8_t(fit.endpoints[1][c] << 1 | parity1);
+    }
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        const uint32_t w = BC7_WEIGHTS4[i];
+        for (uint32_t c = 0; c < 4; ++c) fit.palette[i][c] = uint8_t(((64 - w) * end0[c] + w * end1[c] + 32) >> 6);
+    }
+
+    fit.error = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        uint32_t error;
+        fit.indices[i] = uint8_t(findClosest(block.pixels[i], fit.palette, 16, error));
+        fit.error += error;
+    }
+    return fit;
+}
+
+Mode6Fit fitMode6(const Block &block, const float lo[4], const float hi[4], BlockCompressionQuality quality)
+{
+    if (quality != BlockCompressionQuality::High) return fitMode6(block, lo, hi, chooseParity(lo), chooseParity(hi));
+
+    Mode6Fit best;
+    for (uint8_t parity = 0; parity < 4; ++parity)
+    {
+        const auto fit = fitMode6(block, lo, hi, parity & 1, parity >> 1);
+        if (fit.error < best.error) best = fit;
+    }
+    return best;
+}
+
+struct BitWriter
+{
+    uint8_t *out;
+    uint32_t position = 0;
+
+    void write(uint32_t value, uint32_t bits)
+    {
+        for (uint32_t i = 0; i < bits; ++i, ++position)
+        {
+            if (value >> i & 1) out[position / 8] |= uint8_t(1 << (position % 8));
+        }
+    }
+};
+
+void encodeMode6Block(const Block &block, BlockCompressionQuality quality, uint8_t *out, Block &decoded)
+{
+    float lo[4], hi[4];
+    computeAxisEndpoints(block.pixels, 4, 255.f, lo, hi);
+    auto best = fitMode6(block, lo, hi, quality);
+
+    for (uint32_t pass = 0, passes = getRefinePasses(quality); pass < passes && best.error > 0; ++pass)
+    {
+        float weights[BLOCK_PIXELS];
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) weights[i] = BC7_WEIGHTS4[best.indices[i]] / 64.f;
+        if (!solveEndpoints(block.pixels, 4, 255.f, weights, lo, hi)) break;
+
+        const auto fit = fitMode6(block, lo, hi, quality);
+        if (fit.error >= best.error) break;
+        best = fit;
+    }
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) std::memcpy(decoded.pixels[i], best.palette[best.indices[i]], 4);
+
+    // the first index drops its top bit, swapping the endpoints keeps it clear
+    if (best.indices[0] & 8)
+    {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        std::swap(best.parity[0], best.parity[1]);
+        for (auto &index : best.indices) index = uint8_t(15 - index);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.write(1 << 6, 7);
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        writer.write(best.endpoints[0][c], 7);
+        writer.write(best.endpoints[1][c], 7);
+    }
+    writer.write(best.parity[0], 1);
+    writer.write(best.parity[1], 1);
+    writer.write(best.indices[0], 3);
+    for (uint32_t i = 1; i < BLOCK_PIXELS; ++i) writer.write(best.indices[i], 4);
+}
+
+void encodeBlock(const Block &block, TextureFormat format, BlockCompressionQuality quality, uint8_t *out,
+    Block &decoded)
+{
+    decoded = block;
+    switch (format)
+    {
+    case TextureFormat::BC1Unorm:
+    case TextureFormat::BC1Srgb: encodeColorBlock(block, quality, out, decoded); break;
+    case TextureFormat::BC3Unorm:
+    case TextureFormat::BC3Srgb:
+        encodeChannelBlock(block, 3, quality, out, decoded);
+        encodeColorBlock(block, quality, out + 8, decoded);
+        break;
+    case TextureFormat::BC4Unorm: encodeChannelBlock(block, 0, quality, out, decoded); break;
+    case TextureFormat::BC5Unorm:
+        encodeChannelBlock(block, 0, quality, out, decoded);
+        encodeChannelBlock(block, 1, quality, out + 8, decoded);
+        break;
+    case TextureFormat::BC7Unorm:
+    case TextureFormat::BC7Srgb: encodeMode6Block(block, quality, out, decoded); break;
+    default: break;
+    }
+}
+
+// the channels a format keeps, always the first ones
+uint32_t getKeptChannels(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1Unorm:
+    case TextureFormat::BC1Srgb: return 3;
+    case TextureFormat::BC4Unorm: return 1;
+    case TextureFormat::BC5Unorm: return 2;
+    default: return 4;
+    }
+}
+
+// BC6H unsigned, mode 11 only: one region, 10 bit RGB endpoints and 4 bit indices. Endpoints are
+// interpolated as 16 bit values, which are scaled by 31/64 into half float bits. Those bits grow about
+// like log2 of the value, errors are measured on them.
+
+constexpr float BC6H_MAX = 65535.f;
+
+struct HdrBlock
+{
+    uint16_t halves[BLOCK_PIXELS][4];  // RGB half floats the decoder can give, alpha unused
+    float values[BLOCK_PIXELS][4];     // halves in the interpolation range
+};
+
+// negative, infinity and NaN are out of reach of an unsigned block
+uint16_t toUnsignedHalf(uint16_t half)
+{
+    if (half & 0x8000) return 0;
+    if ((half & 0x7C00) == 0x7C00) return half & 0x3FF ? 0 : 0x7BFF;
+    return half;
+}
+
+void loadHdrBlock(const uint16_t *pixels, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, HdrBlock &block)
+{
+    for (uint32_t y = 0; y < 4; ++y)
+    {
+        const uint32_t sy = std::min(by * 4 + y, height - 1);
+        for (uint32_t x = 0; x < 4; ++x)
+        {
+            const uint32_t sx = std::min(bx * 4 + x, width - 1);
+            const uint16_t *pixel = pixels + (uint64_t(sy) * width + sx) * 4;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const uint16_t half = c < 3 ? toUnsignedHalf(pixel[c]) : 0;
+                block.halves[y * 4 + x][c] = half;
+                block.values[y * 4 + x][c] = half * (64.f / 31.f);
+            }
+        }
+    }
+}
+
+uint16_t quantize10(float value)
+{
+    return uint16_t(std::clamp((value - 32.f) / 64.f + 0.5f, 0.f, 1023.f));
+}
+
+uint32_t unquantize10(uint16_t endpoint)
+{
+    if (endpoint == 0) return 0;
+    if (endpoint == 1023) return 0xFFFF;
+    return (uint32_t(endpoint) << 16 | 0x8000) >> 10;
+}
+
+struct Mode11Fit
+{
+    uint16_t endpoints[2][3] = {};
+    uint16_t palette[16][3] = {}; // half floats
+    uint8_t indices[BLOCK_PIXELS] = {};
+    uint64_t error = UINT64_MAX;
+};
+
+Mode11Fit fitMode11(const HdrBlock &block, const float lo[4], const float hi[4])
+{
+    Mode11Fit fit;
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        fit.endpoints[0][c] = quantize10(lo[c]);
+        fit.endpoints[1][c] = quantize10(hi[c]);
+    }
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        const uint32_t w = BC7_WEIGHTS4[i];
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            const uint32_t value =
+                ((64 - w) * unquantize10(fit.endpoints[0][c]) + w * unquantize10(fit.endpoints[1][c]) + 32) >> 6;
+            fit.palette[i][c] = uint16_t(value * 31 >> 6);
+        }
+    }
+
+    fit.error = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        uint64_t bestError = UINT64_MAX;
+        for (uint32_t j = 0; j < 16; ++j)
+        {
+            uint64_t error = 0;
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                const int64_t d = int64_t(fit.palette[j][c]) - block.halves[i][c];
+                error += uint64_t(d * d);
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                fit.indices[i] = uint8_t(j);
+            }
+        }
+        fit.error += bestError;
+    }
+    return fit;
+}
+
+void encodeMode11Block(const HdrBlock &block, BlockCompressionQuality quality, uint8_t *out, uint16_t (*decoded)[3])
+{
+    float lo[4], hi[4];
+    computeAxisEndpoints(block.values, 3, BC6H_MAX, lo, hi);
+    auto best = fitMode11(block, lo, hi);
+
+    // one pass more than the LDR formats, the 10 bit endpoints leave more room to find
+    for (uint32_t pass = 0, passes = getRefinePasses(quality) + 1; pass < passes && best.error > 0; ++pass)
+    {
+        float weights[BLOCK_PIXELS];
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) weights[i] = BC7_WEIGHTS4[best.indices[i]] / 64.f;
+        if (!solveEndpoints(block.values, 3, BC6H_MAX, weights, lo, hi)) break;
+
+        const auto fit = fitMode11(block, lo, hi);
+        if (fit.error >= best.error) break;
+        best = fit;
+    }
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i) std::memcpy(decoded[i], best.palette[best.indices[i]], 6);
+
+    // as in BC7 the first index drops its top bit
+    if (best.indices[0] & 8)
+    {
+        std::swap(best.endpoints[0], best.endpoints[1]);
+        for (auto &index : best.indices) index = uint8_t(15 - index);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.write(0x03, 5);
+    for (const auto &endpoint : best.endpoints)
+        for (uint32_t c = 0; c < 3; ++c) writer.write(endpoint[c], 10);
+    writer.write(best.indices[0], 3);
+    for (uint32_t i = 1; i < BLOCK_PIXELS; ++i) writer.write(best.indices[i], 4);
+}
+
+struct BitReader
+{
+    const uint8_t *in;
+    uint32_t position = 0;
+
+    uint32_t read(uint32_t bits)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < bits; ++i, ++position) value |= uint32_t(in[position / 8] >> (position % 8) & 1) << i;
+        return value;
+    }
+};
+
+// other modes are never written by encodeMode11Block, they decode to black
+bool decodeMode11Block(const uint8_t *in, uint16_t (*decoded)[3])
+{
+    BitReader reader{in};
+    if (reader.read(5) != 0x03)
+    {
+        std::memset(decoded, 0, sizeof(uint16_t) * 3 * BLOCK_PIXELS);
+        return false;
+    }
+
+    uint32_t endpoints[2][3];
+    for (auto &endpoint : endpoints)
+        for (uint32_t c = 0; c < 3; ++c) endpoint[c] = unquantize10(uint16_t(reader.read(10)));
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        const uint32_t w = BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)];
+        for (uint32_t c = 0; c < 3; ++c)
+            decoded[i][c] = uint16_t((((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6) * 31 >> 6);
+    }
+    return true;
+}
+} // namespace
+
+const char *toString(BlockCompressionQuality quality)
+{
+    switch (quality)
+    {
+    case BlockCompressionQuality::None: return "none";
+    case BlockCompressionQuality::Fast: return "fast";
+    case BlockCompressionQuality::Normal: return "normal";
+    case BlockCompressionQuality::High: return "high";
+    }
+    return "normal";
+}
+
+BlockCompressionQuality parseBlockCompressionQuality(std::string_view name)
+{
+    if (name == "none") return BlockCompressionQuality::None;
+    if (name == "fast") return BlockCompressionQuality::Fast;
+    if (name == "high") return BlockCompressionQuality::High;
+    return BlockCompressionQuality::Normal;
+}
+
+const char *toString(HdrStorage storage)
+{
+    switch (storage)
+    {
+    case HdrStorage::Half: return "half";
+    case HdrStorage::SharedExponent: return "rgb9e5";
+    case HdrStorage::BC6H: return "bc6h";
+    }
+    return "rgb9e5";
+}
+
+HdrStorage parseHdrStorage(std::string_view name)
+{
+    if (name == "half") return HdrStorage::Half;
+    if (name == "bc6h") return HdrStorage::BC6H;
+    return HdrStorage::SharedExponent;
+}
+
+std::vector<uint8_t> compressMipChain(std::span<const uint8_t> chain, std::vector<gfx::ImageMipLevel> &levels,
+    TextureFormat format, BlockCompressionQuality quality, TaskManager *taskManager, BlockCompressionReport *report)
+{
+    ZoneScopedN("Block compress");
+    assert(isBlockCompressed(format));
+    const auto start = std::chrono::steady_clock::now();
+
+    const uint64_t blockSize = getTextureLevelSize(format, 4, 4);
+    std::vector<gfx::ImageMipLevel> compressed;
+    std::vector<size_t> firstBlocks; // of each level, blocks of all levels are numbered in one range
+    uint64_t total = 0;
+    size_t blockCount = 0;
+    for (const auto &level : levels)
+    {
+        const uint64_t size = getTextureLevelSize(format, level.width, level.height);
+        compressed.push_back({level.width, level.height, total, size});
+        firstBlocks.push_back(blockCount);
+        total += size;
+        blockCount += size / blockSize;
+    }
+
+    std::vector<uint8_t> out(total);
+    // squared error of every block of level 0
+    std::vector<uint64_t> errors(report && !levels.empty() ? compressed[0].size / blockSize : 0);
+    const uint32_t keptChannels = getKeptChannels(format);
+
+    const auto encode = [&](size_t index)
+    {
+        const size_t levelIndex = std::upper_bound(firstBlocks.begin(), firstBlocks.end(), index) - firstBlocks.begin() - 1;
+        const auto &source = levels[levelIndex];
+        const size_t local = index - firstBlocks[levelIndex];
+        const uint32_t blocksX = (source.width + 3) / 4;
+        const uint32_t bx = uint32_t(local % blocksX), by = uint32_t(local / blocksX);
+
+        Block block, decoded;
+        loadBlock(chain.data() + source.offset, source.width, source.height, bx, by, block);
+        encodeBlock(block, format, quality, out.data() + compressed[levelIndex].offset + local * blockSize, decoded);
+
+        if (levelIndex != 0 || errors.empty()) return;
+        // repeated edge pixels are not part of the image
+        uint64_t error = 0;
+        for (uint32_t y = 0; y < 4 && by * 4 + y < source.height; ++y)
+        {
+            for (uint32_t x = 0; x < 4 && bx * 4 + x < source.width; ++x)
+            {
+                for (uint32_t c = 0; c < keptChannels; ++c)
+                {
+                    const int d = int(block.pixels[y * 4 + x][c]) - int(decoded.pixels[y * 4 + x][c]);
+                    error += d * d;
+                }
+            }
+        }
+        errors[local] = error;
+    };
+
+    if (taskManager) taskManager->parallelFor(0, blockCount, encode);
+    else
+        for (size_t i = 0; i < blockCount; ++i) encode(i);
+
+    if (report)
+    {
+        const uint64_t error = std::accumulate(errors.begin(), errors.end(), uint64_t(0));
+        const double samples = levels.empty() ? 1.0 : double(levels[0].width) * levels[0].height * keptChannels;
+        report->psnr = error == 0 ? std::numeric_limits<double>::infinity()
+                                  : 10.0 * std::log10(255.0 * 255.0 * samples / double(error));
+        report->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    levels = std::move(compressed);
+    return out;
+}
+
+std::vector<uint8_t> compressBC6H(std::span<const uint16_t> pixels, uint32_t width, uint32_t height,
+    BlockCompressionQuality quality, TaskManager *taskManager, BlockCompressionReport *report)
+{
+    ZoneScopedN("BC6H compress");
+    assert(pixels.size() >= size_t(width) * height * 4);
+    const auto start = std::chrono::steady_clock::now();
+
+    const uint32_t blocksX = (width + 3) / 4;
+    const size_t blockCount = getTextureLevelSize(TextureFormat::BC6HUfloat, width, height) / 16;
+    std::vector<uint8_t> out(blockCount * 16);
+    std::vector<uint64_t> errors(report ? blockCount : 0);
+
+    const auto encode = [&](size_t index)
+    {
+        const uint32_t bx = uint32_t(index % blocksX), by = uint32_t(index / blocksX);
+        HdrBlock block;
+        uint16_t decoded[BLOCK_PIXELS][3];
+        loadHdrBlock(pixels.data(), width, height, bx, by, block);
+        encodeMode11Block(block, quality, out.data() + index * 16, decoded);
+
+        if (errors.empty()) return;
+        uint64_t error = 0;
+        for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+        {
+            for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+            {
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    const int64_t d = int64_t(block.halves[y * 4 + x][c]) - decoded[y * 4 + x][c];
+                    error += uint64_t(d * d);
+                }
+            }
+        }
+        errors[index] = error;
+    };
+
+    if (taskManager) taskManager->parallelFor(0, blockCount, encode);
+    else
+        for (size_t i = 0; i < blockCount; ++i) encode(i);
+
+    if (report)
+    {
+        // peak is the largest finite half
+        const uint64_t error = std::accumulate(errors.begin(), errors.end(), uint64_t(0));
+        const double samples = double(width) * height * 3;
+        report->psnr = error == 0 ? std::numeric_limits<double>::infinity()
+                                  : 10.0 * std::log10(double(0x7BFF) * 0x7BFF * samples / double(error));
+        report->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return out;
+}
+
+std::vector<uint16_t> decompressBC6H(std::span<const uint8_t> blocks, uint32_t width, uint32_t height,
+    TaskManager *taskManager)
+{
+    ZoneScopedN("BC6H decompress");
+    const uint32_t blocksX = (width + 3) / 4;
+    const size_t blockCount = getTextureLevelSize(TextureFormat::BC6HUfloat, width, height) / 16;
+    assert(blocks.size() >= blockCount * 16);
+    std::vector<uint16_t> pixels(size_t(width) * height * 4);
+    std::atomic<bool> otherModes = false;
+
+    const auto decode = [&](size_t index)
+    {
+        const uint32_t bx = uint32_t(index % blocksX), by = uint32_t(index / blocksX);
+        uint16_t decoded[BLOCK_PIXELS][3];
+        if (!decodeMode11Block(blocks.data() + index * 16, decoded)) otherModes = true;
+
+        for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+        {
+            for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+            {
+                uint16_t *pixel = pixels.data() + ((uint64_t(by) * 4 + y) * width + bx * 4 + x) * 4;
+                std::memcpy(pixel, decoded[y * 4 + x], 6);
+                pixel[3] = 0x3C00; // 1.0
+            }
+        }
+    };
+
+    if (taskManager) taskManager->parallelFor(0, blockCount, decode);
+    else
+        for (size_t i = 0; i < blockCount; ++i) decode(i);
+
+    if (otherModes) SKY_CORE_WARN("BC6H blocks in modes other than 11 were decoded as black");
+    return pixels;
+}
+}
+}
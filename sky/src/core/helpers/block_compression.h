@@ -0,0 +1,59 @@
+#pragma once
+
+#include <skypch.h>
+#include "graphics/vulkan/vk_types.h"
+#include "renderer/texture.h"
+
+namespace sky
+{
+class TaskManager;
+
+namespace helper
+{
+enum class BlockCompressionQuality : uint32_t
+{
+    None = 0, // textures stay RGBA8
+    Fast,     // BC1/BC3 for color, principal axis endpoints as they are
+    Normal,   // BC7 for color, one least squares pass over the endpoints
+    High,     // more endpoint passes, every BC7 parity bit pair and a wider BC4 search
+};
+
+const char *toString(BlockCompressionQuality quality);
+// Unknown names give Normal
+BlockCompressionQuality parseBlockCompressionQuality(std::string_view name);
+
+// How cooked HDR environments keep their pixels, float RGBA takes 16 bytes a pixel
+enum class HdrStorage : uint32_t
+{
+    Half = 0,       // RGBA16F, 8 bytes a pixel
+    SharedExponent, // RGB9E5, 4 bytes a pixel and close to half float precision
+    BC6H,           // 1 byte a pixel, encoded as hard as the texture compression quality says
+};
+
+const char *toString(HdrStorage storage);
+// Unknown names give SharedExponent
+HdrStorage parseHdrStorage(std::string_view name);
+
+struct BlockCompressionReport
+{
+    // over level 0 and the channels the format keeps, infinity when nothing was lost
+    double psnr = 0.0;
+    double milliseconds = 0.0;
+};
+
+// Compresses every level of an RGBA8 mip chain, as built by generateMipChain, to a block compressed
+// format. levels describe chain on input and the compressed chain on output. Blocks are encoded on the
+// task pool when one is given.
+std::vector<uint8_t> compressMipChain(std::span<const uint8_t> chain, std::vector<gfx::ImageMipLevel> &levels,
+    TextureFormat format, BlockCompressionQuality quality, TaskManager *taskManager = nullptr,
+    BlockCompressionReport *report = nullptr);
+
+// Compresses RGBA half float pixels to BC6H unsigned blocks, alpha is dropped and negative values become 0.
+// The report's PSNR is over the half float bits, which follow the log of the values.
+std::vector<uint8_t> compressBC6H(std::span<const uint16_t> pixels, uint32_t width, uint32_t height,
+    BlockCompressionQuality quality, TaskManager *taskManager = nullptr, BlockCompressionReport *report = nullptr);
+// Decodes what compressBC6H wrote to RGBA half floats with an alpha of 1. Only mode 11 is read.
+std::vector<uint16_t> decompressBC6H(std::span<const uint8_t> blocks, uint32_t width, uint32_t height,
+    TaskManager *taskManager = nullptr);
+}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <skypch.h>
+#include "core/filesystem.h"
+
+namespace sky
+{
+namespace helper
+{
+// 64-bit xxHash (XXH64), fast enough to hash asset sources on every import
+uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0);
+uint64_t hashCombine(uint64_t hash, uint64_t value);
+// Hashes the file contents in chunks, nullopt if it can not be read
+std::optional<uint64_t> hashFile(const fs::path &path);
+}
+}
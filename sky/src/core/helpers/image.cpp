@@ -36,6 +36,7 @@ ImageID loadImageFromData(const void *buffer, uint64_t length)
 {
 	auto renderer = Application::getRenderer();
     auto tex = TextureImporter::loadTexture(buffer, length);
+    if (tex == nullptr) return NULL_IMAGE_ID;
     auto texture = renderer->createImage(
         {
             .format = VK_FORMAT_R8G8B8A8_SRGB,
@@ -52,55 +53,201 @@ ImageID loadImageFromData(const void *buffer, uint64_t length)
     return texture;
 }
 
+static bool isSrgbImageFormat(VkFormat format)
+{
+	return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB ||
+		format == VK_FORMAT_BC1_RGB_SRGB_BLOCK || format == VK_FORMAT_BC3_SRGB_BLOCK ||
+		format == VK_FORMAT_BC7_SRGB_BLOCK;
+}
+
+// Compressed textures are created in their block format, in the color space the caller asked for.
+// requested may be a block format itself when an image is replaced.
+static VkFormat getTextureImageFormat(const Texture2D &tex, VkFormat requested)
+{
+	const bool srgb = isSrgbImageFormat(requested);
+	switch (tex.format)
+	{
+	case TextureFormat::BC1Unorm:
+	case TextureFormat::BC1Srgb: return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+	case TextureFormat::BC3Unorm:
+	case TextureFormat::BC3Srgb: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+	case TextureFormat::BC4Unorm: return VK_FORMAT_BC4_UNORM_BLOCK;
+	case TextureFormat::BC5Unorm: return VK_FORMAT_BC5_UNORM_BLOCK;
+	case TextureFormat::BC7Unorm:
+	case TextureFormat::BC7Srgb: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+	default: break;
+	}
+
+	if (requested >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && requested <= VK_FORMAT_BC7_SRGB_BLOCK)
+		return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+	return requested;
+}
+
+// Cooked textures have their whole chain on the image. Textures that were never cooked keep a
+// single level, as they always did.
+static gfx::vkutil::CreateImageInfo getTextureImageInfo(const Texture2D &tex, VkFormat format,
+	VkImageUsageFlags usage, bool mipMap)
+{
+	return {
+		.format = getTextureImageFormat(tex, format),
+		.usage = usage |                           //
+				 VK_IMAGE_USAGE_TRANSFER_DST_BIT | // for uploading pixel data to image
+				 VK_IMAGE_USAGE_TRANSFER_SRC_BIT,  // for generating mips
+		.extent =
+			VkExtent3D{
+				.width = (std::uint32_t)tex.width,
+				.height = (std::uint32_t)tex.height,
+				.depth = 1,
+			},
+		.numMipLevels = mipMap && !tex.mips.empty() ? (std::uint32_t)tex.mips.size() : 1,
+		.mipMap = mipMap,
+	};
+}
+
+// The cooked mips are only right for the color space they were filtered in. Sampled the other way
+// only level 0 is copied and the GPU blits the rest. Blocks can not be blitted, compressed textures
+// always keep their own levels.
+static std::vector<gfx::ImageMipLevel> getTextureUploadLevels(const Texture2D &tex, VkFormat format, bool mipMap)
+{
+	if (isBlockCompressed(tex.format))
+		return mipMap ? tex.mips : std::vector<gfx::ImageMipLevel>{tex.mips.front()};
+
+	const bool srgb = isSrgbImageFormat(format);
+	if (mipMap && !tex.mips.empty() && srgb == (tex.format == TextureFormat::RGBA8Srgb)) return tex.mips;
+
+	const auto width = (std::uint32_t)tex.width;
+	const auto height = (std::uint32_t)tex.height;
+	return {{width, height, 0, std::uint64_t(width) * height * 4}};
+}
+
 ImageID loadImageFromTexture(Ref<Texture2D> tex, VkFormat format, VkImageUsageFlags usage, bool mipMap)
 {
     if (tex == nullptr) return NULL_IMAGE_ID;
 
     if (tex->vkImageID == NULL_IMAGE_ID)
     {
-		auto renderer = Application::getRenderer();
-		tex->vkImageID = renderer->createImage(
-			{
-				.format = format,
-				.usage = usage |                           //
-						 VK_IMAGE_USAGE_TRANSFER_DST_BIT | // for uploading pixel data to image
-						 VK_IMAGE_USAGE_TRANSFER_SRC_BIT,  // for generating mips
-				.extent =
-					VkExtent3D{
-						.width = (std::uint32_t)tex->width,
-						.height = (std::uint32_t)tex->height,
-						.depth = 1,
-					},
-				.mipMap = mipMap,
-			},
-			tex->pixels);
+		auto &device = Application::getRenderer()->getDevice();
+		tex->vkImageID = device.createImageWithMips(getTextureImageInfo(*tex, format, usage, mipMap), tex->pixels,
+			getTextureUploadLevels(*tex, format, mipMap));
+
+		// the gpu image holds the pixels now
+		if (tex->vkImageID != NULL_IMAGE_ID) tex->releasePixels();
     }
 	return tex->vkImageID;
 }
 
+ImageID streamImageFromTexture(Ref<Texture2D> tex, VkFormat format)
+{
+    if (tex == nullptr) return NULL_IMAGE_ID;
+	if (tex->vkImageID != NULL_IMAGE_ID || !hasStreamableMips(*tex, format))
+		return loadImageFromTexture(tex, format);
+
+	auto renderer = Application::getRenderer();
+	return renderer->getTextureStreamer().load(renderer->getDevice(), tex, format);
+}
+
+bool hasStreamableMips(const Texture2D &tex, VkFormat format)
+{
+	// heap pixels would have to be kept around, those are uploaded whole and freed
+	if (tex.pixels == nullptr || tex.pixelOwner == nullptr || tex.mips.size() < 2) return false;
+	return getTextureUploadLevels(tex, format, true).size() == tex.mips.size();
+}
+
+// the levels from firstMip on are the end of the pixels, only they are copied to the staging buffer
+static std::vector<gfx::ImageMipLevel> getTextureMipsFrom(const Texture2D &tex, VkFormat format, uint32_t firstMip,
+	gfx::vkutil::CreateImageInfo &info, const unsigned char *&pixels)
+{
+	assert(firstMip < tex.mips.size());
+
+	std::vector<gfx::ImageMipLevel> levels(tex.mips.begin() + firstMip, tex.mips.end());
+	const auto base = levels.front().offset;
+	for (auto &level : levels) level.offset -= base;
+	pixels = tex.pixels + base;
+
+	info = getTextureImageInfo(tex, format, VK_IMAGE_USAGE_SAMPLED_BIT, true);
+	info.extent = {levels.front().width, levels.front().height, 1};
+	info.numMipLevels = (std::uint32_t)levels.size();
+	return levels;
+}
+
+ImageID createImageFromTextureMips(const Texture2D &tex, VkFormat format, uint32_t firstMip, ImageID imageId)
+{
+	gfx::vkutil::CreateImageInfo info;
+	const unsigned char *pixels;
+	const auto levels = getTextureMipsFrom(tex, format, firstMip, info, pixels);
+
+	auto &device = Application::getRenderer()->getDevice();
+	return device.createImageWithMips(info, pixels, levels, imageId);
+}
+
+gfx::AllocatedImage createImageFromTextureMips(VkCommandBuffer cmd, const Texture2D &tex, VkFormat format,
+	uint32_t firstMip, gfx::AllocatedBuffer &uploadBuffer)
+{
+	gfx::vkutil::CreateImageInfo info;
+	const unsigned char *pixels;
+	const auto levels = getTextureMipsFrom(tex, format, firstMip, info, pixels);
+
+	auto &device = Application::getRenderer()->getDevice();
+	return device.createImageWithMips(cmd, info, pixels, levels, uploadBuffer);
+}
+
+void replaceImageFromTexture(Ref<Texture2D> tex, ImageID imageId, VkImageUsageFlags usage, bool mipMap)
+{
+    if (tex == nullptr || imageId == NULL_IMAGE_ID) return;
+
+	// streamed images would get their old levels back
+	Application::getRenderer()->getTextureStreamer().remove(imageId);
+
+	auto &device = Application::getRenderer()->getDevice();
+	const auto format = device.getImage(imageId).imageFormat;
+	device.replaceImage(imageId, getTextureImageInfo(*tex, format, usage, mipMap), tex->pixels,
+		getTextureUploadLevels(*tex, format, mipMap));
+
+	tex->vkImageID = imageId;
+	tex->releasePixels();
+}
+
+// The cooked format decides, requested is only for float RGBA
+static VkFormat getTextureImageFormat(const TextureCube &tex, VkFormat requested)
+{
+	switch (tex.format)
+	{
+	case TextureFormat::RGBA16Float: return VK_FORMAT_R16G16B16A16_SFLOAT;
+	case TextureFormat::RGB9E5Float: return VK_FORMAT_E5B9G9R9_UFLOAT_PACK32;
+	case TextureFormat::BC6HUfloat: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+	default: return requested;
+	}
+}
+
 ImageID loadImageFromTexture(Ref<TextureCube> tex, VkFormat format, VkImageUsageFlags usage, bool mipMap)
 {
     if (tex == nullptr) return NULL_IMAGE_ID;
 
     if (tex->vkImageID == NULL_IMAGE_ID)
     {
-		auto renderer = Application::getRenderer();
-		tex->vkImageID = renderer->createImage(
+		auto &device = Application::getRenderer()->getDevice();
+		const auto width = (std::uint32_t)tex->width;
+		const auto height = (std::uint32_t)tex->height;
+		const gfx::ImageMipLevel level{width, height, 0, tex->getPixelDataSize()};
+		tex->vkImageID = device.createImageWithMips(
 			{
-				.format = format,
+				.format = getTextureImageFormat(*tex, format),
 				.usage = usage |      
                     VK_IMAGE_USAGE_SAMPLED_BIT |                     
                     VK_IMAGE_USAGE_TRANSFER_DST_BIT,  // for uploading pixel data to image
 				.extent =
 					VkExtent3D{
-						.width = (std::uint32_t)tex->width,
-						.height = (std::uint32_t)tex->height,
+						.width = width,
+						.height = height,
 						.depth = 1,
 					},
                 .numLayers = 6,
 				.mipMap = false,
 			},
-			tex->pixels);
+			tex->pixels, {&level, 1});
+
+		// the gpu image holds the pixels now
+		if (tex->vkImageID != NULL_IMAGE_ID) tex->releasePixels();
     }
 	return tex->vkImageID;
 }
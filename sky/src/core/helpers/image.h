@@ -13,7 +13,25 @@ ImageID loadImageFromFile(const fs::path& path, float scaleFactor = 1.f);
 ImageID loadImageFromData(const void *buffer, uint64_t length);
 ImageID loadImageFromTexture(Ref<Texture2D> tex, VkFormat format, 
 	VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT, bool mipMap = true);
+// format is for float RGBA pixels, compact HDR formats are uploaded as they were cooked
 ImageID loadImageFromTexture(Ref<TextureCube> tex, VkFormat format, 
 	VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT, bool mipMap = true);
+// Like loadImageFromTexture, but cooked textures with mapped pixels only get their smallest mips and the
+// renderer's texture streamer uploads the rest when it is seen up close
+ImageID streamImageFromTexture(Ref<Texture2D> tex, VkFormat format);
+// Whether an image can be made from any of tex's cooked levels later on, they are right for format and
+// stay mapped once uploaded
+bool hasStreamableMips(const Texture2D &tex, VkFormat format);
+// Creates an image of tex's cooked levels from firstMip down, under imageId when one is given. The pixels
+// are kept.
+ImageID createImageFromTextureMips(const Texture2D &tex, VkFormat format, uint32_t firstMip,
+	ImageID imageId = NULL_IMAGE_ID);
+// Like the above with the upload recorded into cmd and without an id, uploadBuffer has to be kept until cmd
+// has run. See Device::swapImage.
+gfx::AllocatedImage createImageFromTextureMips(VkCommandBuffer cmd, const Texture2D &tex, VkFormat format,
+	uint32_t firstMip, gfx::AllocatedBuffer &uploadBuffer);
+// Uploads tex into the existing image, keeping its id and format
+void replaceImageFromTexture(Ref<Texture2D> tex, ImageID imageId,
+	VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT, bool mipMap = true);
 }
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <skypch.h>
+#include "core/filesystem.h"
+
+namespace sky
+{
+namespace helper
+{
+// Read-only view of a whole file, the pages are loaded by the OS on first touch
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const fs::path &path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const uint8_t *data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+  private:
+    const uint8_t *m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+}
+}
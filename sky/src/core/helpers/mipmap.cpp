@@ -0,0 +1,162 @@
+#include "mipmap.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKY_MIPMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sky
+{
+namespace helper
+{
+namespace
+{
+constexpr size_t SRGB_ENCODE_TABLE_SIZE = 4096;
+
+struct SrgbTables
+{
+    std::array<float, 256> toLinear;
+    std::array<uint8_t, SRGB_ENCODE_TABLE_SIZE> fromLinear;
+
+    SrgbTables()
+    {
+        for (size_t i = 0; i < toLinear.size(); ++i)
+        {
+            const float c = i / 255.f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (size_t i = 0; i < fromLinear.size(); ++i)
+        {
+            const float l = float(i) / (SRGB_ENCODE_TABLE_SIZE - 1);
+            const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+            fromLinear[i] = static_cast<uint8_t>(std::clamp(c * 255.f + 0.5f, 0.f, 255.f));
+        }
+    }
+
+    uint8_t encode(float linear) const
+    {
+        const float index = std::clamp(linear, 0.f, 1.f) * (SRGB_ENCODE_TABLE_SIZE - 1) + 0.5f;
+        return fromLinear[static_cast<size_t>(index)];
+    }
+};
+
+const SrgbTables &getSrgbTables()
+{
+    static const SrgbTables s_tables;
+    return s_tables;
+}
+
+// row1 is row0 again when the source is a single row high, odd columns repeat the last one
+void downsampleRow(const uint8_t *row0, const uint8_t *row1, uint32_t srcWidth, uint8_t *dst, uint32_t dstWidth)
+{
+    uint32_t x = 0;
+#ifdef SKY_MIPMAP_SSE2
+    // two output pixels from four source pixels of each row
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(2);
+    for (; x + 2 <= dstWidth && 2 * x + 4 <= srcWidth; x += 2)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row0 + x * 8));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row1 + x * 8));
+
+        // the two rows summed per channel, source pixels 0-1 in lo and 2-3 in hi
+        const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+        // then the horizontal neighbours, each sum lands in the low half
+        const __m128i left = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        const __m128i right = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+        const __m128i sum = _mm_unpacklo_epi64(left, right);
+        const __m128i average = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + x * 4), _mm_packus_epi16(average, zero));
+    }
+#endif
+    for (; x < dstWidth; ++x)
+    {
+        const uint32_t x0 = std::min(2 * x, srcWidth - 1) * 4;
+        const uint32_t x1 = std::min(2 * x + 1, srcWidth - 1) * 4;
+        for (uint32_t c = 0; c < 4; ++c)
+            dst[x * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+    }
+}
+
+// averaging encoded values darkens every level, decode, average and encode again
+void downsampleRowSrgb(const uint8_t *row0, const uint8_t *row1, uint32_t srcWidth, uint8_t *dst, uint32_t dstWidth)
+{
+    const auto &tables = getSrgbTables();
+    const auto &lut = tables.toLinear;
+
+    for (uint32_t x = 0; x < dstWidth; ++x)
+    {
+        const uint8_t *p[4] = {
+            row0 + std::min(2 * x, srcWidth - 1) * 4,
+            row0 + std::min(2 * x + 1, srcWidth - 1) * 4,
+            row1 + std::min(2 * x, srcWidth - 1) * 4,
+            row1 + std::min(2 * x + 1, srcWidth - 1) * 4,
+        };
+
+        alignas(16) float average[4];
+#ifdef SKY_MIPMAP_SSE2
+        __m128 sum = _mm_setzero_ps();
+        for (const auto *px : p)
+            sum = _mm_add_ps(sum, _mm_set_ps(px[3] * (1.f / 255.f), lut[px[2]], lut[px[1]], lut[px[0]]));
+        _mm_store_ps(average, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+        for (uint32_t c = 0; c < 3; ++c) average[c] = (lut[p[0][c]] + lut[p[1][c]] + lut[p[2][c]] + lut[p[3][c]]) * 0.25f;
+        average[3] = (p[0][3] + p[1][3] + p[2][3] + p[3][3]) * (0.25f / 255.f);
+#endif
+        dst[x * 4 + 0] = tables.encode(average[0]);
+        dst[x * 4 + 1] = tables.encode(average[1]);
+        dst[x * 4 + 2] = tables.encode(average[2]);
+        dst[x * 4 + 3] = static_cast<uint8_t>(average[3] * 255.f + 0.5f);
+    }
+}
+} // namespace
+
+uint32_t getMipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    for (auto size = std::max(width, height); size > 1; size /= 2) ++levels;
+    return levels;
+}
+
+std::vector<uint8_t> generateMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, bool srgb,
+    std::vector<gfx::ImageMipLevel> &levels)
+{
+    levels.clear();
+    if (!pixels || width == 0 || height == 0) return {};
+
+    uint64_t total = 0;
+    for (uint32_t w = width, h = height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2))
+    {
+        const uint64_t size = uint64_t(w) * h * 4;
+        levels.push_back({w, h, total, size});
+        total += size;
+        if (w == 1 && h == 1) break;
+    }
+
+    std::vector<uint8_t> chain(total);
+    std::memcpy(chain.data(), pixels, levels[0].size);
+
+    const auto downsample = srgb ? downsampleRowSrgb : downsampleRow;
+    for (size_t i = 1; i < levels.size(); ++i)
+    {
+        const auto &src = levels[i - 1];
+        const auto &dst = levels[i];
+        const uint8_t *srcData = chain.data() + src.offset;
+        uint8_t *dstData = chain.data() + dst.offset;
+
+        for (uint32_t y = 0; y < dst.height; ++y)
+        {
+            const uint8_t *row0 = srcData + uint64_t(std::min(2 * y, src.height - 1)) * src.width * 4;
+            const uint8_t *row1 = srcData + uint64_t(std::min(2 * y + 1, src.height - 1)) * src.width * 4;
+            downsample(row0, row1, src.width, dstData + uint64_t(y) * dst.width * 4, dst.width);
+        }
+    }
+    return chain;
+}
+}
+}
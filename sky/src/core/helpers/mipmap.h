@@ -0,0 +1,19 @@
+#pragma once
+
+#include <skypch.h>
+#include "graphics/vulkan/vk_types.h"
+
+namespace sky
+{
+namespace helper
+{
+// Levels down to 1x1
+uint32_t getMipLevelCount(uint32_t width, uint32_t height);
+
+// Builds the full mip chain of an RGBA8 image with a 2x2 box filter. sRGB images are averaged in
+// linear space, alpha is always linear. Returns level 0 followed by every smaller level, levels
+// receives where each of them starts.
+std::vector<uint8_t> generateMipChain(const uint8_t *pixels, uint32_t width, uint32_t height, bool srgb,
+    std::vector<gfx::ImageMipLevel> &levels);
+}
+}
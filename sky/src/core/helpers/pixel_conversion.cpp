@@ -0,0 +1,294 @@
+#include "pixel_conversion.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKY_PIXEL_SSE2
+#include <emmintrin.h>
+#endif
+// byte shuffles need SSSE3, only there when the build targets it (-mssse3, /arch:AVX)
+#if defined(__SSSE3__) || defined(__AVX__)
+#define SKY_PIXEL_SSSE3
+#include <tmmintrin.h>
+#endif
+
+namespace sky
+{
+namespace helper
+{
+namespace
+{
+void grayToRGBA(const uint8_t *src, size_t count, uint8_t *dst)
+{
+    size_t i = 0;
+#ifdef SKY_PIXEL_SSE2
+    const __m128i opaque = _mm_set1_epi8(static_cast<char>(0xFF));
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        // gray gray pairs and gray 255 pairs, interleaved again they are gray gray gray 255
+        const __m128i grayLo = _mm_unpacklo_epi8(gray, gray), grayHi = _mm_unpackhi_epi8(gray, gray);
+        const __m128i alphaLo = _mm_unpacklo_epi8(gray, opaque), alphaHi = _mm_unpackhi_epi8(gray, opaque);
+
+        auto *out = reinterpret_cast<__m128i *>(dst + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(grayLo, alphaLo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(grayLo, alphaLo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(grayHi, alphaHi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(grayHi, alphaHi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i * 4 + 0] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+void grayAlphaToRGBA(const uint8_t *src, size_t count, uint8_t *dst)
+{
+    size_t i = 0;
+#ifdef SKY_PIXEL_SSE2
+    const __m128i lowByte = _mm_set1_epi16(0x00FF);
+    for (; i + 8 <= count; i += 8)
+    {
+        // one pixel per 16 bit lane, gray in the low byte
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        const __m128i gray = _mm_and_si128(pixels, lowByte);
+        const __m128i grayGray = _mm_or_si128(gray, _mm_slli_epi16(gray, 8));
+
+        auto *out = reinterpret_cast<__m128i *>(dst + i * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(grayGray, pixels));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(grayGray, pixels));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i * 4 + 0] = dst[i * 4 + 1] = dst[i * 4 + 2] = src[i * 2];
+        dst[i * 4 + 3] = src[i * 2 + 1];
+    }
+}
+
+void rgbToRGBA(const uint8_t *src, size_t count, uint8_t *dst)
+{
+    size_t i = 0;
+#ifdef SKY_PIXEL_SSSE3
+    // four pixels per 16 byte load, which reads 4 bytes ahead so the last pixels go the scalar way
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    for (; i + 6 <= count; i += 4)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),
+            _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), opaque));
+    }
+#endif
+    // one 4 byte load per pixel, except for the last which would read past the end
+    for (; i + 1 < count; ++i)
+    {
+        uint32_t pixel;
+        std::memcpy(&pixel, src + i * 3, sizeof(pixel));
+        pixel |= 0xFF000000u; // little endian, alpha is the top byte
+        std::memcpy(dst + i * 4, &pixel, sizeof(pixel));
+    }
+    for (; i < count; ++i)
+    {
+        std::memcpy(dst + i * 4, src + i * 3, 3);
+        dst[i * 4 + 3] = 255;
+    }
+}
+// from Fabian Giesen's float_to_half_fast3_rtne
+uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t half;
+    if (bits >= 0x47800000u) half = bits > 0x7F800000u ? 0x7E00 : 0x7C00; // NaN or too large
+    else if (bits < 0x38800000u)
+    {
+        // subnormal, the float add does the rounding
+        const uint32_t magicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+        float magic, sum;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+        std::memcpy(&sum, &bits, sizeof(sum));
+        sum += magic;
+        std::memcpy(&half, &sum, sizeof(half));
+        half -= magicBits;
+    }
+    else
+    {
+        const uint32_t mantissaOdd = bits >> 13 & 1;
+        half = (bits - ((127 - 15) << 23) + 0xFFF + mantissaOdd) >> 13;
+    }
+    return uint16_t(half | sign >> 16);
+}
+
+// from Fabian Giesen's half_to_float_fast5
+float halfToFloat(uint16_t half)
+{
+    constexpr uint32_t shiftedExponent = 0x7C00u << 13;
+    uint32_t bits = (half & 0x7FFFu) << 13;
+    const uint32_t exponent = bits & shiftedExponent;
+    bits += (127 - 15) << 23;
+
+    if (exponent == shiftedExponent) bits += (128 - 16) << 23; // infinity or NaN
+    else if (exponent == 0)
+    {
+        // subnormal, renormalized by the float subtract
+        const uint32_t magicBits = 113u << 23;
+        float magic, value;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+        bits += 1 << 23;
+        std::memcpy(&value, &bits, sizeof(value));
+        value -= magic;
+        std::memcpy(&bits, &value, sizeof(bits));
+    }
+    bits |= uint32_t(half & 0x8000u) << 16;
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+constexpr float RGB9E5_MAX = 511.f / 512.f * 65536.f;
+
+uint32_t floatToRGB9E5(const float *rgb)
+{
+    float channels[3];
+    for (uint32_t c = 0; c < 3; ++c) channels[c] = rgb[c] > 0.f ? std::min(rgb[c], RGB9E5_MAX) : 0.f; // NaN too
+    const float largest = std::max({channels[0], channels[1], channels[2]});
+
+    // the shared exponent puts the largest channel's top bit at the top of its 9 bit mantissa
+    int largestExponent = 0; // largest is in [0.5, 1) * 2^largestExponent
+    std::frexp(largest, &largestExponent);
+    int exponent = std::max(-16, largest > 0.f ? largestExponent - 1 : -16) + 16;
+    if (uint32_t(std::ldexp(largest, 24 - exponent) + 0.5f) == 512) ++exponent;
+
+    uint32_t packed = uint32_t(exponent) << 27;
+    for (uint32_t c = 0; c < 3; ++c) packed |= uint32_t(std::ldexp(channels[c], 24 - exponent) + 0.5f) << (9 * c);
+    return packed;
+}
+
+#ifdef SKY_PIXEL_SSE2
+__m128i blend(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// four at a time, same steps as floatToHalf, the halves end up in the low 16 bits of each lane
+__m128i floatToHalf(__m128 value)
+{
+    const __m128i signMask = _mm_set1_epi32(int(0x80000000u));
+    const __m128i halfOverflow = _mm_set1_epi32(0x47800000);
+    const __m128i minNormal = _mm_set1_epi32(0x38800000);
+    const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i sign = _mm_and_si128(bits, signMask);
+    const __m128i absolute = _mm_xor_si128(bits, sign);
+    const __m128 absoluteFloat = _mm_castsi128_ps(absolute);
+
+    const __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absoluteFloat, absoluteFloat));
+    const __m128i special = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNaN, _mm_set1_epi32(0x200)));
+
+    const __m128i subnormal = _mm_sub_epi32(
+        _mm_castps_si128(_mm_add_ps(absoluteFloat, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+    const __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absolute, 31 - 13), 31); // -1 when odd
+    const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absolute, normalBias), mantissaOdd), 13);
+
+    __m128i half = blend(_mm_cmpgt_epi32(minNormal, absolute), subnormal, normal);
+    half = blend(_mm_cmpgt_epi32(halfOverflow, absolute), half, special);
+    return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+}
+
+// four pixels given as separate channel vectors, same steps as floatToRGB9E5
+__m128i floatToRGB9E5(__m128 r, __m128 g, __m128 b)
+{
+    const __m128 zero = _mm_setzero_ps(), largestValue = _mm_set1_ps(RGB9E5_MAX), half = _mm_set1_ps(0.5f);
+    // max returns the second operand when the first is NaN
+    r = _mm_min_ps(_mm_max_ps(r, zero), largestValue);
+    g = _mm_min_ps(_mm_max_ps(g, zero), largestValue);
+    b = _mm_min_ps(_mm_max_ps(b, zero), largestValue);
+    const __m128 largest = _mm_max_ps(r, _mm_max_ps(g, b));
+
+    // floor(log2) is the biased float exponent, zero and denormals are below the -16 clamp anyway
+    __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(largest), 23), _mm_set1_epi32(127 - 16));
+    exponent = blend(_mm_cmpgt_epi32(exponent, _mm_setzero_si128()), exponent, _mm_setzero_si128());
+
+    // 2^(24 - exponent) built from its bits
+    const auto scaleFor = [](__m128i e)
+    { return _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_set1_epi32(127 + 24), e), 23)); };
+    const __m128i rounded = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(largest, scaleFor(exponent)), half));
+    exponent = _mm_sub_epi32(exponent, _mm_cmpeq_epi32(rounded, _mm_set1_epi32(512)));
+    const __m128 scale = scaleFor(exponent);
+
+    const __m128i red = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, scale), half));
+    const __m128i green = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, scale), half));
+    const __m128i blue = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), half));
+    return _mm_or_si128(_mm_or_si128(red, _mm_slli_epi32(green, 9)),
+        _mm_or_si128(_mm_slli_epi32(blue, 18), _mm_slli_epi32(exponent, 27)));
+}
+#endif
+} // namespace
+
+void convertToRGBA8(const uint8_t *src, uint32_t channels, size_t count, uint8_t *dst)
+{
+    switch (channels)
+    {
+    case 1: grayToRGBA(src, count, dst); break;
+    case 2: grayAlphaToRGBA(src, count, dst); break;
+    case 3: rgbToRGBA(src, count, dst); break;
+    default: std::memcpy(dst, src, count * 4); break;
+    }
+}
+
+void convertToHalf(const float *src, size_t count, uint16_t *dst)
+{
+    size_t i = 0;
+#ifdef SKY_PIXEL_SSE2
+    for (; i + 8 <= count; i += 8)
+    {
+        // sign extended so the signed saturating pack keeps the 16 bits as they are
+        const __m128i lo = _mm_srai_epi32(_mm_slli_epi32(floatToHalf(_mm_loadu_ps(src + i)), 16), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_slli_epi32(floatToHalf(_mm_loadu_ps(src + i + 4)), 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < count; ++i) dst[i] = floatToHalf(src[i]);
+}
+
+void convertToRGB9E5(const float *src, size_t count, uint32_t *dst)
+{
+    size_t i = 0;
+#ifdef SKY_PIXEL_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 r = _mm_loadu_ps(src + i * 4), g = _mm_loadu_ps(src + i * 4 + 4);
+        __m128 b = _mm_loadu_ps(src + i * 4 + 8), a = _mm_loadu_ps(src + i * 4 + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), floatToRGB9E5(r, g, b));
+    }
+#endif
+    for (; i < count; ++i) dst[i] = floatToRGB9E5(src + i * 4);
+}
+void convertFromHalf(const uint16_t *src, size_t count, float *dst)
+{
+    for (size_t i = 0; i < count; ++i) dst[i] = halfToFloat(src[i]);
+}
+
+void convertFromRGB9E5(const uint32_t *src, size_t count, float *dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        // the mantissas have no implicit one, 2^(exponent - 15 - 9) scales them
+        const float scale = std::ldexp(1.f, int(src[i] >> 27) - 24);
+        for (uint32_t c = 0; c < 3; ++c) dst[i * 4 + c] = float(src[i] >> (9 * c) & 0x1FF) * scale;
+        dst[i * 4 + 3] = 1.f;
+    }
+}
+}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <skypch.h>
+
+namespace sky
+{
+namespace helper
+{
+// Expands count pixels of 1 (gray), 2 (gray alpha), 3 (RGB) or 4 channels to RGBA8. Missing alpha is
+// opaque, gray is copied to every color channel.
+void convertToRGBA8(const uint8_t *src, uint32_t channels, size_t count, uint8_t *dst);
+
+// Converts count floats to half floats, rounded to nearest even. Too large values become infinity.
+void convertToHalf(const float *src, size_t count, uint16_t *dst);
+// Packs count RGBA float pixels to E5B9G9R9 (VK_FORMAT_E5B9G9R9_UFLOAT_PACK32). Alpha is dropped, negative
+// and NaN channels become 0.
+void convertToRGB9E5(const float *src, size_t count, uint32_t *dst);
+
+// The inverses, for reading cooked pixels back on the CPU. RGB9E5 pixels become RGBA with an alpha of 1.
+void convertFromHalf(const uint16_t *src, size_t count, float *dst);
+void convertFromRGB9E5(const uint32_t *src, size_t count, float *dst);
+}
+}
@@ -0,0 +1,201 @@
+#include "spherical_harmonics.h"
+
+#include <cmath>
+#include <numbers>
+#include <tracy/Tracy.hpp>
+
+#include "core/tasks/task_manager.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SKY_SH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sky
+{
+namespace math
+{
+namespace
+{
+// basis normalization
+constexpr float SH_Y0 = 0.282095f;  // 1/2 sqrt(1/pi)
+constexpr float SH_Y1 = 0.488603f;  // sqrt(3/(4pi))
+constexpr float SH_Y2 = 1.092548f;  // 1/2 sqrt(15/pi)
+constexpr float SH_Y20 = 0.315392f; // 1/4 sqrt(5/pi)
+constexpr float SH_Y22 = 0.546274f; // 1/4 sqrt(15/pi)
+
+// keeps an infinite texel from making every coefficient infinite
+constexpr float MAX_RADIANCE = 1e9f;
+
+// along a row the latitude is fixed, the basis splits into these functions of the longitude times
+// functions of the latitude
+enum LongitudeTerm
+{
+    One,
+    Sin,
+    Cos,
+    SinCos,
+    CosSquaredMinusSinSquared,
+    LongitudeTermCount
+};
+
+struct LongitudeTable
+{
+    std::vector<float> terms[LongitudeTermCount];
+};
+
+LongitudeTable buildLongitudeTable(uint32_t width)
+{
+    LongitudeTable table;
+    for (auto &term : table.terms) term.resize(width);
+    for (uint32_t x = 0; x < width; ++x)
+    {
+        const double phi = ((x + 0.5) / width - 0.5) * 2.0 * std::numbers::pi;
+        const double s = std::sin(phi), c = std::cos(phi);
+        table.terms[One][x] = 1.f;
+        table.terms[Sin][x] = float(s);
+        table.terms[Cos][x] = float(c);
+        table.terms[SinCos][x] = float(s * c);
+        table.terms[CosSquaredMinusSinSquared][x] = float(c * c - s * s);
+    }
+    return table;
+}
+
+float sanitize(float value)
+{
+    return value > 0.f ? std::min(value, MAX_RADIANCE) : 0.f; // NaN too
+}
+
+// sums[term][channel] of the row's colors times each longitude term
+void sumRow(const float *row, uint32_t width, const LongitudeTable &table, float (&sums)[LongitudeTermCount][3])
+{
+    uint32_t x = 0;
+#ifdef SKY_SH_SSE2
+    __m128 acc[LongitudeTermCount][3];
+    for (auto &term : acc)
+        for (auto &channel : term) channel = _mm_setzero_ps();
+
+    const __m128 zero = _mm_setzero_ps(), maxRadiance = _mm_set1_ps(MAX_RADIANCE);
+    for (; x + 4 <= width; x += 4)
+    {
+        __m128 r = _mm_loadu_ps(row + x * 4), g = _mm_loadu_ps(row + x * 4 + 4);
+        __m128 b = _mm_loadu_ps(row + x * 4 + 8), a = _mm_loadu_ps(row + x * 4 + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        // max returns the second operand when the first is NaN
+        const __m128 channels[3] = {
+            _mm_min_ps(_mm_max_ps(r, zero), maxRadiance),
+            _mm_min_ps(_mm_max_ps(g, zero), maxRadiance),
+            _mm_min_ps(_mm_max_ps(b, zero), maxRadiance),
+        };
+
+        for (uint32_t t = 0; t < LongitudeTermCount; ++t)
+        {
+            const __m128 term = _mm_loadu_ps(table.terms[t].data() + x);
+            for (uint32_t c = 0; c < 3; ++c) acc[t][c] = _mm_add_ps(acc[t][c], _mm_mul_ps(channels[c], term));
+        }
+    }
+
+    for (uint32_t t = 0; t < LongitudeTermCount; ++t)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, acc[t][c]);
+            sums[t][c] = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+    }
+#else
+    for (auto &term : sums)
+        for (auto &channel : term) channel = 0.f;
+#endif
+    for (; x < width; ++x)
+    {
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            const float value = sanitize(row[x * 4 + c]);
+            for (uint32_t t = 0; t < LongitudeTermCount; ++t) sums[t][c] += value * table.terms[t][x];
+        }
+    }
+}
+} // namespace
+
+SH9Color projectEquirectToSH9(std::span<const float> pixels, uint32_t width, uint32_t height,
+    TaskManager *taskManager)
+{
+    ZoneScopedN("Project SH9");
+    assert(pixels.size() >= size_t(width) * height * 4);
+    SH9Color sh{};
+    if (width == 0 || height == 0) return sh;
+
+    const auto table = buildLongitudeTable(width);
+    std::vector<SH9Color> rows(height);
+
+    const auto project = [&](size_t y)
+    {
+        float sums[LongitudeTermCount][3];
+        sumRow(pixels.data() + y * width * 4, width, table, sums);
+
+        // row 0 is at the bottom, asin(y) maps to v in equirect_to_cubemap.frag
+        const double latitude = ((y + 0.5) / height - 0.5) * std::numbers::pi;
+        const float sinLat = float(std::sin(latitude)), cosLat = float(std::cos(latitude));
+        const float basis[9] = {
+            SH_Y0,
+            SH_Y1 * sinLat,
+            SH_Y1 * cosLat,
+            SH_Y1 * cosLat,
+            SH_Y2 * cosLat * sinLat,
+            SH_Y2 * sinLat * cosLat,
+            SH_Y20 * (3.f * sinLat * sinLat - 1.f),
+            SH_Y2 * cosLat * cosLat,
+            SH_Y22 * cosLat * cosLat,
+        };
+        constexpr LongitudeTerm terms[9] = {One, One, Sin, Cos, Cos, Sin, One, SinCos, CosSquaredMinusSinSquared};
+
+        // the solid angle of a texel shrinks with cos of the latitude
+        for (uint32_t i = 0; i < 9; ++i)
+        {
+            const float *sum = sums[terms[i]];
+            rows[y][i] = glm::vec3(sum[0], sum[1], sum[2]) * (basis[i] * cosLat);
+        }
+    };
+
+    if (taskManager) taskManager->parallelFor(0, height, project);
+    else
+        for (size_t y = 0; y < height; ++y) project(y);
+
+    // summed in order so the result does not depend on the scheduling
+    double totals[9][3] = {};
+    double weight = 0.0;
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t i = 0; i < 9; ++i)
+            for (uint32_t c = 0; c < 3; ++c) totals[i][c] += rows[y][i][c];
+        weight += std::cos(((y + 0.5) / height - 0.5) * std::numbers::pi) * width;
+    }
+
+    // the texel solid angles, normalized so they add up to the sphere's 4pi
+    const double texelSolidAngle = 4.0 * std::numbers::pi / weight;
+    for (uint32_t i = 0; i < 9; ++i)
+        for (uint32_t c = 0; c < 3; ++c) sh[i][c] = float(totals[i][c] * texelSolidAngle);
+    return sh;
+}
+
+SH9Color convolveIrradianceSH9(const SH9Color &radiance)
+{
+    // the cosine lobe's bands are pi, 2pi/3 and pi/4, divided by pi
+    constexpr float bands[9] = {1.f, 2.f / 3.f, 2.f / 3.f, 2.f / 3.f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f};
+    SH9Color irradiance;
+    for (uint32_t i = 0; i < 9; ++i) irradiance[i] = radiance[i] * bands[i];
+    return irradiance;
+}
+
+glm::vec3 evaluateSH9(const SH9Color &sh, const glm::vec3 &direction)
+{
+    const float x = direction.x, y = direction.y, z = direction.z;
+    return sh[0] * SH_Y0 +
+        sh[1] * (SH_Y1 * y) + sh[2] * (SH_Y1 * z) + sh[3] * (SH_Y1 * x) +
+        sh[4] * (SH_Y2 * x * y) + sh[5] * (SH_Y2 * y * z) + sh[6] * (SH_Y20 * (3.f * y * y - 1.f)) +
+        sh[7] * (SH_Y2 * x * z) + sh[8] * (SH_Y22 * (x * x - z * z));
+}
+} // namespace math
+} // namespace sky
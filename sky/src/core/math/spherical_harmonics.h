@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <skypch.h>
+
+namespace sky
+{
+class TaskManager;
+
+namespace math
+{
+// RGB coefficients of the first three spherical harmonics bands, in the order 1, y, z, x, xy, yz, 3y^2 - 1,
+// xz, x^2 - z^2. +y is up, as in the engine.
+using SH9Color = std::array<glm::vec3, 9>;
+
+// Projects an equirectangular RGBA float image onto SH9, directions map to pixels as in
+// equirect_to_cubemap.frag. Negative and NaN values count as 0. Rows are summed on the task pool when one
+// is given.
+SH9Color projectEquirectToSH9(std::span<const float> pixels, uint32_t width, uint32_t height,
+    TaskManager *taskManager = nullptr);
+
+// Convolves radiance with the clamped cosine lobe and divides by pi. Evaluated at a normal the result is
+// what the diffuse term multiplies the albedo with, as the irradiance cubemap gave it.
+SH9Color convolveIrradianceSH9(const SH9Color &radiance);
+
+// Same as shIrradiance in pbr.glsl
+glm::vec3 evaluateSH9(const SH9Color &sh, const glm::vec3 &direction);
+} // namespace math
+} // namespace sky
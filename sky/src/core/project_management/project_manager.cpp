@@ -6,6 +6,7 @@
 #include "scene/scene_manager.h"
 #include "core/events/event_bus.h"
 #include "asset_management/asset_manager.h"
+#include "asset_management/runtime_asset_manager.h"
 
 namespace sky
 {
@@ -16,6 +17,7 @@ void ProjectManager::createNewProject(ProjectConfig config)
     fs::create_directory(config.getProjectFilePath() / config.assetPath);
     fs::create_directories(config.getImportedCachePath()); //? if error
     fs::create_directories(config.getThumbnailCachePath());
+    fs::create_directories(config.getIblCachePath());
 
     serialize(config);
 
@@ -41,7 +43,11 @@ void ProjectManager::loadProject(const fs::path &path)
     EditorEventBus::get().pushEvent({EditorEventType::Reset});
 
     deserialize(path);
-    if (fs::exists(m_config.getAssetRegistryPath())) m_assetManager->deserializeAssetRegistry();
+    if (fs::exists(m_config.getAssetRegistryCachePath()) || fs::exists(m_config.getAssetRegistryJournalPath()) ||
+        fs::exists(m_config.getAssetRegistryPath()))
+        m_assetManager->deserializeAssetRegistry();
+    editorAssetManager->startBackgroundImport();
+    editorAssetManager->startHotReload();
 
     // push to project list if not found
     auto currentProject = ProjectInfo{
@@ -69,6 +75,23 @@ void ProjectManager::loadProject(const fs::path &path)
     if (!m_config.startScene.empty()) SceneManager::get().openScene(m_config.startScene);
 }
 
+void ProjectManager::loadPackedProject(const fs::path &path)
+{
+    if (m_assetManager) AssetManager::unloadAllAssets();
+    SceneManager::get().reset();
+
+    m_assetManager = CreateRef<RuntimeAssetManager>();
+    deserialize(path);
+    if (!m_assetManager->deserializeAssetRegistry())
+    {
+        SKY_CORE_ERROR("Failed to open the asset pack of {}", m_config.projectName);
+        return;
+    }
+    m_isProjectOpen = true;
+
+    if (!m_config.startScene.empty()) SceneManager::get().openScene(m_config.startScene);
+}
+
 void ProjectManager::saveProject() 
 {
     serialize(m_config);
@@ -87,7 +110,7 @@ std::string ProjectManager::getProjectFullName()
 
 Ref<EditorAssetManager> ProjectManager::getEditorAssetManager()
 {
-    return std::static_pointer_cast<EditorAssetManager>(m_assetManager);
+    return std::dynamic_pointer_cast<EditorAssetManager>(m_assetManager);
 }
 
 void ProjectManager::serialize(ProjectConfig config) 
@@ -102,6 +125,9 @@ void ProjectManager::serialize(ProjectConfig config)
         out << YAML::Key << "lastModifiedDate" << YAML::Value << config.lastModifiedDate;
         out << YAML::Key << "assetPath" << YAML::Value << config.assetPath.string();
         out << YAML::Key << "startScene" << YAML::Value << config.startScene.string();
+        out << YAML::Key << "textureCompression" << YAML::Value << helper::toString(config.textureCompression);
+        out << YAML::Key << "hdrStorage" << YAML::Value << helper::toString(config.hdrStorage);
+        out << YAML::Key << "textureStreamingBudget" << YAML::Value << config.textureStreamingBudget;
         out << YAML::EndMap;
     }
 
@@ -124,6 +150,12 @@ void ProjectManager::deserialize(const fs::path &path)
         m_config.lastModifiedDate = data["lastModifiedDate"].as<std::string>();
         m_config.assetPath = data["assetPath"].as<std::string>();
         m_config.startScene = data["startScene"].as<std::string>();
+        if (data["textureCompression"])
+            m_config.textureCompression =
+                helper::parseBlockCompressionQuality(data["textureCompression"].as<std::string>());
+        if (data["hdrStorage"]) m_config.hdrStorage = helper::parseHdrStorage(data["hdrStorage"].as<std::string>());
+        if (data["textureStreamingBudget"])
+            m_config.textureStreamingBudget = data["textureStreamingBudget"].as<uint32_t>();
     }
     catch (YAML::ParserException e)
     {
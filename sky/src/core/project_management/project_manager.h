@@ -3,6 +3,7 @@
 #include <skypch.h>
 #include "core/filesystem.h"
 #include "asset_management/editor_asset_manager.h"
+#include "core/helpers/block_compression.h"
 
 namespace sky
 {
@@ -18,6 +19,12 @@ class ProjectManager
         std::string lastModifiedDate;
         fs::path assetPath;
         fs::path startScene;
+        // how hard cooking compresses textures, changing it cooks every texture again
+        helper::BlockCompressionQuality textureCompression = helper::BlockCompressionQuality::Normal;
+        // how cooking stores HDR environments, also cooks them again when changed
+        helper::HdrStorage hdrStorage = helper::HdrStorage::SharedExponent;
+        // megabytes of streamed texture mips kept on the GPU, the highest levels of distant ones go above it
+        uint32_t textureStreamingBudget = 512;
 
         ProjectConfig() :
             projectName("untitled"),
@@ -29,9 +36,13 @@ class ProjectManager
         fs::path getProjectFilePath() const { return projectPath / projectName; }
         fs::path getProjectConfigFilePath() const { return getProjectFilePath() / (projectName + ".skyproj"); }
         fs::path getAssetRegistryPath() const { return getProjectFilePath() / assetPath / "assetRegistry.yaml"; }
+        fs::path getAssetRegistryCachePath() const { return getProjectFilePath() / ".sky/assetRegistry.bin"; }
+        fs::path getAssetRegistryJournalPath() const { return getProjectFilePath() / ".sky/assetRegistry.journal"; }
         fs::path getAssetDirectory() const { return getProjectFilePath() / assetPath; }
         fs::path getImportedCachePath() const { return getProjectFilePath() / ".sky/imported"; }
         fs::path getThumbnailCachePath() const { return getProjectFilePath() / ".sky/thumbnails"; }
+        fs::path getIblCachePath() const { return getProjectFilePath() / ".sky/ibl"; }
+        fs::path getAssetPackPath() const { return getProjectFilePath() / (projectName + ".skypak"); }
     };
 
     struct ProjectInfo
@@ -48,6 +59,8 @@ class ProjectManager
   public:
     static void createNewProject(ProjectConfig config);
     static void loadProject(const fs::path &path);
+    // Shipping builds, every asset comes from the project's asset pack
+    static void loadPackedProject(const fs::path &path);
     static void saveProject();
     static void deserializeProjectsList();
     static void removeProjectFromList(ProjectInfo info);
@@ -58,6 +71,8 @@ class ProjectManager
     static bool isProjectOpen() { return m_isProjectOpen; }
     static bool isProjectListEmpty() { return m_projectsList.size() < 0; }
     static std::string getProjectFullName();
+    static Ref<AssetManagerBase> getAssetManager() { return m_assetManager; }
+    // nullptr when a packed project is open
     static Ref<EditorAssetManager> getEditorAssetManager();
 
   private:
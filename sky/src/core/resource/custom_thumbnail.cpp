@@ -73,7 +73,7 @@ void CustomThumbnail::render(gfx::CommandBuffer cmd)
                 if (materialAsset) {
                     m_readyMaterials.push_back({path, materialAsset->material});
                 }
-            });
+            }, TaskPriority::Background);
             break;
         }
         case AssetType::Mesh:
@@ -83,7 +83,7 @@ void CustomThumbnail::render(gfx::CommandBuffer cmd)
                 if (model && !model->meshes.empty()) {
                     m_readyModels.push_back({path, model->meshes});
                 }
-            });
+            }, TaskPriority::Background);
             break;
         }
         case AssetType::Texture2D:
@@ -94,7 +94,7 @@ void CustomThumbnail::render(gfx::CommandBuffer cmd)
                     auto img = helper::loadImageFromTexture(texture, VK_FORMAT_R8G8B8A8_UNORM);
                     m_readyTextures.push_back({path, img});
                 }
-            });
+            }, TaskPriority::Background);
             break;
         }
         default: break;
@@ -243,7 +243,7 @@ void CustomThumbnail::generateSceneThumbnail(gfx::CommandBuffer cmd, const fs::p
         .mousePos = {0.f, 0.f},
 		.ambientColor = LinearColorNoAlpha::white(),
 		.ambientIntensity = 0.4f,
-        .irradianceMapId  = renderer->getIBL().getIrradianceMapId(),
+        .irradianceSH  = renderer->getIBL().getIrradianceSH(),
         .prefilterMapId  = renderer->getIBL().getPrefilterMapId(),
         .brdfLutId  = renderer->getIBL().getBrdfLutId(),
 		.lightsBuffer = lightCache.getBuffer().address,
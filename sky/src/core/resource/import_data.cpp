@@ -14,6 +14,10 @@ bool ImportDataSerializer::serialize(const std::filesystem::path &path)
     out << YAML::Key << "source" << YAML::Value << m_data.source.string();
     out << YAML::Key << "destination" << YAML::Value << m_data.destination.string();
     out << YAML::Key << "version" << YAML::Value << m_data.version;
+    out << YAML::Key << "settingsHash" << YAML::Value << m_data.settingsHash;
+    out << YAML::Key << "sourceHash" << YAML::Value << m_data.sourceHash;
+    out << YAML::Key << "sourceSize" << YAML::Value << m_data.sourceSize;
+    out << YAML::Key << "sourceTime" << YAML::Value << m_data.sourceTime;
     out << YAML::EndMap;
 
     std::ofstream fout(path);
@@ -37,6 +41,12 @@ bool ImportDataSerializer::deserialize(const std::filesystem::path &path)
     m_data.destination = data["destination"].as<std::string>();
     m_data.version = data["version"].as<std::string>();
 
+    // missing in files written before content hashing, those get cooked again
+    if (data["settingsHash"]) m_data.settingsHash = data["settingsHash"].as<uint64_t>();
+    if (data["sourceHash"]) m_data.sourceHash = data["sourceHash"].as<uint64_t>();
+    if (data["sourceSize"]) m_data.sourceSize = data["sourceSize"].as<uint64_t>();
+    if (data["sourceTime"]) m_data.sourceTime = data["sourceTime"].as<int64_t>();
+
     return true;
 }
 } // namespace sky
\ No newline at end of file
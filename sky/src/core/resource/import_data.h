@@ -13,7 +13,12 @@ struct ImportData
 	AssetType	type;
 	fs::path	source;
 	fs::path	destination;
-	std::string version;
+	std::string version;  // of the importer that cooked destination
+	uint64_t	settingsHash = 0;
+	// content hash of the source, size and write time tell whether it has to be hashed again
+	uint64_t	sourceHash = 0;
+	uint64_t	sourceSize = 0;
+	int64_t		sourceTime = 0;
 };
 
 class ImportDataSerializer
@@ -37,7 +37,12 @@ Material MaterialSerializer::deserialize(const fs::path &path)
     std::stringstream strStream;
     strStream << stream.rdbuf();
 
-    YAML::Node data = YAML::Load(strStream.str());
+    return deserializeFromMemory(strStream.str());
+}
+
+Material MaterialSerializer::deserializeFromMemory(std::string_view source)
+{
+    YAML::Node data = YAML::Load(std::string(source));
     Material mat;
 
     if (data["name"])
@@ -67,17 +72,17 @@ Material MaterialSerializer::deserialize(const fs::path &path)
     if (data["emissiveTexture"]) mat.emissiveTextureHandle = data["emissiveTexture"].as<AssetHandle>();
 
     const auto &albedoTex = AssetManager::getAsset<Texture2D>(mat.albedoTextureHandle);
-    mat.albedoTexture = helper::loadImageFromTexture(albedoTex, VK_FORMAT_R8G8B8A8_SRGB);
+    mat.albedoTexture = helper::streamImageFromTexture(albedoTex, VK_FORMAT_R8G8B8A8_SRGB);
     const auto &normalTex = AssetManager::getAsset<Texture2D>(mat.normalMapTextureHandle);
-    mat.normalMapTexture = helper::loadImageFromTexture(normalTex, VK_FORMAT_R8G8B8A8_UNORM);
+    mat.normalMapTexture = helper::streamImageFromTexture(normalTex, VK_FORMAT_R8G8B8A8_UNORM);
     const auto &metallicTex = AssetManager::getAsset<Texture2D>(mat.metallicTextureHandle);
-    mat.metallicTexture = helper::loadImageFromTexture(metallicTex, VK_FORMAT_R8G8B8A8_UNORM);
+    mat.metallicTexture = helper::streamImageFromTexture(metallicTex, VK_FORMAT_R8G8B8A8_UNORM);
     const auto &roughnessTex = AssetManager::getAsset<Texture2D>(mat.roughnessTextureHandle);
-    mat.roughnessTexture = helper::loadImageFromTexture(roughnessTex, VK_FORMAT_R8G8B8A8_UNORM);
+    mat.roughnessTexture = helper::streamImageFromTexture(roughnessTex, VK_FORMAT_R8G8B8A8_UNORM);
     const auto &ambientOcclusionTex = AssetManager::getAsset<Texture2D>(mat.ambientOcclusionTextureHandle);
-    mat.ambientOcclusionTexture = helper::loadImageFromTexture(ambientOcclusionTex, VK_FORMAT_R8G8B8A8_UNORM);
+    mat.ambientOcclusionTexture = helper::streamImageFromTexture(ambientOcclusionTex, VK_FORMAT_R8G8B8A8_UNORM);
     const auto &emissiveTex = AssetManager::getAsset<Texture2D>(mat.emissiveTextureHandle);
-    mat.emissiveTexture = helper::loadImageFromTexture(emissiveTex, VK_FORMAT_R8G8B8A8_SRGB);
+    mat.emissiveTexture = helper::streamImageFromTexture(emissiveTex, VK_FORMAT_R8G8B8A8_SRGB);
 
     return mat;
 }
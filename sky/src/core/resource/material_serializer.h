@@ -11,5 +11,6 @@ class MaterialSerializer
   public:
 	bool serialize(const fs::path &path, const Material &mat);
 	Material deserialize(const fs::path &path);
+	Material deserializeFromMemory(std::string_view source);
 };
 }
\ No newline at end of file
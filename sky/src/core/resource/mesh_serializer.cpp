@@ -1,9 +1,14 @@
 #include "mesh_serializer.h"
 
+#include <cstring>
+#include <tracy/Tracy.hpp>
+
 #include "core/application.h"
 #include "renderer/texture.h"
+#include "asset_management/asset_cache.h"
 #include "asset_management/asset_manager.h"
 #include "core/helpers/image.h"
+#include "core/tasks/task_manager.h"
 
 namespace sky
 {
@@ -18,7 +23,7 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
         auto textureHandle = AssetManager::getOrCreateAssetHandle(materialPaths.albedoTexture, AssetType::Texture2D);
         AssetManager::addToDependencyList(handle, textureHandle);
         auto tex = AssetManager::getAsset<Texture2D>(textureHandle);
-        material.albedoTexture = helper::loadImageFromTexture(tex, VK_FORMAT_R8G8B8A8_SRGB);
+        material.albedoTexture = helper::streamImageFromTexture(tex, VK_FORMAT_R8G8B8A8_SRGB);
         material.albedoTextureHandle = textureHandle;
     }
 
@@ -27,7 +32,7 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
         auto textureHandle = AssetManager::getOrCreateAssetHandle(materialPaths.normalMapTexture, AssetType::Texture2D);
         AssetManager::addToDependencyList(handle, textureHandle);
         auto tex = AssetManager::getAsset<Texture2D>(textureHandle);
-        material.normalMapTexture = helper::loadImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
+        material.normalMapTexture = helper::streamImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
         material.normalMapTextureHandle = textureHandle;
     }
 
@@ -36,7 +41,7 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
         auto textureHandle = AssetManager::getOrCreateAssetHandle(materialPaths.metallicsTexture, AssetType::Texture2D);
         AssetManager::addToDependencyList(handle, textureHandle);
         auto tex = AssetManager::getAsset<Texture2D>(textureHandle);
-        material.metallicTexture = helper::loadImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
+        material.metallicTexture = helper::streamImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
         material.metallicTextureHandle = textureHandle;
     }
 
@@ -45,7 +50,7 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
         auto textureHandle = AssetManager::getOrCreateAssetHandle(materialPaths.roughnessTexture, AssetType::Texture2D);
         AssetManager::addToDependencyList(handle, textureHandle);
         auto tex = AssetManager::getAsset<Texture2D>(textureHandle);
-        material.roughnessTexture = helper::loadImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
+        material.roughnessTexture = helper::streamImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
         material.roughnessTextureHandle = textureHandle;
     }
 
@@ -54,7 +59,7 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
         auto textureHandle = AssetManager::getOrCreateAssetHandle(materialPaths.ambientOcclusionTexture, AssetType::Texture2D);
         AssetManager::addToDependencyList(handle, textureHandle);
         auto tex = AssetManager::getAsset<Texture2D>(textureHandle);
-        material.ambientOcclusionTexture = helper::loadImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
+        material.ambientOcclusionTexture = helper::streamImageFromTexture(tex, VK_FORMAT_R8G8B8A8_UNORM);
         material.ambientOcclusionTextureHandle = textureHandle;
     }
 
@@ -63,7 +68,7 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
         auto textureHandle = AssetManager::getOrCreateAssetHandle(materialPaths.emissiveTexture, AssetType::Texture2D);
         AssetManager::addToDependencyList(handle, textureHandle);
         auto tex = AssetManager::getAsset<Texture2D>(textureHandle);
-        material.emissiveTexture = helper::loadImageFromTexture(tex, VK_FORMAT_R8G8B8A8_SRGB);
+        material.emissiveTexture = helper::streamImageFromTexture(tex, VK_FORMAT_R8G8B8A8_SRGB);
         material.emissiveTextureHandle = textureHandle;
     }
     material.name = name.empty() ? "Unnamed" : name;
@@ -71,6 +76,49 @@ static Material createMaterialFromPaths(MaterialPaths materialPaths,
     return material;
 }
 
+// Loads every texture of a model's materials side by side on the task pool. Each one is a decode, or
+// a whole cook when the background import has not got to it yet, and one after another they add up.
+static void prefetchTextures(const std::vector<MaterialPaths> &materials)
+{
+    std::vector<AssetHandle> handles;
+    std::unordered_set<AssetHandle> seen;
+    for (const auto &paths : materials)
+    {
+        for (const auto *path : {&paths.albedoTexture, &paths.normalMapTexture, &paths.metallicsTexture,
+                 &paths.roughnessTexture, &paths.ambientOcclusionTexture, &paths.emissiveTexture})
+        {
+            if (path->empty()) continue;
+
+            const auto textureHandle = AssetManager::getOrCreateAssetHandle(*path, AssetType::Texture2D);
+            if (textureHandle == NULL_UUID || AssetManager::isAssetLoaded(textureHandle)) continue;
+            if (seen.insert(textureHandle).second) handles.push_back(textureHandle);
+        }
+    }
+    if (handles.size() < 2) return;
+
+    ZoneScopedN("Prefetch material textures");
+    auto &taskManager = *Application::getTaskManager();
+
+    // decoded side by side as tasks, as children of the model's load for the cache's cycle checks
+    auto *parentLoad = AssetCache::getCurrentLoad();
+    std::vector<Ref<Task<Ref<Texture2D>>>> tasks;
+    tasks.reserve(handles.size());
+    for (const auto textureHandle : handles)
+    {
+        auto task = Task<Ref<Texture2D>>::create(TaskKey{TaskType::ImageLoad, textureHandle},
+            [textureHandle, parentLoad]
+            {
+                AssetCache::DependencyScope scope(parentLoad);
+                return AssetManager::getAsset<Texture2D>(textureHandle);
+            });
+        taskManager.submitTask(task, TaskPriority::Visible);
+        tasks.push_back(std::move(task));
+    }
+
+    // the ones no worker picked up yet are decoded right here
+    taskManager.join(tasks);
+}
+
 bool MeshSerializer::serialize(const fs::path &path, std::vector<MeshLoaderReturn> meshes) 
 {
     std::ofstream file(path, std::ios::binary);
@@ -154,106 +202,133 @@ bool MeshSerializer::serialize(const fs::path &path, std::vector<MeshLoaderRetur
     return true;
 }
 
-std::vector<Mesh> MeshSerializer::deserialize(const fs::path &path, AssetHandle handle) 
+namespace
 {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open())
+// Reads the cooked layout in place, a read past the end fails every read after it
+class BlobReader
+{
+  public:
+    explicit BlobReader(std::span<const uint8_t> data) : m_data(data) {}
+
+    std::span<const uint8_t> take(size_t size)
     {
-        SKY_CORE_ERROR("Failed to open mesh file: {0}", path.string());
-        return {};
+        if (!m_valid || m_data.size() - m_offset < size)
+        {
+            m_valid = false;
+            return {};
+        }
+        const auto bytes = m_data.subspan(m_offset, size);
+        m_offset += size;
+        return bytes;
     }
 
-    // Version
-    uint16_t version;
-    file.read(reinterpret_cast<char *>(&version), sizeof(uint16_t));
+    template <typename T> T read()
+    {
+        T value{};
+        if (const auto bytes = take(sizeof(T)); !bytes.empty()) std::memcpy(&value, bytes.data(), sizeof(T));
+        return value;
+    }
 
-    // Size
-    uint16_t size;
-    file.read(reinterpret_cast<char *>(&size), sizeof(uint16_t));
+    std::string readString()
+    {
+        const auto bytes = take(read<uint32_t>());
+        return std::string(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+    }
+
+    bool isValid() const { return m_valid; }
 
-    auto meshes = std::vector<Mesh>{};
-    for (uint16_t i = 0; i < size; i++)
+  private:
+    std::span<const uint8_t> m_data;
+    size_t m_offset = 0;
+    bool m_valid = true;
+};
+} // namespace
+
+std::vector<MeshDataView> MeshSerializer::deserialize(std::span<const uint8_t> data, AssetHandle handle)
+{
+    auto meshes = std::vector<MeshDataView>{};
+    for (auto &[mesh, material] : deserializeWithMaterials(data, handle))
     {
-        // Name
-        uint32_t nameLength;
-        file.read(reinterpret_cast<char *>(&nameLength), sizeof(uint32_t));
-        std::string name(nameLength, '\0');
-        file.read(name.data(), nameLength);
+        mesh.material = Application::getRenderer()->addMaterialToCache(material);
+        meshes.push_back(std::move(mesh));
+    }
+    return meshes;
+}
 
-        // Vertex data
-        uint32_t vertexCount;
-        file.read(reinterpret_cast<char *>(&vertexCount), sizeof(uint32_t));
-        std::vector<Vertex> vertices(vertexCount);
-        file.read(reinterpret_cast<char *>(vertices.data()), sizeof(Vertex) * vertexCount);
+std::vector<DeserializedMesh> MeshSerializer::deserializeWithMaterials(std::span<const uint8_t> data,
+    AssetHandle handle)
+{
+    struct ParsedMesh
+    {
+        MeshDataView mesh;
+        std::string materialName;
+        MaterialPaths materialPaths;
+    };
 
-        // Index data
-        uint32_t indexCount;
-        file.read(reinterpret_cast<char *>(&indexCount), sizeof(uint32_t));
-        std::vector<uint32_t> indices(indexCount);
-        file.read(reinterpret_cast<char *>(indices.data()), sizeof(uint32_t) * indexCount);
+    BlobReader file(data);
 
-        // Material data
-        // Name
-        uint32_t materialNameLength;
-        file.read(reinterpret_cast<char *>(&materialNameLength), sizeof(uint32_t));
-        std::string materialName(materialNameLength, '\0');
-        file.read(materialName.data(), materialNameLength);
+    // Version
+    file.read<uint16_t>();
 
-        // Albedo
-        uint32_t albedoLength;
-        file.read(reinterpret_cast<char *>(&albedoLength), sizeof(uint32_t));
-        std::string albedo(albedoLength, '\0');
-        file.read(albedo.data(), albedoLength);
+    // Size
+    const auto size = file.read<uint16_t>();
 
-        // Normal
-        uint32_t normalLength;
-        file.read(reinterpret_cast<char *>(&normalLength), sizeof(uint32_t));
-        std::string normal(normalLength, '\0');
-        file.read(normal.data(), normalLength);
+    auto parsed = std::vector<ParsedMesh>{};
+    for (uint16_t i = 0; i < size && file.isValid(); i++)
+    {
+        // Name
+        auto name = file.readString();
 
-        // Metallic
-        uint32_t metallicLength;
-        file.read(reinterpret_cast<char *>(&metallicLength), sizeof(uint32_t));
-        std::string metallic(metallicLength, '\0');
-        file.read(metallic.data(), metallicLength);
+        // Vertex data, left where it is
+        const auto vertexCount = file.read<uint32_t>();
+        const auto vertices = file.take(size_t(vertexCount) * sizeof(Vertex));
 
-        // Roughness
-        uint32_t roughnessLength;
-        file.read(reinterpret_cast<char *>(&roughnessLength), sizeof(uint32_t));
-        std::string roughness(roughnessLength, '\0');
-        file.read(roughness.data(), roughnessLength);
+        // Index data
+        const auto indexCount = file.read<uint32_t>();
+        const auto indices = file.take(size_t(indexCount) * sizeof(uint32_t));
 
-        // AO
-        uint32_t aoLength;
-        file.read(reinterpret_cast<char *>(&aoLength), sizeof(uint32_t));
-        std::string ao(aoLength, '\0');
-        file.read(ao.data(), aoLength);
-
-		// Emissive
-        uint32_t emissiveLength;
-        file.read(reinterpret_cast<char *>(&emissiveLength), sizeof(uint32_t));
-        std::string emissive(emissiveLength, '\0');
-        file.read(emissive.data(), emissiveLength);
-
-        auto material = createMaterialFromPaths({
+        // Material data
+        auto materialName = file.readString();
+        auto albedo = file.readString();
+        auto normal = file.readString();
+        auto metallic = file.readString();
+        auto roughness = file.readString();
+        auto ao = file.readString();
+        auto emissive = file.readString();
+
+        auto mesh = MeshDataView{
+            .vertices = vertices,
+            .indices = indices,
+			.name = name.empty() ? "Unnamed" : name,
+        };
+        parsed.push_back({std::move(mesh), std::move(materialName), {
 			.albedoTexture = albedo,
 			.normalMapTexture = normal,
 			.metallicsTexture = metallic,
 			.roughnessTexture = roughness,
 			.ambientOcclusionTexture = ao,
 			.emissiveTexture = emissive,
-		}, handle, materialName);
-        auto materialId = Application::getRenderer()->addMaterialToCache(material);
+		}});
+    }
 
-        auto mesh = Mesh{
-            .vertices = vertices,
-            .indices = indices,
-            .material = materialId, 
-			.name = name.empty() ? "Unnamed" : name,
-        };
-        meshes.push_back(mesh);
+    if (!file.isValid())
+    {
+        SKY_CORE_ERROR("Mesh data is truncated");
+        return {};
     }
 
+    std::vector<MaterialPaths> materialPaths;
+    materialPaths.reserve(parsed.size());
+    for (const auto &entry : parsed) materialPaths.push_back(entry.materialPaths);
+    prefetchTextures(materialPaths);
+
+    // the textures are loaded by now, this only uploads them
+    auto meshes = std::vector<DeserializedMesh>{};
+    for (auto &[mesh, materialName, paths] : parsed)
+    {
+        auto material = createMaterialFromPaths(paths, handle, materialName);
+        meshes.push_back({std::move(mesh), std::move(material)});
+    }
     return meshes;
 }
-} // namespace sky
\ No newline at end of file
+} // namespace sky
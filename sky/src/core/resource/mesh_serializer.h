@@ -6,10 +6,21 @@
 
 namespace sky
 {
+struct DeserializedMesh
+{
+	MeshDataView	mesh;
+	Material		material;
+};
+
 class MeshSerializer
 {
   public:
 	bool serialize(const fs::path &path, std::vector<MeshLoaderReturn> meshes);
-	std::vector<Mesh> deserialize(const fs::path &path, AssetHandle handle = NULL_UUID);
+	// Parsed in place, the vertices and indices point into data and are only valid as long as it is.
+	// Map the cooked file and hand the views to the mesh cache, which copies them into the staging buffer.
+	std::vector<MeshDataView> deserialize(std::span<const uint8_t> data, AssetHandle handle = NULL_UUID);
+	// Leaves the materials out of the material cache, mesh.material is not set
+	std::vector<DeserializedMesh> deserializeWithMaterials(std::span<const uint8_t> data,
+		AssetHandle handle = NULL_UUID);
 };
 }
\ No newline at end of file
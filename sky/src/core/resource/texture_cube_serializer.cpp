@@ -1,7 +1,79 @@
 #include "texture_cube_serializer.h"
 
-namespace sky 
+#include <cstring>
+
+#include "core/helpers/mapped_file.h"
+
+namespace sky
+{
+namespace
+{
+// layout: FileHeader | padding | pixels
+constexpr uint32_t TEXTURE_CUBE_MAGIC = 0x43594B53; // "SKYC"
+constexpr uint32_t TEXTURE_CUBE_VERSION = 1;
+constexpr uint64_t PIXELS_OFFSET = 32;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format; // TextureFormat
+};
+static_assert(sizeof(FileHeader) <= PIXELS_OFFSET);
+
+bool isCubeFormat(uint32_t format)
 {
+    return format >= static_cast<uint32_t>(TextureFormat::RGBA32Float) &&
+        format <= static_cast<uint32_t>(TextureFormat::BC6HUfloat);
+}
+
+// Fills everything but the pixels, pixelsOffset receives where they start in data
+bool parse(std::span<const uint8_t> data, TextureCube &texture, uint64_t &pixelsOffset)
+{
+    FileHeader header{};
+    if (data.size() < sizeof(header.magic)) return false;
+    std::memcpy(&header.magic, data.data(), sizeof(header.magic));
+
+    if (header.magic != TEXTURE_CUBE_MAGIC)
+    {
+        // written before the container, width height channels and float RGBA pixels
+        int legacy[3];
+        if (data.size() < sizeof(legacy)) return false;
+        std::memcpy(legacy, data.data(), sizeof(legacy));
+
+        texture.width = legacy[0];
+        texture.height = legacy[1];
+        texture.channels = legacy[2];
+        texture.format = TextureFormat::RGBA32Float;
+        pixelsOffset = sizeof(legacy);
+    }
+    else
+    {
+        if (data.size() < sizeof(header)) return false;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.version != TEXTURE_CUBE_VERSION)
+        {
+            SKY_CORE_ERROR("Unsupported cube texture version {}", header.version);
+            return false;
+        }
+        if (!isCubeFormat(header.format)) return false;
+
+        texture.width = header.width;
+        texture.height = header.height;
+        texture.channels = 4;
+        texture.format = static_cast<TextureFormat>(header.format);
+        pixelsOffset = PIXELS_OFFSET;
+    }
+
+    if (texture.width <= 0 || texture.height <= 0 || data.size() < pixelsOffset) return false;
+    // float and half float pixels are read in place
+    return data.size() - pixelsOffset >= texture.getPixelDataSize() &&
+        reinterpret_cast<uintptr_t>(data.data() + pixelsOffset) % alignof(float) == 0;
+}
+} // namespace
+
 bool TextureCubeSerializer::serialize(const fs::path &path, Ref<TextureCube> texture)
 {
     if (texture == nullptr) return false;
@@ -13,38 +85,49 @@ bool TextureCubeSerializer::serialize(const fs::path &path, Ref<TextureCube> tex
         return false;
     }
 
-    // Serialize texture metadata
-    file.write(reinterpret_cast<const char *>(&texture->width), sizeof(texture->width));
-    file.write(reinterpret_cast<const char *>(&texture->height), sizeof(texture->height));
-    file.write(reinterpret_cast<const char *>(&texture->channels), sizeof(texture->channels));
+    const auto header = FileHeader{
+        .magic = TEXTURE_CUBE_MAGIC,
+        .version = TEXTURE_CUBE_VERSION,
+        .width = (uint32_t)texture->width,
+        .height = (uint32_t)texture->height,
+        .format = static_cast<uint32_t>(texture->format),
+    };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    static const char zeros[PIXELS_OFFSET] = {};
+    file.write(zeros, PIXELS_OFFSET - sizeof(header));
 
-    // Write raw float pixel data (4 channels per pixel if STBI_rgb_alpha)
-    size_t pixelCount = static_cast<size_t>(texture->width) * texture->height * 4; // RGBA
-    size_t totalSize = pixelCount * sizeof(float);
-    file.write(reinterpret_cast<const char *>(texture->pixels), totalSize);
+    file.write(reinterpret_cast<const char *>(texture->pixels), texture->getPixelDataSize());
 
     file.close();
-    return true;
+    return file.good();
 }
 
 Ref<TextureCube> TextureCubeSerializer::deserialize(const fs::path &path)
 {
-    std::ifstream inFile(path, std::ios::binary);
-    if (!inFile.is_open()) {
+    // parsed in place, the pixels are copied once, from the mapping into the staging buffer
+    auto file = CreateRef<helper::MappedFile>();
+    if (!file->open(path))
+    {
         SKY_CORE_ERROR("Failed to open binary file: {}", path.string());
         return nullptr;
     }
+    return deserialize({file->data(), file->size()}, file);
+}
 
-    auto data = CreateRef<TextureCube>();
-    inFile.read(reinterpret_cast<char*>(&data->width), sizeof(data->width));
-    inFile.read(reinterpret_cast<char*>(&data->height), sizeof(data->height));
-    inFile.read(reinterpret_cast<char*>(&data->channels), sizeof(data->channels));
-
-    size_t pixelCount = static_cast<size_t>(data->width) * data->height * 4;
-    data->pixels = new float[pixelCount];
-    inFile.read(reinterpret_cast<char*>(data->pixels), pixelCount * sizeof(float));
+Ref<TextureCube> TextureCubeSerializer::deserialize(std::span<const uint8_t> data, Ref<const void> owner)
+{
+    auto texture = CreateRef<TextureCube>();
+    uint64_t pixelsOffset = 0;
+    if (!parse(data, *texture, pixelsOffset))
+    {
+        SKY_CORE_ERROR("Cube texture data is invalid, truncated or misaligned");
+        return nullptr;
+    }
 
-    inFile.close();
-    return data;
+    // only ever read, the upload copies it into the image
+    texture->pixels = const_cast<unsigned char *>(data.data() + pixelsOffset);
+    texture->pixelOwner = std::move(owner);
+    return texture;
+}
 }
-}
\ No newline at end of file
@@ -11,5 +11,7 @@ class TextureCubeSerializer
   public:
 	bool serialize(const fs::path &path, Ref<TextureCube> texture);
 	Ref<TextureCube> deserialize(const fs::path &path);
+	// No copy, the pixels point into data and owner keeps it alive
+	Ref<TextureCube> deserialize(std::span<const uint8_t> data, Ref<const void> owner);
 };
 }
\ No newline at end of file
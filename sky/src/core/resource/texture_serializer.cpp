@@ -1,8 +1,97 @@
 #include "texture_serializer.h"
 
+#include <cstring>
+
+#include "core/helpers/mapped_file.h"
+
 namespace sky
 {
-bool TextureSerializer::serialize(const fs::path &path, Ref<Texture2D> texture) 
+namespace
+{
+// layout: FileHeader | FileMip[mipCount] | padding | pixels, mip offsets count from the first pixel
+constexpr uint32_t TEXTURE_MAGIC = 0x54594B53; // "SKYT"
+constexpr uint32_t TEXTURE_VERSION = 2;
+constexpr uint64_t PIXEL_ALIGNMENT = 16;
+constexpr uint32_t MAX_MIP_COUNT = 32;
+
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format; // TextureFormat
+    uint32_t mipCount;
+};
+
+struct FileMip
+{
+    uint64_t offset;
+    uint64_t size;
+    uint32_t width;
+    uint32_t height;
+};
+
+uint64_t getPixelsOffset(uint32_t mipCount)
+{
+    const uint64_t tableEnd = sizeof(FileHeader) + uint64_t(mipCount) * sizeof(FileMip);
+    return (tableEnd + PIXEL_ALIGNMENT - 1) / PIXEL_ALIGNMENT * PIXEL_ALIGNMENT;
+}
+
+// Fills everything but the pixels, pixelsOffset receives where they start in data
+bool parse(std::span<const uint8_t> data, Texture2D &texture, uint64_t &pixelsOffset)
+{
+    FileHeader header{};
+    if (data.size() < sizeof(header.magic)) return false;
+    std::memcpy(&header.magic, data.data(), sizeof(header.magic));
+
+    if (header.magic != TEXTURE_MAGIC)
+    {
+        // written before the container, width height channels and level 0
+        uint32_t legacy[3];
+        if (data.size() < sizeof(legacy)) return false;
+        std::memcpy(legacy, data.data(), sizeof(legacy));
+
+        texture.width = legacy[0];
+        texture.height = legacy[1];
+        texture.channels = legacy[2];
+        pixelsOffset = sizeof(legacy);
+        return data.size() - pixelsOffset >= texture.getPixelDataSize();
+    }
+
+    if (data.size() < sizeof(header)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.version != TEXTURE_VERSION)
+    {
+        SKY_CORE_ERROR("Unsupported texture version {}", header.version);
+        return false;
+    }
+    if (header.mipCount == 0 || header.mipCount > MAX_MIP_COUNT) return false;
+    if (header.format > static_cast<uint32_t>(TextureFormat::BC7Srgb)) return false;
+
+    pixelsOffset = getPixelsOffset(header.mipCount);
+    if (data.size() < pixelsOffset) return false;
+
+    texture.width = header.width;
+    texture.height = header.height;
+    texture.channels = 4;
+    texture.format = static_cast<TextureFormat>(header.format);
+    texture.mips.resize(header.mipCount);
+    for (uint32_t i = 0; i < header.mipCount; ++i)
+    {
+        FileMip mip;
+        std::memcpy(&mip, data.data() + sizeof(FileHeader) + i * sizeof(FileMip), sizeof(mip));
+        if (mip.size != getTextureLevelSize(texture.format, mip.width, mip.height)) return false;
+        texture.mips[i] = {mip.width, mip.height, mip.offset, mip.size};
+    }
+    // a single RGBA8 level is just level 0, keep the upload on the plain path
+    if (header.mipCount == 1 && !isBlockCompressed(texture.format)) texture.mips.clear();
+
+    return data.size() - pixelsOffset >= texture.getPixelDataSize();
+}
+} // namespace
+
+bool TextureSerializer::serialize(const fs::path &path, Ref<Texture2D> texture)
 {
     if (texture == nullptr) return false;
 
@@ -13,53 +102,63 @@ bool TextureSerializer::serialize(const fs::path &path, Ref<Texture2D> texture)
         return false;
     }
 
-    // Serialize texture metadata
-    uint32_t width = texture->width;
-    uint32_t height = texture->height;
-    uint32_t channels = texture->channels;
-    file.write(reinterpret_cast<const char *>(&width), sizeof(width));
-    file.write(reinterpret_cast<const char *>(&height), sizeof(height));
-    file.write(reinterpret_cast<const char *>(&channels), sizeof(channels));
+    auto mips = texture->mips;
+    if (mips.empty())
+    {
+        const uint64_t size = uint64_t(texture->width) * texture->height * texture->channels;
+        mips.push_back({(uint32_t)texture->width, (uint32_t)texture->height, 0, size});
+    }
+
+    const auto header = FileHeader{
+        .magic = TEXTURE_MAGIC,
+        .version = TEXTURE_VERSION,
+        .width = (uint32_t)texture->width,
+        .height = (uint32_t)texture->height,
+        .format = static_cast<uint32_t>(texture->format),
+        .mipCount = (uint32_t)mips.size(),
+    };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (const auto &mip : mips)
+    {
+        const auto fileMip = FileMip{mip.offset, mip.size, mip.width, mip.height};
+        file.write(reinterpret_cast<const char *>(&fileMip), sizeof(fileMip));
+    }
+
+    static const char zeros[PIXEL_ALIGNMENT] = {};
+    file.write(zeros, getPixelsOffset(header.mipCount) - (sizeof(header) + mips.size() * sizeof(FileMip)));
 
     // Serialize texture data
-    unsigned char *data = texture->pixels;
-    size_t dataSize = width * height * channels;
-    file.write(reinterpret_cast<const char *>(data), dataSize);
+    file.write(reinterpret_cast<const char *>(texture->pixels), mips.back().offset + mips.back().size);
 
     file.close();
-    return true;
+    return file.good();
 }
 
-Ref<Texture2D> TextureSerializer::deserialize(const fs::path &path) 
+Ref<Texture2D> TextureSerializer::deserialize(const fs::path &path)
 {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open())
+    // parsed in place, the pixels are copied once, from the mapping into the staging buffer
+    auto file = CreateRef<helper::MappedFile>();
+    if (!file->open(path))
     {
         SKY_CORE_ERROR("Failed to open texture file: {0}", path.string());
         return nullptr;
     }
+    return deserialize({file->data(), file->size()}, file);
+}
 
-    // Read metadata
-    uint32_t width, height, channels;
-    file.read(reinterpret_cast<char *>(&width), sizeof(width));
-    file.read(reinterpret_cast<char *>(&height), sizeof(height));
-    file.read(reinterpret_cast<char *>(&channels), sizeof(channels));
-
-    // Read texture data
-    size_t dataSize = width * height * channels;
-    std::vector<unsigned char> data(dataSize);
-    file.read(reinterpret_cast<char *>(data.data()), dataSize);
-
+Ref<Texture2D> TextureSerializer::deserialize(std::span<const uint8_t> data, Ref<const void> owner)
+{
     auto texture = CreateRef<Texture2D>();
-    texture->width = width;
-    texture->height = height;
-    texture->channels = channels;
-
-    // Allocate new memory and copy the data
-    texture->pixels = new unsigned char[dataSize];
-    std::memcpy(texture->pixels, data.data(), dataSize);
+    uint64_t pixelsOffset = 0;
+    if (!parse(data, *texture, pixelsOffset))
+    {
+        SKY_CORE_ERROR("Texture data is invalid or truncated");
+        return nullptr;
+    }
 
-    file.close();
+    // only ever read, the upload copies it into the image
+    texture->pixels = const_cast<unsigned char *>(data.data() + pixelsOffset);
+    texture->pixelOwner = std::move(owner);
     return texture;
 }
-} // namespace sky
\ No newline at end of file
+} // namespace sky
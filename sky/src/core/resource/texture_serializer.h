@@ -11,5 +11,7 @@ class TextureSerializer
   public:
 	bool serialize(const fs::path &path, Ref<Texture2D> texture);
 	Ref<Texture2D> deserialize(const fs::path &path);
+	// No copy, the pixels point into data and owner keeps it alive
+	Ref<Texture2D> deserialize(std::span<const uint8_t> data, Ref<const void> owner);
 };
 }
\ No newline at end of file
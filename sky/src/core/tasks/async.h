@@ -0,0 +1,232 @@
+#pragma once
+
+#include <skypch.h>
+#include "task.h"
+#include "task_manager.h"
+
+namespace sky
+{
+// Coroutine front-end for the task system.
+//
+//  Async<void> loadSomething()
+//  {
+//      auto model = co_await AssetManager::load<Model>(handle);
+//      co_await switchTo(taskManager, CompletionThread::Main);
+//      ...
+//  }
+//  spawn(taskManager, loadSomething());
+//
+// Loads are submitted when the awaiter is created, so creating several awaiters before
+// co_await-ing them runs the loads in parallel.
+
+namespace detail
+{
+inline bool isOnExecutor(TaskManager &manager, CompletionThread executor)
+{
+    return executor == CompletionThread::Main ? manager.isMainThread() : manager.getCurrentWorkerIndex() >= 0;
+}
+
+inline void resumeOn(TaskManager &manager, CompletionThread executor, std::coroutine_handle<> handle)
+{
+    if (executor == CompletionThread::Main)
+        manager.postToMainThread([handle] { handle.resume(); });
+    else
+        manager.schedule([handle] { handle.resume(); }, TaskPriority::Visible, TaskType::Coroutine);
+}
+
+struct AsyncPromiseBase
+{
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+        void await_resume() noexcept {}
+
+        // hand control straight back to whoever awaited this coroutine
+        template <typename Promise> std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            auto continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+};
+
+template <typename T> struct AsyncPromise : AsyncPromiseBase
+{
+    void return_value(T result) { value = std::move(result); }
+
+    std::optional<T> value;
+};
+
+template <> struct AsyncPromise<void> : AsyncPromiseBase
+{
+    void return_void() {}
+};
+
+// Frame frees itself once done, used to start top-level coroutines
+struct DetachedCoroutine
+{
+    struct promise_type
+    {
+        DetachedCoroutine get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+} // namespace detail
+
+// Lazily started coroutine, it runs once awaited or passed to spawn()
+template <typename T = void>
+class [[nodiscard]] Async
+{
+  public:
+    struct promise_type : detail::AsyncPromise<T>
+    {
+        Async get_return_object() { return Async(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+
+    Async(Async &&o) noexcept : m_handle(std::exchange(o.m_handle, nullptr)) {}
+    Async &operator=(Async &&o) noexcept
+    {
+        if (this != &o)
+        {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(o.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    Async(const Async &) = delete;
+    Async &operator=(const Async &) = delete;
+
+    ~Async()
+    {
+        if (m_handle) m_handle.destroy();
+    }
+
+    auto operator co_await() noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                auto &promise = handle.promise();
+                if (promise.exception) std::rethrow_exception(promise.exception);
+                if constexpr (!std::is_void_v<T>) return std::move(*promise.value);
+            }
+        };
+        return Awaiter{m_handle};
+    }
+
+  private:
+    explicit Async(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// Awaits a Task and resumes on the chosen executor. Can also carry an already available value.
+template <typename Result>
+class TaskAwaiter
+{
+  public:
+    TaskAwaiter(TaskManager &manager, Ref<Task<Result>> task, CompletionThread resumeOn)
+        : m_manager(manager), m_task(std::move(task)), m_resumeOn(resumeOn) {}
+    TaskAwaiter(TaskManager &manager, Result value, CompletionThread resumeOn)
+        : m_manager(manager), m_value(std::move(value)), m_resumeOn(resumeOn) {}
+
+    bool await_ready()
+    {
+        const bool available = m_value.has_value() || (m_task && m_task->isFinished());
+        return available && detail::isOnExecutor(m_manager, m_resumeOn);
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        if (m_value.has_value())
+        {
+            detail::resumeOn(m_manager, m_resumeOn, handle);
+            return;
+        }
+
+        m_task->onFinished([manager = &m_manager, resumeOn = m_resumeOn, handle]
+            { detail::resumeOn(*manager, resumeOn, handle); });
+    }
+
+    Result await_resume()
+    {
+        if (m_value.has_value()) return std::move(*m_value);
+
+        if (auto result = m_task->getResult()) return *result;
+        if (m_task->getStatus() == Task<Result>::Status::Cancelled) throw TaskCancelled();
+        throw std::runtime_error("awaited task failed");
+    }
+
+  private:
+    TaskManager &m_manager;
+    Ref<Task<Result>> m_task;
+    std::optional<Result> m_value;
+    CompletionThread m_resumeOn;
+};
+
+template <typename Result>
+TaskAwaiter<Result> awaitTask(TaskManager &manager, Ref<Task<Result>> task,
+    CompletionThread resumeOn = CompletionThread::Worker)
+{
+    return TaskAwaiter<Result>(manager, std::move(task), resumeOn);
+}
+
+// co_await switchTo(manager, CompletionThread::Main) continues the coroutine on that executor
+inline auto switchTo(TaskManager &manager, CompletionThread executor)
+{
+    struct ExecutorAwaiter
+    {
+        TaskManager &manager;
+        CompletionThread executor;
+
+        bool await_ready() { return detail::isOnExecutor(manager, executor); }
+        void await_suspend(std::coroutine_handle<> handle) { detail::resumeOn(manager, executor, handle); }
+        void await_resume() {}
+    };
+    return ExecutorAwaiter{manager, executor};
+}
+
+// Starts a coroutine on the given executor without waiting for it. Exceptions that escape
+// the coroutine are logged.
+template <typename T>
+void spawn(TaskManager &manager, Async<T> async, CompletionThread startOn = CompletionThread::Worker)
+{
+    [](TaskManager &manager, Async<T> async, CompletionThread startOn) -> detail::DetachedCoroutine
+    {
+        co_await switchTo(manager, startOn);
+        try
+        {
+            co_await async;
+        }
+        catch (const TaskCancelled &)
+        {
+        }
+        catch (const std::exception &e)
+        {
+            SKY_CORE_ERROR("Unhandled exception in coroutine: {}", e.what());
+        }
+    }(manager, std::move(async), startOn);
+}
+} // namespace sky
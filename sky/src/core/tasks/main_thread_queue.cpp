@@ -0,0 +1,39 @@
+#include "main_thread_queue.h"
+
+namespace sky
+{
+void MainThreadQueue::post(Job job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs.push_back(std::move(job));
+}
+
+void MainThreadQueue::drain()
+{
+    using Clock = std::chrono::steady_clock;
+
+    const auto start = Clock::now();
+    const auto budget = std::chrono::duration<double, std::milli>(m_budgetMs.load());
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_jobs.empty()) return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        job();
+        if (Clock::now() - start >= budget) return;
+    }
+}
+
+size_t MainThreadQueue::size() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_jobs.size();
+}
+} // namespace sky
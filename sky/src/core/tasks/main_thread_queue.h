@@ -0,0 +1,30 @@
+#pragma once
+
+#include <skypch.h>
+
+namespace sky
+{
+// Jobs posted from any thread and run on the main thread at a fixed point of the frame
+class MainThreadQueue
+{
+  public:
+    using Job = std::function<void()>;
+
+    static constexpr double DEFAULT_BUDGET_MS = 2.0;
+
+    void post(Job job);
+
+    // Runs queued jobs until the budget is used up. At least one job always runs so a
+    // slow job can not starve the queue, whatever is left waits for the next frame.
+    void drain();
+
+    void setBudget(double milliseconds) { m_budgetMs = milliseconds; }
+    double getBudget() const { return m_budgetMs; }
+    size_t size() const;
+
+  private:
+    std::deque<Job> m_jobs;
+    mutable std::mutex m_mutex;
+    std::atomic<double> m_budgetMs{DEFAULT_BUDGET_MS};
+};
+} // namespace sky
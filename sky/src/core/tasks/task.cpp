@@ -0,0 +1,74 @@
+#include "task.h"
+
+#include "task_manager.h"
+
+namespace sky
+{
+bool TaskBase::isFinished()
+{
+    std::unique_lock<std::mutex> lock(m_dependentsMutex);
+    return m_finished;
+}
+
+void TaskBase::onFinished(std::function<void()> fn)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_dependentsMutex);
+        if (!m_finished)
+        {
+            m_finishedCallbacks.push_back(std::move(fn));
+            return;
+        }
+    }
+    fn();
+}
+
+void TaskBase::addDependency(const Ref<TaskBase> &predecessor)
+{
+    if (predecessor == nullptr) return;
+
+    std::unique_lock<std::mutex> lock(predecessor->m_dependentsMutex);
+    if (predecessor->m_finished)
+    {
+        if (predecessor->m_failed) m_dependencyFailed = true;
+        return;
+    }
+
+    m_pendingDependencies.fetch_add(1);
+    predecessor->m_dependents.push_back(shared_from_this());
+}
+
+void TaskBase::releaseDependents(bool failed)
+{
+    std::vector<Ref<TaskBase>> dependents;
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::unique_lock<std::mutex> lock(m_dependentsMutex);
+        m_finished = true;
+        m_failed = failed;
+        dependents.swap(m_dependents);
+        callbacks.swap(m_finishedCallbacks);
+    }
+
+    for (const auto &callback : callbacks) callback();
+
+    for (const auto &dependent : dependents)
+    {
+        if (failed) dependent->m_dependencyFailed = true;
+
+        // the submit hold is part of the count, so a dependent reaching zero has already been submitted
+        if (dependent->releaseHold()) dependent->m_manager->scheduleTask(dependent);
+    }
+}
+
+void TaskBase::postToMainThread(std::function<void()> job)
+{
+    // never submitted (run inline), the caller already is where the completion should happen
+    if (m_manager == nullptr)
+    {
+        job();
+        return;
+    }
+    m_manager->postToMainThread(std::move(job));
+}
+} // namespace sky
@@ -4,15 +4,155 @@
 
 namespace sky
 {
-class TaskBase
+class TaskManager;
+
+enum class TaskPriority : uint8_t
+{
+    Interactive = 0, // someone is blocked on the result (ui, parallelFor callers)
+    Visible,         // needed for what is currently on screen
+    Background,      // prefetching, thumbnails, imports
+    Count
+};
+
+enum class TaskType : uint16_t
+{
+    Generic = 0,
+    AssetLoad,
+    ImageLoad,
+    Continuation,
+    ParallelFor,
+    Physics,
+    Coroutine,
+    AssetImport,
+    Count
+};
+
+static constexpr size_t TASK_PRIORITY_COUNT = static_cast<size_t>(TaskPriority::Count);
+static constexpr size_t TASK_TYPE_COUNT = static_cast<size_t>(TaskType::Count);
+
+inline const char *taskTypeToString(TaskType type)
+{
+    switch (type)
+    {
+        case TaskType::Generic: return "Generic";
+        case TaskType::AssetLoad: return "AssetLoad";
+        case TaskType::ImageLoad: return "ImageLoad";
+        case TaskType::Continuation: return "Continuation";
+        case TaskType::ParallelFor: return "ParallelFor";
+        case TaskType::Physics: return "Physics";
+        case TaskType::Coroutine: return "Coroutine";
+        case TaskType::AssetImport: return "AssetImport";
+        default: return "Unknown";
+    }
+}
+
+enum class TaskOutcome : uint8_t
+{
+    Pending = 0,
+    Completed,
+    Failed,
+    Cancelled
+};
+
+// Thread the result callback of a Task runs on
+enum class CompletionThread : uint8_t
+{
+    Worker = 0, // right after the task finished, on the worker that ran it
+    Main,       // queued and run by TaskManager::drainMainThreadQueue
+};
+
+// Identifies a task in the TaskManager registry without allocating, e.g. {AssetLoad, handle}
+struct TaskKey
+{
+    TaskType type = TaskType::Generic;
+    uint64_t id = 0;
+
+    bool operator==(const TaskKey &other) const = default;
+};
+
+// Thrown from inside a task function to stop early once its token was cancelled
+struct TaskCancelled : public std::exception
+{
+    const char *what() const noexcept override { return "task cancelled"; }
+};
+
+// Shared flag, copies observe the same state so one token can cancel a whole group of tasks
+class CancellationToken
+{
+  public:
+    CancellationToken() : m_cancelled(CreateRef<std::atomic<bool>>(false)) {}
+
+    void cancel() const { *m_cancelled = true; }
+    bool isCancelled() const { return *m_cancelled; }
+    void throwIfCancelled() const
+    {
+        if (isCancelled()) throw TaskCancelled();
+    }
+
+  private:
+    Ref<std::atomic<bool>> m_cancelled;
+};
+
+class TaskBase : public std::enable_shared_from_this<TaskBase>
 {
   public:
     virtual ~TaskBase() = default;
     virtual void run() = 0; // Pure virtual function for running the task.
-    virtual const std::string &getId() const = 0;
+
+    const TaskKey &getKey() const { return m_key; }
+    TaskPriority getPriority() const { return m_priority; }
+
+    // Cooperative, a queued task is skipped and a running one stops at its next token check
+    void cancel() { m_token.cancel(); }
+    bool isCancelled() const { return m_token.isCancelled(); }
+    const CancellationToken &getCancellationToken() const { return m_token; }
+
+    bool isFinished();
+    virtual TaskOutcome getOutcome() const = 0;
+
+    // Runs fn once the task reached its final state, whether it completed, failed or was cancelled.
+    // Runs right away on the calling thread if it already has.
+    void onFinished(std::function<void()> fn);
+
+    // Holds this task back until predecessor has finished. Must be called before the task is submitted.
+    void addDependency(const Ref<TaskBase> &predecessor);
+    bool hasFailedDependency() const { return m_dependencyFailed; }
+
+  protected:
+    TaskBase(const TaskKey &key, const CancellationToken &token) : m_key(key), m_token(token) {}
+
+    // Called once the task reached its final state, schedules every dependent whose inputs are now all done.
+    void releaseDependents(bool failed);
+
+    // Hands a completion to the main thread queue of the manager running this task
+    void postToMainThread(std::function<void()> job);
+
+  private:
+    friend class TaskManager;
+
+    // true when the last outstanding dependency (or the submit hold) has been released
+    bool releaseHold() { return m_pendingDependencies.fetch_sub(1) == 1; }
+
+  private:
+    TaskKey m_key;
+    CancellationToken m_token;
+    std::atomic<TaskPriority> m_priority{TaskPriority::Visible};
+    // set by whichever queued copy of the task gets to run it first (see TaskManager::reprioritize)
+    std::atomic<bool> m_started{false};
+
+    // starts at one, that extra hold is dropped by TaskManager::submitTask
+    std::atomic<int> m_pendingDependencies{1};
+    std::atomic<bool> m_dependencyFailed{false};
+    TaskManager *m_manager = nullptr;
+
+    std::mutex m_dependentsMutex;
+    std::vector<Ref<TaskBase>> m_dependents;
+    std::vector<std::function<void()>> m_finishedCallbacks;
+    bool m_finished = false;
+    bool m_failed = false;
 };
 
-template <typename Result> 
+template <typename Result>
 class Task : public TaskBase
 {
   public:
@@ -21,43 +161,76 @@ class Task : public TaskBase
         Pending,
         Running,
         Completed,
-        Failed
+        Failed,
+        Cancelled
     };
 
-    Task(const std::string &id, std::function<Result()> func) : m_id(id), m_func(func), m_status(Status::Pending) {}
+    Task(const TaskKey &key, std::function<Result()> func, const CancellationToken &token = {})
+        : TaskBase(key, token), m_func(func), m_status(Status::Pending) {}
 
     void run() override
     {
+        // cancelled while queued, or a predecessor failed: nothing meaningful to compute
+        if (isCancelled() || hasFailedDependency())
+        {
+            finish(isCancelled() ? Status::Cancelled : Status::Failed);
+            return;
+        }
+
         {
             std::unique_lock lock(m_mutex);
             m_status = Status::Running;
         }
-    
+
+        // the status is only set once the callback has run too, so waiters never see Completed turn into Failed
+        auto status = Status::Completed;
         try
         {
             Result result = m_func(); // run outside lock
             {
                 std::unique_lock lock(m_mutex);
-                m_result = result;
-                m_status = Status::Completed;
+                m_result = std::move(result);
+            }
+
+            if (m_callback)
+            {
+                if (m_completionThread == CompletionThread::Main)
+                    postToMainThread([callback = m_callback, result = *m_result] { callback(result); });
+                else
+                    m_callback(*m_result);
             }
-    
-            if (m_callback) m_callback(*m_result);
+        }
+        catch (const TaskCancelled &)
+        {
+            status = Status::Cancelled;
         }
         catch (const std::exception &)
         {
-            std::unique_lock lock(m_mutex);
-            m_status = Status::Failed;
+            status = Status::Failed;
             assert(false);
         }
-    
-        m_cv.notify_all();
+
+        finish(status);
     }
 
-    void setCallback(std::function<void(const Result &)> callback) { m_callback = callback; }
+    void setCallback(std::function<void(const Result &)> callback, CompletionThread thread = CompletionThread::Worker)
+    {
+        m_callback = callback;
+        m_completionThread = thread;
+    }
 
     Status getStatus() const { return m_status; }
-    const std::string &getId() const override { return m_id; }
+
+    TaskOutcome getOutcome() const override
+    {
+        switch (m_status)
+        {
+            case Status::Completed: return TaskOutcome::Completed;
+            case Status::Failed: return TaskOutcome::Failed;
+            case Status::Cancelled: return TaskOutcome::Cancelled;
+            default: return TaskOutcome::Pending;
+        }
+    }
 
     std::optional<Result> getResult() const
     {
@@ -69,23 +242,84 @@ class Task : public TaskBase
     void wait()
     {
         std::unique_lock lock(m_mutex);
-        m_cv.wait(lock, [this] { return m_status == Status::Completed || m_status == Status::Failed; });
+        m_cv.wait(lock, [this] { return m_status != Status::Pending && m_status != Status::Running; });
+    }
+
+    // Creates a task that runs fn with this task's result once it has completed.
+    // The continuation still has to be submitted, it is only scheduled after this task finishes.
+    template <typename Fn>
+    auto then(const TaskKey &key, Fn fn) -> Ref<Task<std::invoke_result_t<Fn, const Result &>>>
+    {
+        using Next = std::invoke_result_t<Fn, const Result &>;
+
+        auto self = std::static_pointer_cast<Task<Result>>(shared_from_this());
+        auto next = Task<Next>::create(key, [self, fn]() -> Next { return fn(*self->getResult()); });
+        next->addDependency(self);
+        return next;
+    }
+
+    static Ref<Task<Result>> create(const TaskKey &key, std::function<Result()> func, const CancellationToken &token = {})
+    {
+        return CreateRef<Task<Result>>(key, func, token);
     }
 
-    static Ref<Task<Result>> create(const std::string &id, std::function<Result()> func)
+    // A task that has already completed with result, for callers that hand out a task either way
+    static Ref<Task<Result>> fromResult(const TaskKey &key, Result result)
     {
-        return CreateRef<Task<Result>>(id, func);
+        auto task = create(key, [result] { return result; });
+        task->run();
+        return task;
+    }
+
+  private:
+    void finish(Status status)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_status = status;
+        }
+        m_cv.notify_all();
+        releaseDependents(status != Status::Completed);
     }
 
   private:
-    std::string m_id;
     std::function<Result()> m_func;
     std::optional<Result> m_result; // Store the result.
     std::function<void(const Result &)> m_callback;
+    CompletionThread m_completionThread = CompletionThread::Worker;
     Status m_status;
 
     mutable std::mutex m_mutex;
     std::condition_variable m_cv;
 };
-} 
-// namespace sky
\ No newline at end of file
+
+// Creates a task that completes with every result once all of the given tasks have completed.
+// Like then(), the returned task has to be submitted.
+template <typename Result>
+Ref<Task<std::vector<Result>>> whenAll(const TaskKey &key, const std::vector<Ref<Task<Result>>> &tasks)
+{
+    auto joined = Task<std::vector<Result>>::create(key,
+        [tasks]() -> std::vector<Result>
+        {
+            std::vector<Result> results;
+            results.reserve(tasks.size());
+            for (const auto &task : tasks) results.push_back(*task->getResult());
+            return results;
+        });
+
+    for (const auto &task : tasks) joined->addDependency(task);
+    return joined;
+}
+}
+// namespace sky
+
+namespace std
+{
+template <> struct hash<sky::TaskKey>
+{
+    size_t operator()(const sky::TaskKey &key) const
+    {
+        return hash<uint64_t>()(key.id ^ (static_cast<uint64_t>(key.type) * 0x9E3779B97F4A7C15ull));
+    }
+};
+}
@@ -1,34 +1,27 @@
 #include "task_manager.h"
 
+#include <cstring>
+#include <tracy/Tracy.hpp>
+
 namespace sky
 {
-TaskManager::TaskManager(size_t threadCount) : m_stop(false)
+static thread_local const TaskManager *s_currentManager = nullptr;
+static thread_local int s_workerIndex = -1;
+
+TaskManager::TaskManager(size_t threadCount)
+    : m_stop(false), m_mainThreadId(std::this_thread::get_id()), m_telemetry(std::max<size_t>(threadCount, 1))
 {
-    for (size_t i = 0; i < threadCount; ++i)
-    {
-        m_workers.emplace_back(
-            [this]
-            {
-                while (true)
-                {
-                    std::shared_ptr<TaskBase> task;
-                    {
-                        std::unique_lock<std::mutex> lock(m_queueMutex);
-                        m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
-                        if (m_stop && m_tasks.empty()) return;
-                        task = m_tasks.front();
-                        m_tasks.pop();
-                    }
-                    task->run();
-                }
-            });
-    }
+    threadCount = std::max<size_t>(threadCount, 1);
+
+    // all queues must exist before any worker starts stealing
+    for (size_t i = 0; i < threadCount; ++i) m_queues.push_back(CreateScope<WorkerQueues>());
+    for (size_t i = 0; i < threadCount; ++i) m_workers.emplace_back([this, i] { workerLoop(i); });
 }
 
 TaskManager::~TaskManager()
 {
     {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
         m_stop = true;
     }
     m_condition.notify_all();
@@ -37,4 +30,242 @@ TaskManager::~TaskManager()
         worker.join();
     }
 }
-} // namespace sky
\ No newline at end of file
+
+void TaskManager::workerLoop(size_t index)
+{
+    s_currentManager = this;
+    s_workerIndex = static_cast<int>(index);
+    tracy::SetThreadName(("Task worker " + std::to_string(index)).c_str());
+
+    while (true)
+    {
+        QueuedJob job;
+        if (popJob(job))
+        {
+            runJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_condition.wait(lock, [this] { return m_stop || m_pendingJobs.load() > 0; });
+        if (m_stop && m_pendingJobs.load() <= 0) return;
+    }
+}
+
+void TaskManager::schedule(Job job, TaskPriority priority, TaskType type)
+{
+    const int worker = getCurrentWorkerIndex();
+    const size_t index = worker >= 0 ? worker : m_nextQueue.fetch_add(1) % m_queues.size();
+
+    // counted before the push so a sleeping worker can never miss it
+    m_pendingJobs.fetch_add(1);
+    m_queues[index]->byPriority[static_cast<size_t>(priority)].push(
+        {std::move(job), type, std::chrono::steady_clock::now()});
+
+    {
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+    }
+    m_condition.notify_one();
+}
+
+void TaskManager::submit(const Ref<TaskBase> &task)
+{
+    task->m_manager = this;
+    if (task->releaseHold()) scheduleTask(task);
+}
+
+void TaskManager::scheduleTask(const Ref<TaskBase> &task)
+{
+    schedule([this, task] { runTask(task); }, task->getPriority(), task->getKey().type);
+}
+
+bool TaskManager::runTask(const Ref<TaskBase> &task)
+{
+    // a reprioritized task sits in two queues and a joined one may also run on the joining thread,
+    // only the first of them runs it
+    if (task->m_started.exchange(true)) return false;
+
+    task->run();
+    m_telemetry.recordOutcome(task->getKey().type, getCurrentWorkerIndex(), task->getOutcome());
+    onTaskFinished(task);
+    return true;
+}
+
+void TaskManager::onTaskFinished(const Ref<TaskBase> &task)
+{
+    std::unique_lock<std::mutex> lock(m_taskMapMutex);
+
+    auto it = m_taskMap.find(task->getKey());
+    if (it == m_taskMap.end() || it->second != task) return; // replaced by a newer task with the same key
+
+    m_completedTasks.push_back(task->getKey());
+    while (m_completedTasks.size() > m_maxCompletedTasks)
+    {
+        auto evicted = m_taskMap.find(m_completedTasks.front());
+        if (evicted != m_taskMap.end() && evicted->second->isFinished()) m_taskMap.erase(evicted);
+        m_completedTasks.pop_front();
+    }
+}
+
+void TaskManager::reprioritize(const TaskKey &key, TaskPriority priority)
+{
+    Ref<TaskBase> task;
+    {
+        std::unique_lock<std::mutex> lock(m_taskMapMutex);
+        auto it = m_taskMap.find(key);
+        if (it == m_taskMap.end()) return;
+        task = it->second;
+    }
+
+    if (task->m_started || task->getPriority() == priority) return;
+
+    const bool raised = priority < task->getPriority();
+    task->m_priority = priority;
+
+    // still waiting on predecessors, it will be queued with the new priority once released.
+    // Otherwise queue a second copy at the new level, the stale one becomes a no-op.
+    if (raised && task->m_pendingDependencies.load() <= 0) scheduleTask(task);
+}
+
+void TaskManager::cancel(const TaskKey &key)
+{
+    std::unique_lock<std::mutex> lock(m_taskMapMutex);
+    auto it = m_taskMap.find(key);
+    if (it != m_taskMap.end()) it->second->cancel();
+}
+
+void TaskManager::setMaxCompletedTasks(size_t count)
+{
+    std::unique_lock<std::mutex> lock(m_taskMapMutex);
+    m_maxCompletedTasks = count;
+}
+
+void TaskManager::runJob(QueuedJob &job)
+{
+    const auto started = std::chrono::steady_clock::now();
+    {
+        ZoneScopedN("Task");
+        const char *typeName = taskTypeToString(job.type);
+        ZoneText(typeName, std::strlen(typeName));
+        job.fn();
+    }
+    const auto finished = std::chrono::steady_clock::now();
+
+    m_telemetry.recordJob(job.type, getCurrentWorkerIndex(),
+        std::chrono::duration<double, std::milli>(started - job.queuedAt).count(),
+        std::chrono::duration<double, std::milli>(finished - started).count());
+}
+
+void TaskManager::sampleTelemetry()
+{
+    std::array<size_t, TASK_PRIORITY_COUNT> depth{};
+    for (const auto &queues : m_queues)
+    {
+        for (size_t priority = 0; priority < PRIORITY_COUNT; ++priority) depth[priority] += queues->byPriority[priority].size();
+    }
+    const size_t mainThreadDepth = m_mainThreadQueue.size();
+
+    m_telemetry.recordQueueDepth(depth, mainThreadDepth);
+
+    TracyPlot("Tasks queued (interactive)", static_cast<int64_t>(depth[static_cast<size_t>(TaskPriority::Interactive)]));
+    TracyPlot("Tasks queued (visible)", static_cast<int64_t>(depth[static_cast<size_t>(TaskPriority::Visible)]));
+    TracyPlot("Tasks queued (background)", static_cast<int64_t>(depth[static_cast<size_t>(TaskPriority::Background)]));
+    TracyPlot("Main thread completions queued", static_cast<int64_t>(mainThreadDepth));
+}
+
+bool TaskManager::popJob(QueuedJob &job)
+{
+    const int worker = getCurrentWorkerIndex();
+    const size_t start = worker >= 0 ? worker + 1 : m_nextQueue.load();
+
+    // a higher priority job anywhere in the pool wins over lower priority local work
+    for (size_t priority = 0; priority < PRIORITY_COUNT; ++priority)
+    {
+        if ((worker >= 0 && m_queues[worker]->byPriority[priority].pop(job)) || stealJob(start, priority, job))
+        {
+            m_pendingJobs.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskManager::stealJob(size_t start, size_t priority, QueuedJob &job)
+{
+    for (size_t i = 0; i < m_queues.size(); ++i)
+    {
+        if (m_queues[(start + i) % m_queues.size()]->byPriority[priority].steal(job)) return true;
+    }
+    return false;
+}
+
+int TaskManager::getCurrentWorkerIndex() const
+{
+    return s_currentManager == this ? s_workerIndex : -1;
+}
+
+void TaskManager::parallelFor(size_t begin, size_t end, const std::function<void(size_t)> &fn, size_t grainSize)
+{
+    if (begin >= end) return;
+
+    const size_t count = end - begin;
+    if (grainSize == 0)
+    {
+        // a few chunks per worker leaves room for stealing when iterations are uneven
+        grainSize = std::max<size_t>(1, count / (m_workers.size() * 4));
+    }
+
+    const size_t numChunks = (count + grainSize - 1) / grainSize;
+    if (numChunks <= 1)
+    {
+        for (size_t i = begin; i < end; ++i) fn(i);
+        return;
+    }
+
+    // shared with the helper jobs, which can still be queued after the call has returned
+    struct ForState
+    {
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> remaining;
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    };
+    auto state = CreateRef<ForState>();
+    state->remaining = numChunks;
+
+    // claims chunks until none are left. A chunk is only claimed while the call is still waiting for it,
+    // so fn is never used after it returned.
+    auto runChunks = [state, fnPtr = &fn, begin, end, grainSize, numChunks]
+    {
+        for (size_t chunk = state->nextChunk.fetch_add(1); chunk < numChunks; chunk = state->nextChunk.fetch_add(1))
+        {
+            const size_t chunkBegin = begin + chunk * grainSize;
+            const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+            try
+            {
+                for (size_t i = chunkBegin; i < chunkEnd; ++i) (*fnPtr)(i);
+            }
+            catch (...)
+            {
+                std::unique_lock<std::mutex> lock(state->errorMutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            if (state->remaining.fetch_sub(1) == 1) state->remaining.notify_all();
+        }
+    };
+
+    // one helper per worker at most, each of them keeps claiming chunks as long as there are any
+    const size_t helpers = std::min(numChunks - 1, m_workers.size());
+    for (size_t i = 0; i < helpers; ++i) schedule(runChunks, TaskPriority::Interactive, TaskType::ParallelFor);
+
+    // the caller only ever works on its own chunks, never on unrelated jobs from the pool, and then waits
+    // for the ones the helpers claimed
+    runChunks();
+    for (size_t remaining = state->remaining.load(); remaining > 0; remaining = state->remaining.load())
+    {
+        state->remaining.wait(remaining);
+    }
+
+    if (state->error) std::rethrow_exception(state->error);
+}
+} // namespace sky
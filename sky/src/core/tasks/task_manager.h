@@ -2,46 +2,161 @@
 
 #include <skypch.h>
 #include "task.h"
+#include "work_stealing_queue.h"
+#include "main_thread_queue.h"
+#include "task_telemetry.h"
 
 namespace sky
 {
 class TaskManager
 {
   public:
+    using Job = std::function<void()>;
+
+    static constexpr size_t PRIORITY_COUNT = static_cast<size_t>(TaskPriority::Count);
+    static constexpr size_t DEFAULT_MAX_COMPLETED_TASKS = 256;
+
     TaskManager(size_t threadCount = std::thread::hardware_concurrency());
     ~TaskManager();
-   
-    template <typename Result> void submitTask(const Ref<Task<Result>> &task)
+
+    template <typename Result>
+    void submitTask(const Ref<Task<Result>> &task, TaskPriority priority = TaskPriority::Visible)
     {
-        Ref<TaskBase> baseTask = std::static_pointer_cast<TaskBase>(task);
-        {
-            std::unique_lock<std::mutex> lock(m_queueMutex);
-            m_tasks.push(baseTask);
-        }
+        task->m_priority = priority;
         {
             std::unique_lock<std::mutex> lock(m_taskMapMutex);
-            m_taskMap[task->getId()] = std::static_pointer_cast<TaskBase>(task);
+            m_taskMap[task->getKey()] = std::static_pointer_cast<TaskBase>(task);
         }
-        m_condition.notify_one();
+        submit(task);
     }
 
-    template <typename Result> Ref<Task<Result>> getTask(const std::string &id)
+    template <typename Result> Ref<Task<Result>> getTask(const TaskKey &key)
     {
         std::unique_lock<std::mutex> lock(m_taskMapMutex);
-        if (m_taskMap.count(id))
+        auto it = m_taskMap.find(key);
+        if (it != m_taskMap.end())
         {
-            return std::dynamic_pointer_cast<Task<Result>>(m_taskMap[id]);
+            return std::dynamic_pointer_cast<Task<Result>>(it->second);
         }
         return nullptr;
     }
 
+    // Returns the task registered under key, or registers the one make() returns when there is none or it
+    // was cancelled, in one step so concurrent callers never both create one. created tells which happened,
+    // a created task still has to be submitted.
+    template <typename Result, typename Make>
+    Ref<Task<Result>> getOrAddTask(const TaskKey &key, Make &&make, bool &created)
+    {
+        std::unique_lock<std::mutex> lock(m_taskMapMutex);
+        auto &registered = m_taskMap[key];
+        auto task = std::dynamic_pointer_cast<Task<Result>>(registered);
+        created = task == nullptr || task->getOutcome() == TaskOutcome::Cancelled;
+        if (created)
+        {
+            task = make();
+            registered = task;
+        }
+        return task;
+    }
+
+    // Waits for submitted tasks to finish. The ones no worker has started yet run on the calling
+    // thread, so joining from inside a job never waits behind a queue every worker is blocked on.
+    template <typename Result> void join(const std::vector<Ref<Task<Result>>> &tasks)
+    {
+        for (const auto &task : tasks)
+        {
+            if (task->m_pendingDependencies.load() <= 0) runTask(task);
+        }
+        for (const auto &task : tasks) task->wait();
+    }
+
+    // Moves a task that has not started yet to another priority level
+    void reprioritize(const TaskKey &key, TaskPriority priority);
+    void cancel(const TaskKey &key);
+
+    // Completed tasks stay findable until this many newer ones have completed
+    void setMaxCompletedTasks(size_t count);
+
+    // Pushes a job onto the calling worker's deque, or onto the next worker in turn when
+    // called from outside the pool. The type only groups the job in the telemetry.
+    void schedule(Job job, TaskPriority priority = TaskPriority::Visible, TaskType type = TaskType::Generic);
+
+    // Splits [begin, end) into chunks and runs fn(i) for every index on the pool. The calling
+    // thread works on the call's own chunks, never on other jobs, and returns once every index
+    // has been processed, so it is safe to call from inside another job or from the main thread.
+    void parallelFor(size_t begin, size_t end, const std::function<void(size_t)> &fn, size_t grainSize = 0);
+
+    template <typename Container, typename Fn>
+    void parallelForEach(Container &container, Fn &&fn, size_t grainSize = 0)
+    {
+        auto first = std::begin(container);
+        parallelFor(0, std::size(container), [&](size_t i) { fn(*(first + i)); }, grainSize);
+    }
+
+    // Completions posted here run when the main thread drains the queue once per frame,
+    // within the budget set by setMainThreadBudget
+    void postToMainThread(MainThreadQueue::Job job) { m_mainThreadQueue.post(std::move(job)); }
+    void drainMainThreadQueue() { m_mainThreadQueue.drain(); }
+    void setMainThreadBudget(double milliseconds) { m_mainThreadQueue.setBudget(milliseconds); }
+
+    // Records the current queue depths, called once per frame from the main loop
+    void sampleTelemetry();
+    const TaskTelemetry &getTelemetry() const { return m_telemetry; }
+
+    size_t getWorkerCount() const { return m_workers.size(); }
+
+    // The thread that created the manager, the one draining the main thread queue
+    bool isMainThread() const { return std::this_thread::get_id() == m_mainThreadId; }
+
+    // Index of the worker running the current thread, -1 for threads outside the pool
+    int getCurrentWorkerIndex() const;
+
+  private:
+    friend class TaskBase;
+
+    struct QueuedJob
+    {
+        Job fn;
+        TaskType type = TaskType::Generic;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    // One deque per priority level, higher levels are always drained (and stolen) first
+    struct WorkerQueues
+    {
+        std::array<WorkStealingQueue<QueuedJob>, PRIORITY_COUNT> byPriority;
+    };
+
+    // drops the submit hold, the task runs right away unless it still waits on predecessors
+    void submit(const Ref<TaskBase> &task);
+    void scheduleTask(const Ref<TaskBase> &task);
+    // runs the task unless another queued copy or a join got to it first
+    bool runTask(const Ref<TaskBase> &task);
+    void onTaskFinished(const Ref<TaskBase> &task);
+
+    void workerLoop(size_t index);
+    bool popJob(QueuedJob &job);
+    bool stealJob(size_t start, size_t priority, QueuedJob &job);
+    void runJob(QueuedJob &job);
+
   private:
     bool m_stop;
     std::vector<std::thread> m_workers;
-    std::queue<Ref<TaskBase>> m_tasks;
-    std::unordered_map<std::string, Ref<TaskBase>> m_taskMap;
-    std::mutex m_queueMutex;
+    std::vector<Scope<WorkerQueues>> m_queues;
+    std::atomic<int64_t> m_pendingJobs{0};
+    std::atomic<size_t> m_nextQueue{0};
+
+    std::unordered_map<TaskKey, Ref<TaskBase>> m_taskMap;
+    std::deque<TaskKey> m_completedTasks; // oldest first, evicted once over m_maxCompletedTasks
+    size_t m_maxCompletedTasks = DEFAULT_MAX_COMPLETED_TASKS;
     std::mutex m_taskMapMutex;
+
+    MainThreadQueue m_mainThreadQueue;
+    std::thread::id m_mainThreadId;
+
+    std::mutex m_sleepMutex;
     std::condition_variable m_condition;
+
+    TaskTelemetry m_telemetry;
 };
-}
\ No newline at end of file
+}
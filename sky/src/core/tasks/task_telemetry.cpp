@@ -0,0 +1,161 @@
+#include "task_telemetry.h"
+
+namespace sky
+{
+TaskTelemetry::TaskTelemetry(size_t workerCount) : m_start(Clock::now())
+{
+    for (size_t i = 0; i < workerCount + 1; ++i) m_slots.push_back(CreateScope<Slot>());
+}
+
+TaskTelemetry::Slot &TaskTelemetry::getSlot(int workerIndex)
+{
+    if (workerIndex < 0 || workerIndex >= static_cast<int>(m_slots.size()) - 1) return *m_slots.back();
+    return *m_slots[workerIndex];
+}
+
+double TaskTelemetry::getElapsedMs() const
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - m_start).count();
+}
+
+void TaskTelemetry::recordJob(TaskType type, int workerIndex, double waitMs, double runMs)
+{
+    auto &slot = getSlot(workerIndex);
+    std::unique_lock<std::mutex> lock(slot.mutex);
+
+    auto &stats = slot.taskStats[static_cast<size_t>(type)];
+    stats.count++;
+    stats.totalWaitMs += waitMs;
+    stats.maxWaitMs = std::max(stats.maxWaitMs, waitMs);
+    stats.totalRunMs += runMs;
+    stats.maxRunMs = std::max(stats.maxRunMs, runMs);
+
+    slot.worker.jobsRun++;
+    slot.worker.busyMs += runMs;
+}
+
+void TaskTelemetry::recordOutcome(TaskType type, int workerIndex, TaskOutcome outcome)
+{
+    if (outcome != TaskOutcome::Failed && outcome != TaskOutcome::Cancelled) return;
+
+    auto &slot = getSlot(workerIndex);
+    std::unique_lock<std::mutex> lock(slot.mutex);
+
+    auto &stats = slot.taskStats[static_cast<size_t>(type)];
+    if (outcome == TaskOutcome::Failed) stats.failed++;
+    else stats.cancelled++;
+}
+
+void TaskTelemetry::recordQueueDepth(const std::array<size_t, TASK_PRIORITY_COUNT> &depthByPriority,
+    size_t mainThreadQueue)
+{
+    std::unique_lock<std::mutex> lock(m_depthMutex);
+    m_depthSamples.push_back({
+        .timeMs = getElapsedMs(),
+        .depthByPriority = depthByPriority,
+        .mainThreadQueue = mainThreadQueue,
+    });
+    if (m_depthSamples.size() > MAX_DEPTH_SAMPLES) m_depthSamples.pop_front();
+}
+
+TaskTypeStats TaskTelemetry::getTaskTypeStats(TaskType type) const
+{
+    TaskTypeStats total;
+    for (const auto &slot : m_slots)
+    {
+        std::unique_lock<std::mutex> lock(slot->mutex);
+        const auto &stats = slot->taskStats[static_cast<size_t>(type)];
+        total.count += stats.count;
+        total.failed += stats.failed;
+        total.cancelled += stats.cancelled;
+        total.totalWaitMs += stats.totalWaitMs;
+        total.maxWaitMs = std::max(total.maxWaitMs, stats.maxWaitMs);
+        total.totalRunMs += stats.totalRunMs;
+        total.maxRunMs = std::max(total.maxRunMs, stats.maxRunMs);
+    }
+    return total;
+}
+
+std::vector<WorkerStats> TaskTelemetry::getWorkerStats() const
+{
+    const double elapsedMs = getElapsedMs();
+
+    std::vector<WorkerStats> workers;
+    for (size_t i = 0; i + 1 < m_slots.size(); ++i)
+    {
+        std::unique_lock<std::mutex> lock(m_slots[i]->mutex);
+        auto stats = m_slots[i]->worker;
+        stats.utilisation = elapsedMs > 0.0 ? stats.busyMs / elapsedMs : 0.0;
+        workers.push_back(stats);
+    }
+    return workers;
+}
+
+std::vector<QueueDepthSample> TaskTelemetry::getQueueDepthHistory() const
+{
+    std::unique_lock<std::mutex> lock(m_depthMutex);
+    return {m_depthSamples.begin(), m_depthSamples.end()};
+}
+
+bool TaskTelemetry::writeJson(const fs::path &path) const
+{
+    std::ofstream file(path);
+    if (!file.is_open())
+    {
+        SKY_CORE_ERROR("Failed to open task telemetry file: {0}", path.string());
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"durationMs\": " << getElapsedMs() << ",\n";
+
+    file << "  \"taskTypes\": {";
+    bool first = true;
+    for (size_t i = 0; i < TASK_TYPE_COUNT; ++i)
+    {
+        const auto type = static_cast<TaskType>(i);
+        const auto stats = getTaskTypeStats(type);
+        if (stats.count == 0 && stats.failed == 0 && stats.cancelled == 0) continue;
+
+        file << (first ? "\n" : ",\n");
+        file << "    \"" << taskTypeToString(type) << "\": {"
+             << "\"count\": " << stats.count << ", "
+             << "\"failed\": " << stats.failed << ", "
+             << "\"cancelled\": " << stats.cancelled << ", "
+             << "\"avgWaitMs\": " << stats.getAverageWaitMs() << ", "
+             << "\"maxWaitMs\": " << stats.maxWaitMs << ", "
+             << "\"avgRunMs\": " << stats.getAverageRunMs() << ", "
+             << "\"maxRunMs\": " << stats.maxRunMs << "}";
+        first = false;
+    }
+    file << "\n  },\n";
+
+    file << "  \"workers\": [";
+    const auto workers = getWorkerStats();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\"jobsRun\": " << workers[i].jobsRun << ", "
+             << "\"busyMs\": " << workers[i].busyMs << ", "
+             << "\"utilisation\": " << workers[i].utilisation << "}";
+    }
+    file << "\n  ],\n";
+
+    file << "  \"queueDepth\": [";
+    const auto samples = getQueueDepthHistory();
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const auto &sample = samples[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\"timeMs\": " << sample.timeMs << ", "
+             << "\"interactive\": " << sample.depthByPriority[static_cast<size_t>(TaskPriority::Interactive)] << ", "
+             << "\"visible\": " << sample.depthByPriority[static_cast<size_t>(TaskPriority::Visible)] << ", "
+             << "\"background\": " << sample.depthByPriority[static_cast<size_t>(TaskPriority::Background)] << ", "
+             << "\"mainThread\": " << sample.mainThreadQueue << "}";
+    }
+    file << "\n  ]\n";
+    file << "}\n";
+
+    return true;
+}
+} // namespace sky
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <skypch.h>
+#include "core/filesystem.h"
+#include "task.h"
+
+namespace sky
+{
+struct TaskTypeStats
+{
+    uint64_t count = 0; // jobs run
+    uint64_t failed = 0;
+    uint64_t cancelled = 0;
+    double totalWaitMs = 0.0; // queued until picked up by a thread
+    double maxWaitMs = 0.0;
+    double totalRunMs = 0.0;
+    double maxRunMs = 0.0;
+
+    double getAverageWaitMs() const { return count ? totalWaitMs / count : 0.0; }
+    double getAverageRunMs() const { return count ? totalRunMs / count : 0.0; }
+};
+
+struct WorkerStats
+{
+    uint64_t jobsRun = 0;
+    double busyMs = 0.0;
+    double utilisation = 0.0; // busy time over time since the pool started, 0..1
+};
+
+struct QueueDepthSample
+{
+    double timeMs = 0.0;
+    std::array<size_t, TASK_PRIORITY_COUNT> depthByPriority{};
+    size_t mainThreadQueue = 0;
+};
+
+// Per task type and per worker timings gathered by the TaskManager. Every worker writes into
+// its own slot, so recording never contends across workers; readers merge the slots.
+class TaskTelemetry
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t MAX_DEPTH_SAMPLES = 36000; // ten minutes at 60 fps
+
+    TaskTelemetry(size_t workerCount);
+
+    // workerIndex is -1 for jobs run by threads outside the pool (parallelFor callers)
+    void recordJob(TaskType type, int workerIndex, double waitMs, double runMs);
+    void recordOutcome(TaskType type, int workerIndex, TaskOutcome outcome);
+    void recordQueueDepth(const std::array<size_t, TASK_PRIORITY_COUNT> &depthByPriority, size_t mainThreadQueue);
+
+    TaskTypeStats getTaskTypeStats(TaskType type) const;
+    std::vector<WorkerStats> getWorkerStats() const;
+    std::vector<QueueDepthSample> getQueueDepthHistory() const;
+
+    bool writeJson(const fs::path &path) const;
+
+  private:
+    struct Slot
+    {
+        std::array<TaskTypeStats, TASK_TYPE_COUNT> taskStats{};
+        WorkerStats worker;
+        mutable std::mutex mutex;
+    };
+
+    Slot &getSlot(int workerIndex);
+    double getElapsedMs() const;
+
+  private:
+    Clock::time_point m_start;
+    std::vector<Scope<Slot>> m_slots; // one per worker, the last one is shared by outside threads
+
+    std::deque<QueueDepthSample> m_depthSamples;
+    mutable std::mutex m_depthMutex;
+};
+} // namespace sky
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <skypch.h>
+
+namespace sky
+{
+// Per-worker job deque. The owning worker pushes and pops at the back (LIFO, cache friendly),
+// other workers steal from the front (FIFO, oldest and usually largest work first).
+template <typename T>
+class WorkStealingQueue
+{
+  public:
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_items.push_back(std::move(item));
+    }
+
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_items.empty()) return false;
+
+        item = std::move(m_items.back());
+        m_items.pop_back();
+        return true;
+    }
+
+    bool steal(T &item)
+    {
+        // thieves never wait on a busy queue, they just move on to the next victim
+        std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+        if (!lock || m_items.empty()) return false;
+
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        return true;
+    }
+
+    size_t size() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_items.size();
+    }
+
+  private:
+    std::deque<T> m_items;
+    mutable std::mutex m_mutex;
+};
+} // namespace sky
@@ -2,9 +2,21 @@
 
 namespace sky
 {
-static std::random_device s_randomDevice;
-static std::mt19937_64 s_randomEngine(s_randomDevice());
-static std::uniform_int_distribution<uint64_t> s_uniformDistribution;
+// one engine per thread, handles are generated from asset loads running on the task workers.
+// Only seeding touches shared state.
+static std::mt19937_64 &getRandomEngine()
+{
+    thread_local std::mt19937_64 s_randomEngine = []
+    {
+        static std::random_device s_randomDevice;
+        static std::mutex s_seedMutex;
+
+        std::unique_lock<std::mutex> lock(s_seedMutex);
+        std::seed_seq seed{s_randomDevice(), s_randomDevice(), s_randomDevice(), s_randomDevice()};
+        return std::mt19937_64(seed);
+    }();
+    return s_randomEngine;
+}
 
 UUID::UUID() : m_uuid(NULL_UUID) {}
 
@@ -12,7 +24,8 @@ UUID::UUID(uint64_t uuid) : m_uuid(uuid) {}
 
 const UUID UUID::generate() 
 {
-	return s_uniformDistribution(s_randomEngine);
+    std::uniform_int_distribution<uint64_t> distribution;
+	return distribution(getRandomEngine());
 }
 
 const std::string UUID::toString() const { return std::to_string(m_uuid); }
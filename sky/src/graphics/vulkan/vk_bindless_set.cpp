@@ -46,8 +46,9 @@ void BindlessSetManager::init(VkDevice device, float maxAnisotropy)
             },
         }};
 
-        const VkDescriptorBindingFlags bindlessFlags = 
-            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+        // slots are written while frames in flight sample the others
+        const VkDescriptorBindingFlags bindlessFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
         const auto bindingFlags = std::array{bindlessFlags, bindlessFlags};
 
         const auto flagInfo = VkDescriptorSetLayoutBindingFlagsCreateInfo{
@@ -119,6 +120,8 @@ void BindlessSetManager::initDefaultSamplers(VkDevice device, float maxAnisotrop
             // TODO: make possible to disable anisotropy or set other values?
             .anisotropyEnable = VK_TRUE,
             .maxAnisotropy = maxAnisotropy,
+            // every level of mipmapped images, maxLod 0 would clamp sampling to level 0
+            .maxLod = VK_LOD_CLAMP_NONE,
         };
 
         VK_CHECK(vkCreateSampler(device, &samplerCreateInfo, nullptr, &linearSampler));
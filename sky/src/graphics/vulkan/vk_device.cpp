@@ -98,12 +98,14 @@ void Device::initVulkan()
         //.geometryShader = VK_TRUE, // for im3d
         .depthClamp = VK_TRUE,
         .samplerAnisotropy = VK_TRUE,
+        .textureCompressionBC = VK_TRUE, // cooked textures
         .fragmentStoresAndAtomics = VK_TRUE,
     };
     const auto features12 = VkPhysicalDeviceVulkan12Features{
         .descriptorIndexing = true,
         .descriptorBindingSampledImageUpdateAfterBind = true,
         .descriptorBindingStorageImageUpdateAfterBind = true,
+        .descriptorBindingUpdateUnusedWhilePending = true,
         .descriptorBindingPartiallyBound = true,
         .descriptorBindingVariableDescriptorCount = true,
         .runtimeDescriptorArray = true,
@@ -436,6 +438,31 @@ ImageID Device::createImage(const vkutil::CreateImageInfo& createInfo, void* pix
     return m_imageCache.addImage(std::move(image));
 }
 
+ImageID Device::createImageWithMips(const vkutil::CreateImageInfo &createInfo, const void *pixelData,
+    std::span<const ImageMipLevel> levels, ImageID imageId)
+{
+    auto image = createImageRaw(createInfo);
+    if (pixelData && !levels.empty())
+    {
+        uploadImageMips(image, pixelData, levels, createInfo.mipMap ? createInfo.numMipLevels : 1);
+    }
+    if (imageId != NULL_IMAGE_ID)
+    {
+        return m_imageCache.addImage(imageId, std::move(image));
+    }
+    return m_imageCache.addImage(std::move(image));
+}
+
+void Device::replaceImage(ImageID id, const vkutil::CreateImageInfo &createInfo, void *pixelData,
+    std::span<const ImageMipLevel> levels)
+{
+    // frames in flight may still sample the old image
+    vkDeviceWaitIdle(m_device);
+    destroyImage(m_imageCache.getImage(id));
+    if (levels.empty()) createImage(createInfo, pixelData, id);
+    else createImageWithMips(createInfo, pixelData, levels, id);
+}
+
 AllocatedImage Device::createImageRaw(const vkutil::CreateImageInfo &createInfo) const 
 { 
     std::uint32_t mipLevels = 1;
@@ -588,6 +615,183 @@ void Device::uploadImageData(const AllocatedImage &image, void *pixelData, std::
     destroyBuffer(uploadBuffer);
 }
 
+// one copy region per level from the upload buffer, levels past the cooked ones are blitted
+static void recordImageMipsUpload(VkCommandBuffer cmd, const AllocatedImage &image, const AllocatedBuffer &uploadBuffer,
+    std::span<const ImageMipLevel> levels, std::uint32_t mipLevels)
+{
+    const auto levelCount = std::min<std::size_t>(levels.size(), mipLevels);
+    std::vector<VkBufferImageCopy> copyRegions(levelCount);
+    for (std::size_t i = 0; i < levelCount; ++i)
+    {
+        copyRegions[i] = VkBufferImageCopy{
+            .bufferOffset = levels[i].offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource =
+                {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = static_cast<std::uint32_t>(i),
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .imageExtent = {levels[i].width, levels[i].height, 1},
+        };
+    }
+
+    vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    vkCmdCopyBufferToImage(cmd, uploadBuffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        static_cast<std::uint32_t>(copyRegions.size()), copyRegions.data());
+
+    // only level 0 was cooked, the rest comes from the blit chain
+    if (levelCount < mipLevels)
+        vkutil::generateMipmaps(cmd, image.image, image.getExtent2D(), mipLevels);
+    else
+        vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void Device::uploadImageMips(const AllocatedImage &image, const void *pixelData, std::span<const ImageMipLevel> levels,
+    std::uint32_t mipLevels)
+{
+    const auto dataSize = levels.back().offset + levels.back().size;
+
+    const auto uploadBuffer = createBuffer(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_AUTO);
+    memcpy(uploadBuffer.info.pMappedData, pixelData, dataSize);
+
+    immediateSubmit([&](VkCommandBuffer cmd) { recordImageMipsUpload(cmd, image, uploadBuffer, levels, mipLevels); });
+
+    destroyBuffer(uploadBuffer);
+}
+
+AllocatedImage Device::createImageWithMips(VkCommandBuffer cmd, const vkutil::CreateImageInfo &createInfo,
+    const void *pixelData, std::span<const ImageMipLevel> levels, AllocatedBuffer &uploadBuffer)
+{
+    auto image = createImageRaw(createInfo);
+
+    const auto dataSize = levels.back().offset + levels.back().size;
+    uploadBuffer = createBuffer(dataSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_AUTO);
+    memcpy(uploadBuffer.info.pMappedData, pixelData, dataSize);
+    recordImageMipsUpload(cmd, image, uploadBuffer, levels, createInfo.mipMap ? createInfo.numMipLevels : 1);
+    return image;
+}
+
+AllocatedImage Device::swapImage(ImageID id, const AllocatedImage &image)
+{
+    auto previous = m_imageCache.getImage(id);
+    m_imageCache.addImage(id, image);
+    return previous;
+}
+
+static std::uint32_t getPixelSize(VkFormat format)
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8_UNORM: return 1;
+    case VK_FORMAT_R16G16B16A16_SFLOAT: return 8;
+    case VK_FORMAT_R32G32B32A32_SFLOAT: return 16;
+    default: return 4;
+    }
+}
+
+// one region per level covering every layer, the layers of a level are packed one after another
+static std::vector<VkBufferImageCopy> getLayerCopyRegions(const AllocatedImage &image, std::uint32_t mipLevels,
+    std::uint32_t numLayers)
+{
+    std::vector<VkBufferImageCopy> regions(mipLevels);
+    VkDeviceSize offset = 0;
+    for (std::uint32_t mip = 0; mip < mipLevels; ++mip)
+    {
+        const auto width = std::max(1u, image.imageExtent.width >> mip);
+        const auto height = std::max(1u, image.imageExtent.height >> mip);
+        regions[mip] = VkBufferImageCopy{
+            .bufferOffset = offset,
+            .imageSubresource =
+                {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = mip,
+                    .baseArrayLayer = 0,
+                    .layerCount = numLayers,
+                },
+            .imageExtent = {width, height, 1},
+        };
+        offset += VkDeviceSize(width) * height * numLayers * getPixelSize(image.imageFormat);
+    }
+    return regions;
+}
+
+std::uint64_t Device::getImageLayersSize(VkFormat format, VkExtent2D extent, std::uint32_t mipLevels,
+    std::uint32_t numLayers)
+{
+    std::uint64_t size = 0;
+    for (std::uint32_t mip = 0; mip < mipLevels; ++mip)
+        size += std::uint64_t(std::max(1u, extent.width >> mip)) * std::max(1u, extent.height >> mip);
+    return size * numLayers * getPixelSize(format);
+}
+
+std::vector<std::uint8_t> Device::readImageLayers(ImageID id, std::uint32_t mipLevels, std::uint32_t numLayers,
+    VkImageLayout layout)
+{
+    ZoneScopedN("Read image layers");
+    const auto image = getImage(id);
+    const auto regions = getLayerCopyRegions(image, mipLevels, numLayers);
+    std::vector<std::uint8_t> data(
+        getImageLayersSize(image.imageFormat, image.getExtent2D(), mipLevels, numLayers));
+
+    // read back on the CPU, which wants cached memory rather than the write combined kind
+    const VkBufferCreateInfo bufferInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = data.size(),
+        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    const VmaAllocationCreateInfo allocInfo = {
+        .flags = VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+    };
+    AllocatedBuffer readback;
+    VK_CHECK(vmaCreateBuffer(m_allocator, &bufferInfo, &allocInfo, &readback.buffer, &readback.allocation,
+        &readback.info));
+
+    // the barriers also wait for frames submitted earlier that wrote the image
+    immediateSubmit(
+        [&](VkCommandBuffer cmd)
+        {
+            vkutil::transitionImage(cmd, image.image, layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+            vkCmdCopyImageToBuffer(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.buffer,
+                static_cast<std::uint32_t>(regions.size()), regions.data());
+            vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, layout);
+        });
+
+    vmaInvalidateAllocation(m_allocator, readback.allocation, 0, VK_WHOLE_SIZE);
+    memcpy(data.data(), readback.info.pMappedData, data.size());
+    destroyBuffer(readback);
+    return data;
+}
+
+void Device::uploadImageLayers(ImageID id, std::span<const std::uint8_t> data, std::uint32_t mipLevels,
+    std::uint32_t numLayers, VkImageLayout layout)
+{
+    ZoneScopedN("Upload image layers");
+    const auto image = getImage(id);
+    const auto regions = getLayerCopyRegions(image, mipLevels, numLayers);
+    assert(data.size() >= getImageLayersSize(image.imageFormat, image.getExtent2D(), mipLevels, numLayers));
+
+    const auto uploadBuffer = createBuffer(data.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_AUTO);
+    memcpy(uploadBuffer.info.pMappedData, data.data(), data.size());
+
+    immediateSubmit(
+        [&](VkCommandBuffer cmd)
+        {
+            vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            vkCmdCopyBufferToImage(cmd, uploadBuffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<std::uint32_t>(regions.size()), regions.data());
+            vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layout);
+        });
+
+    destroyBuffer(uploadBuffer);
+}
+
 AllocatedImage Device::getImage(ImageID id)  
 {
     if (id == NULL_IMAGE_ID) return AllocatedImage{}; 
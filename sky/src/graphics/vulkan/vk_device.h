@@ -128,7 +128,34 @@ class Device
 	
   public:
     ImageID createImage(const vkutil::CreateImageInfo &createInfo, void *pixelData, ImageID imageId = NULL_IMAGE_ID);
+    // levels describe the mip chain in pixelData. When it only holds level 0 the remaining
+    // createInfo.numMipLevels are blitted on the GPU.
+    ImageID createImageWithMips(const vkutil::CreateImageInfo &createInfo, const void *pixelData,
+        std::span<const ImageMipLevel> levels, ImageID imageId = NULL_IMAGE_ID);
+    // Like the above, but the upload is only recorded into cmd and the image gets no id, see swapImage.
+    // uploadBuffer is set to the staging buffer, which has to be kept until cmd has run.
+    AllocatedImage createImageWithMips(VkCommandBuffer cmd, const vkutil::CreateImageInfo &createInfo,
+        const void *pixelData, std::span<const ImageMipLevel> levels, AllocatedBuffer &uploadBuffer);
+    // Puts image behind id and returns the one it replaces, for the caller to destroy once no frame uses it.
+    // Rewrites id's bindless slot, so no pending command buffer may still sample it.
+    AllocatedImage swapImage(ImageID id, const AllocatedImage &image);
+    // Swaps the image behind id, the bindless slot and everything referencing the id stay valid
+    void replaceImage(ImageID id, const vkutil::CreateImageInfo &createInfo, void *pixelData,
+        std::span<const ImageMipLevel> levels = {});
     void uploadImageData(const AllocatedImage &image, void *pixelData, std::uint32_t layer = 0);
+    // one copy region per level, all levels from a single staging buffer
+    void uploadImageMips(const AllocatedImage &image, const void *pixelData, std::span<const ImageMipLevel> levels,
+        std::uint32_t mipLevels);
+    // Copies the first mipLevels levels of every layer into memory, level after level with the layers of a
+    // level one after another. The image has to be in layout and is left in it, waits for the GPU.
+    std::vector<std::uint8_t> readImageLayers(ImageID id, std::uint32_t mipLevels, std::uint32_t numLayers,
+        VkImageLayout layout);
+    // Fills an existing image from data laid out as readImageLayers gives it, the image ends up in layout
+    void uploadImageLayers(ImageID id, std::span<const std::uint8_t> data, std::uint32_t mipLevels,
+        std::uint32_t numLayers, VkImageLayout layout);
+    // bytes of mipLevels levels of numLayers layers of an uncompressed image
+    static std::uint64_t getImageLayersSize(VkFormat format, VkExtent2D extent, std::uint32_t mipLevels,
+        std::uint32_t numLayers);
 	AllocatedImage createImageRaw(const vkutil::CreateImageInfo& createInfo) const;
 	ImageID createImage(const vkutil::CreateImageInfo& createInfo);
 	ImageID createDrawImage(VkFormat format, glm::ivec2 size);
@@ -47,6 +47,15 @@ struct AllocatedImage
     VkExtent2D getExtent2D() const { return VkExtent2D{imageExtent.width, imageExtent.height}; }
 };
 
+// One level of a mip chain stored back to back in a single pixel buffer
+struct ImageMipLevel
+{
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint64_t offset; // bytes from the start of level 0
+    std::uint64_t size;
+};
+
 struct AllocatedBuffer
 {
     VkBuffer buffer;
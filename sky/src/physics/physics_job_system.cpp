@@ -0,0 +1,63 @@
+#include "physics_job_system.h"
+
+#include "core/tasks/task_manager.h"
+
+namespace sky
+{
+namespace physics
+{
+PhysicsJobSystem::PhysicsJobSystem(TaskManager &taskManager, JPH::uint maxJobs, JPH::uint maxBarriers)
+    : JobSystemWithBarrier(maxBarriers), m_taskManager(taskManager)
+{
+    m_jobs.Init(maxJobs, maxJobs);
+}
+
+int PhysicsJobSystem::GetMaxConcurrency() const
+{
+    // the thread waiting on a barrier helps out with the jobs, like JobSystemThreadPool
+    return static_cast<int>(m_taskManager.getWorkerCount()) + 1;
+}
+
+PhysicsJobSystem::JobHandle PhysicsJobSystem::CreateJob(const char *inName, JPH::ColorArg inColor,
+    const JobFunction &inJobFunction, JPH::uint32 inNumDependencies)
+{
+    // the pool only runs dry if a step creates more than maxJobs jobs at once, wait for some to finish
+    JPH::uint32 index;
+    while ((index = m_jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies)) ==
+        AvailableJobs::cInvalidObjectIndex)
+    {
+        JPH_ASSERT(false, "No jobs available!");
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    auto *job = &m_jobs.Get(index);
+
+    // handle keeps a reference, the job may complete as soon as it is queued
+    JobHandle handle(job);
+    if (inNumDependencies == 0) QueueJob(job);
+    return handle;
+}
+
+void PhysicsJobSystem::QueueJob(Job *inJob)
+{
+    // released once executed, the job frees itself through FreeJob when the last reference goes
+    inJob->AddRef();
+    m_taskManager.schedule(
+        [inJob]
+        {
+            inJob->Execute();
+            inJob->Release();
+        },
+        TaskPriority::Interactive, TaskType::Physics);
+}
+
+void PhysicsJobSystem::QueueJobs(Job **inJobs, JPH::uint inNumJobs)
+{
+    for (JPH::uint i = 0; i < inNumJobs; ++i) QueueJob(inJobs[i]);
+}
+
+void PhysicsJobSystem::FreeJob(Job *inJob)
+{
+    m_jobs.DestructObject(inJob);
+}
+} // namespace physics
+} // namespace sky
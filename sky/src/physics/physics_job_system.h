@@ -0,0 +1,40 @@
+#pragma once
+
+#include <skypch.h>
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+
+namespace sky
+{
+class TaskManager;
+
+namespace physics
+{
+// Runs Jolt jobs on the engine TaskManager so physics and engine work share one pool.
+// Jolt jobs are queued at interactive priority, a physics step never waits behind imports.
+// Jobs come from a fixed pool allocated up front, like JobSystemThreadPool, not from the heap.
+class PhysicsJobSystem final : public JPH::JobSystemWithBarrier
+{
+  public:
+    PhysicsJobSystem(TaskManager &taskManager, JPH::uint maxJobs, JPH::uint maxBarriers);
+    ~PhysicsJobSystem() override = default;
+
+    int GetMaxConcurrency() const override;
+    JobHandle CreateJob(const char *inName, JPH::ColorArg inColor, const JobFunction &inJobFunction,
+        JPH::uint32 inNumDependencies = 0) override;
+
+  protected:
+    void QueueJob(Job *inJob) override;
+    void QueueJobs(Job **inJobs, JPH::uint inNumJobs) override;
+    void FreeJob(Job *inJob) override;
+
+  private:
+    using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+
+    TaskManager &m_taskManager;
+    AvailableJobs m_jobs;
+};
+} // namespace physics
+} // namespace sky
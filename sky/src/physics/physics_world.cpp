@@ -4,7 +4,6 @@
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
@@ -27,10 +26,12 @@
 #include "Jolt/Physics/Body/BodyManager.h"
 #include "core/uuid.h"
 #include "physics_debug_renderer.h"
+#include "physics_job_system.h"
 #include "scene/scene.h"
 #include "scene/components.h"
 #include "scene/entity.h"
 #include "core/log/log.h"
+#include "core/application.h"
 
 namespace sky
 {
@@ -224,8 +225,8 @@ PhysicsWorld::PhysicsWorld()
     // every frame or when e.g. streaming in a new level section as it is an expensive operation. Instead insert all new
     // objects in batches instead of 1 at a time to keep the broad phase efficient.
     m_joltPhysicsSystem->OptimizeBroadPhase();
-    const uint32_t availableThreads = std::thread::hardware_concurrency() - 1;
-    m_joltJobSystem = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, availableThreads);
+    // share the engine worker pool instead of spawning a second set of threads
+    m_joltJobSystem = new PhysicsJobSystem(*Application::getTaskManager(), JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
 }
 
 void PhysicsWorld::drawDebug(PhysicsDebugRenderer *debugRenderer)
@@ -10,7 +10,7 @@
 namespace JPH
 {
 class PhysicsSystem;
-class JobSystemThreadPool;
+class JobSystem;
 class ContactListener;
 class BodyInterface;
 class Shape;
@@ -50,7 +50,7 @@ class PhysicsWorld
 
   private:
     Ref<JPH::PhysicsSystem> m_joltPhysicsSystem;
-    JPH::JobSystemThreadPool *m_joltJobSystem;
+    JPH::JobSystem *m_joltJobSystem;
     JPH::BodyInterface *m_joltBodyInterface;
     BPLayerInterfaceImpl *m_joltBroadphaseLayerInterface;
 
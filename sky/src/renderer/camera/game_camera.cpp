@@ -285,7 +285,7 @@ ImageID GameCamera::getPreviewImage()
         .mousePos = {0.f, 0.f},
 		.ambientColor = LinearColorNoAlpha::white(),
 		.ambientIntensity = 0.4f,
-        .irradianceMapId  = renderer->getIBL().getIrradianceMapId(),
+        .irradianceSH  = renderer->getIBL().getIrradianceSH(),
         .prefilterMapId  = renderer->getIBL().getPrefilterMapId(),
         .brdfLutId  = renderer->getIBL().getBrdfLutId(),
 		.lightsBuffer = lightCache.getBuffer().address,
@@ -1,59 +1,309 @@
 #include "image_based_lighting.h"
 
+#include "core/application.h"
+#include "core/helpers/block_compression.h"
+#include "core/helpers/hash.h"
+#include "core/helpers/image.h"
+#include "core/helpers/mapped_file.h"
+#include "core/helpers/pixel_conversion.h"
+#include "core/project_management/project_manager.h"
+#include "core/uuid.h"
 #include "graphics/vulkan/vk_types.h"
 
-namespace sky 
+#include <cstring>
+#include <tracy/Tracy.hpp>
+
+namespace sky
+{
+namespace
+{
+constexpr VkFormat BAKE_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+constexpr uint32_t ENVIRONMENT_SIZE = 512;
+constexpr uint32_t PREFILTER_SIZE = 1024;
+constexpr uint32_t PREFILTER_MIPS = 5;
+constexpr uint32_t BRDF_LUT_SIZE = 512;
+// bump when a bake shader or the file layout changes, bakes cached before are made again
+constexpr uint32_t BAKE_VERSION = 3;
+
+// layout: BakeHeader | the images, each as Device::readImageLayers gives it
+constexpr uint32_t BAKE_MAGIC = 0x49594B53; // "SKYI"
+
+struct BakeHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t size; // of the images
+    math::SH9Color irradianceSH; // of the environment, zero for the BRDF LUT
+};
+
+uint64_t getSettingsHash()
+{
+    uint64_t hash = helper::hashCombine(BAKE_VERSION, BAKE_FORMAT);
+    for (const uint64_t value : {ENVIRONMENT_SIZE, PREFILTER_SIZE, PREFILTER_MIPS, BRDF_LUT_SIZE})
+        hash = helper::hashCombine(hash, value);
+    return hash;
+}
+
+fs::path getBakePath(uint64_t key)
+{
+    return ProjectManager::getConfig().getIblCachePath() / std::format("{:016x}.ibl", key);
+}
+
+uint64_t getEnvironmentKey(uint64_t contentHash)
+{
+    return contentHash != 0 ? helper::hashCombine(contentHash, getSettingsHash()) : 0;
+}
+
+// the header of the bake cached under key, when there is a current one
+bool readBakeHeader(const helper::MappedFile &file, uint64_t key, BakeHeader &header)
+{
+    if (file.size() < sizeof(header)) return false;
+    std::memcpy(&header, file.data(), sizeof(header));
+    return header.magic == BAKE_MAGIC && header.version == BAKE_VERSION && header.key == key;
+}
+
+uint64_t getBakeSize(gfx::Device &device, std::span<const ImageBasedLighting::BakeImage> images)
 {
+    uint64_t size = 0;
+    for (const auto &image : images)
+        size += gfx::Device::getImageLayersSize(BAKE_FORMAT, device.getImage(image.id).getExtent2D(), image.mipLevels,
+            image.numLayers);
+    return size;
+}
+
+// diffuse lighting from the environment's pixels, whatever they were cooked to
+math::SH9Color projectIrradiance(const TextureCube &texture)
+{
+    const auto taskManager = Application::getTaskManager().get();
+    const auto width = uint32_t(texture.width), height = uint32_t(texture.height);
+    const size_t count = size_t(width) * height;
+
+    std::vector<float> decoded;
+    const float *pixels = reinterpret_cast<const float *>(texture.pixels);
+    if (texture.format != TextureFormat::RGBA32Float)
+    {
+        decoded.resize(count * 4);
+        switch (texture.format)
+        {
+        case TextureFormat::RGBA16Float:
+            helper::convertFromHalf(reinterpret_cast<const uint16_t *>(texture.pixels), count * 4, decoded.data());
+            break;
+        case TextureFormat::RGB9E5Float:
+            helper::convertFromRGB9E5(reinterpret_cast<const uint32_t *>(texture.pixels), count, decoded.data());
+            break;
+        case TextureFormat::BC6HUfloat:
+        {
+            const auto halves =
+                helper::decompressBC6H({texture.pixels, texture.getPixelDataSize()}, width, height, taskManager);
+            helper::convertFromHalf(halves.data(), halves.size(), decoded.data());
+            break;
+        }
+        default: break;
+        }
+        pixels = decoded.data();
+    }
+    return math::convolveIrradianceSH9(math::projectEquirectToSH9({pixels, count * 4}, width, height, taskManager));
+}
+} // namespace
+
 void ImageBasedLighting::init(gfx::Device &device)
 {
-    m_equirectangularToCubemapPass.init(device, VK_FORMAT_R16G16B16A16_SFLOAT, {512, 512});
-    m_irradiancePass.init(device, VK_FORMAT_R16G16B16A16_SFLOAT, 32);
-    m_prefilterEnvmapPass.init(device, VK_FORMAT_R16G16B16A16_SFLOAT, 1024, 5);
-    m_brdfLutPass.init(device, VK_FORMAT_R16G16B16A16_SFLOAT, 512);
-    m_skyboxPass.init(device, VK_FORMAT_R16G16B16A16_SFLOAT);
+    m_equirectangularToCubemapPass.init(device, BAKE_FORMAT, {ENVIRONMENT_SIZE, ENVIRONMENT_SIZE});
+    m_prefilterEnvmapPass.init(device, BAKE_FORMAT, PREFILTER_SIZE, PREFILTER_MIPS);
+    m_brdfLutPass.init(device, BAKE_FORMAT, BRDF_LUT_SIZE);
+    m_skyboxPass.init(device, BAKE_FORMAT);
+}
+
+void ImageBasedLighting::prepareEnvironment(TextureCube &texture)
+{
+    if (texture.pixels == nullptr || texture.irradianceSH) return;
+
+    // a cube baked before has its lighting in the bake's header
+    const auto key = getEnvironmentKey(texture.getContentHash());
+    helper::MappedFile file;
+    BakeHeader header{};
+    if (key != 0 && file.open(getBakePath(key)) && readBakeHeader(file, key, header))
+    {
+        texture.irradianceSH = header.irradianceSH;
+        return;
+    }
+
+    ZoneScopedN("Project IBL irradiance");
+    texture.irradianceSH = projectIrradiance(texture);
+}
+
+void ImageBasedLighting::setEnvironment(const Ref<TextureCube> &texture)
+{
+    if (texture == nullptr)
+    {
+        setHdrImageId(NULL_IMAGE_ID);
+        return;
+    }
+
+    // both were made by prepareEnvironment when the cube was loaded
+    if (!texture->irradianceSH) SKY_CORE_WARN("Environment {} has no diffuse lighting", texture->handle.toString());
+    m_irradianceSH = texture->irradianceSH.value_or(math::SH9Color{});
+    m_hdrImageId = helper::loadImageFromTexture(texture, VK_FORMAT_R32G32B32A32_SFLOAT);
+    m_environmentKey = getEnvironmentKey(texture->contentHash);
+    m_dirty = true;
+}
+
+// the layouts are the ones a bake leaves the images in
+std::array<ImageBasedLighting::BakeImage, 2> ImageBasedLighting::getEnvironmentImages() const
+{
+    return {{
+        {m_equirectangularToCubemapPass.getCubemapId(), 1, 6, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+        {m_prefilterEnvmapPass.getCubemapId(), PREFILTER_MIPS, 6, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+    }};
+}
+
+std::array<ImageBasedLighting::BakeImage, 1> ImageBasedLighting::getBrdfLutImages() const
+{
+    return {{{m_brdfLutPass.getLutId(), 1, 1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL}}};
+}
+
+bool ImageBasedLighting::loadBake(gfx::Device &device, uint64_t key, std::span<const BakeImage> images)
+{
+    ZoneScopedN("Load IBL bake");
+    helper::MappedFile file;
+    if (!file.open(getBakePath(key))) return false;
+
+    BakeHeader header{};
+    const uint64_t size = getBakeSize(device, images);
+    if (!readBakeHeader(file, key, header) || header.size != size || file.size() - sizeof(header) < size)
+    {
+        SKY_CORE_WARN("IBL bake cache {} is stale, baking again", getBakePath(key).string());
+        return false;
+    }
+
+    // frames in flight may still sample the images
+    vkDeviceWaitIdle(device.getDevice());
+    const uint8_t *data = file.data() + sizeof(header);
+    for (const auto &image : images)
+    {
+        const auto imageSize = gfx::Device::getImageLayersSize(BAKE_FORMAT, device.getImage(image.id).getExtent2D(),
+            image.mipLevels, image.numLayers);
+        device.uploadImageLayers(image.id, {data, imageSize}, image.mipLevels, image.numLayers, image.layout);
+        data += imageSize;
+    }
+    return true;
+}
+
+void ImageBasedLighting::saveBake(gfx::Device &device, uint64_t key, std::span<const BakeImage> images,
+    const math::SH9Color &irradianceSH)
+{
+    ZoneScopedN("Save IBL bake");
+    const auto header = BakeHeader{
+        .magic = BAKE_MAGIC,
+        .version = BAKE_VERSION,
+        .key = key,
+        .size = getBakeSize(device, images),
+        .irradianceSH = irradianceSH,
+    };
+    std::vector<uint8_t> data(sizeof(header));
+    std::memcpy(data.data(), &header, sizeof(header));
+    data.reserve(sizeof(header) + header.size);
+    for (const auto &image : images)
+    {
+        const auto layers = device.readImageLayers(image.id, image.mipLevels, image.numLayers, image.layout);
+        data.insert(data.end(), layers.begin(), layers.end());
+    }
+
+    // tens of megabytes, written off the render thread
+    Application::getTaskManager()->schedule(
+        [path = getBakePath(key), data = std::move(data)]
+        {
+            ZoneScopedN("Write IBL bake");
+            std::error_code error;
+            fs::create_directories(path.parent_path(), error);
+
+            // renamed into place so a half written bake is never loaded
+            const auto tmp = fs::path(path.string() + ".tmp-" + UUID::generate().toString());
+            {
+                std::ofstream file(tmp, std::ios::binary);
+                file.write(reinterpret_cast<const char *>(data.data()), data.size());
+                if (!file.good())
+                {
+                    SKY_CORE_WARN("Failed to write IBL bake cache {}", path.string());
+                    file.close();
+                    fs::remove(tmp, error);
+                    return;
+                }
+            }
+            fs::rename(tmp, path, error);
+            if (error) fs::remove(tmp, error);
+        },
+        TaskPriority::Background);
 }
 
 void ImageBasedLighting::draw(gfx::Device &device, gfx::CommandBuffer cmd, const gfx::AllocatedBuffer &sceneDataBuffer) {
-    if (m_hdrImageId == NULL_IMAGE_ID) 
+    // the bake was recorded into the last frame, which has been submitted since
+    if (m_bakedEnvironmentKey != 0)
+    {
+        saveBake(device, m_bakedEnvironmentKey, getEnvironmentImages(), m_bakedIrradianceSH);
+        m_bakedEnvironmentKey = 0;
+    }
+    if (m_bakedBrdfLutKey != 0)
+    {
+        saveBake(device, m_bakedBrdfLutKey, getBrdfLutImages(), {});
+        m_bakedBrdfLutKey = 0;
+    }
+
+    if (m_hdrImageId == NULL_IMAGE_ID)
     {
         // TODO! uncomment this
         // reset all passes
         // m_equirectangularToCubemapPass.reset(device, cmd);
-        // m_irradiancePass.reset(device, cmd);
         // m_prefilterEnvmapPass.reset(device, cmd);
         // m_brdfLutPass.reset(device, cmd);
         return;
     }
 
-    if (m_dirty) 
-    { 
-        m_equirectangularToCubemapPass.draw(device, cmd, m_hdrImageId, {512, 512});
-        m_irradiancePass.draw(device, cmd, m_equirectangularToCubemapPass.getCubemapId());
-        m_prefilterEnvmapPass.draw(device, cmd, m_equirectangularToCubemapPass.getCubemapId());
-        m_brdfLutPass.draw(device, cmd);
+    if (m_dirty)
+    {
+        // the LUT does not depend on the environment, it is only made once
+        if (!m_brdfLutReady)
+        {
+            const auto brdfLutKey = getSettingsHash();
+            if (!loadBake(device, brdfLutKey, getBrdfLutImages()))
+            {
+                m_brdfLutPass.draw(device, cmd);
+                m_bakedBrdfLutKey = brdfLutKey;
+            }
+            m_brdfLutReady = true;
+        }
+
+        if (m_environmentKey == 0 || !loadBake(device, m_environmentKey, getEnvironmentImages()))
+        {
+            ZoneScopedN("Bake IBL");
+            m_equirectangularToCubemapPass.draw(device, cmd, m_hdrImageId, {ENVIRONMENT_SIZE, ENVIRONMENT_SIZE});
+            m_prefilterEnvmapPass.draw(device, cmd, m_equirectangularToCubemapPass.getCubemapId());
+            m_bakedEnvironmentKey = m_environmentKey;
+            m_bakedIrradianceSH = m_irradianceSH;
+        }
 
         m_dirty = false;
     }
 }
 
-void ImageBasedLighting::drawSky(gfx::Device &device, 
-    gfx::CommandBuffer cmd, 
+void ImageBasedLighting::drawSky(gfx::Device &device,
+    gfx::CommandBuffer cmd,
     VkExtent2D extent,
     const gfx::AllocatedBuffer &sceneDataBuffer)
 {
     if (m_hdrImageId == NULL_IMAGE_ID) return;
-    m_skyboxPass.draw(device, 
-        cmd, 
+    m_skyboxPass.draw(device,
+        cmd,
         extent,
-        m_equirectangularToCubemapPass.getCubemapId(), 
+        m_equirectangularToCubemapPass.getCubemapId(),
         sceneDataBuffer);
 }
 
 void ImageBasedLighting::cleanup(gfx::Device &device)
 {
     m_equirectangularToCubemapPass.cleanup(device);
-    m_irradiancePass.cleanup(device);
     m_prefilterEnvmapPass.cleanup(device);
     m_skyboxPass.cleanup(device);
 }
-}
\ No newline at end of file
+}
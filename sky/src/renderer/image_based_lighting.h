@@ -4,9 +4,10 @@
 #include "graphics/vulkan/vk_types.h"
 #include "passes/skybox/brdf_lut.h"
 #include "passes/skybox/equirectangular_to_cubemap.h"
-#include "passes/skybox/irradiance.h"
 #include "passes/skybox/skybox.h"
+#include "core/math/spherical_harmonics.h"
 #include "renderer/passes/skybox/prefilering.h"
+#include "renderer/texture.h"
 #include <skypch.h>
 
 namespace sky 
@@ -22,20 +23,54 @@ class ImageBasedLighting
         const gfx::AllocatedBuffer &sceneDataBuffer);
     void cleanup(gfx::Device &device);
 
-    void setHdrImageId(ImageID imageId) { m_hdrImageId = imageId; m_dirty = true; }
+    void setHdrImageId(ImageID imageId)
+    {
+        m_hdrImageId = imageId;
+        m_environmentKey = 0;
+        m_irradianceSH = {};
+        m_dirty = true;
+    }
+    // Uploads the environment, its maps are loaded from the project's IBL cache when it was baked before
+    void setEnvironment(const Ref<TextureCube> &texture);
+    // Hashes a loaded cube's pixels and gets its diffuse lighting, from the IBL cache when it was baked before.
+    // Called on the loading thread, the pixels are released once the cube is uploaded.
+    static void prepareEnvironment(TextureCube &texture);
 
-    auto getIrradianceMapId() { return m_irradiancePass.getCubemapId(); }
+    const math::SH9Color &getIrradianceSH() const { return m_irradianceSH; }
     auto getPrefilterMapId() { return m_prefilterEnvmapPass.getCubemapId(); }
     auto getBrdfLutId() { return m_brdfLutPass.getLutId(); }
 
+    struct BakeImage
+    {
+        ImageID id;
+        uint32_t mipLevels;
+        uint32_t numLayers;
+        VkImageLayout layout;
+    };
+
+  private:
+    std::array<BakeImage, 2> getEnvironmentImages() const;
+    std::array<BakeImage, 1> getBrdfLutImages() const;
+    bool loadBake(gfx::Device &device, uint64_t key, std::span<const BakeImage> images);
+    void saveBake(gfx::Device &device, uint64_t key, std::span<const BakeImage> images,
+        const math::SH9Color &irradianceSH);
+
   private:
     EquirectangularToCubemapPass m_equirectangularToCubemapPass;
     SkyboxPass m_skyboxPass;
     PrefilterEnvmapPass m_prefilterEnvmapPass;
-    IrradiancePass m_irradiancePass;
     BrdfLutPass m_brdfLutPass;
 
     bool m_dirty{false};
     ImageID m_hdrImageId{NULL_IMAGE_ID};
+    math::SH9Color m_irradianceSH{};
+
+    // 0 when the environment is not cached
+    uint64_t m_environmentKey{0};
+    // set when the last frame baked, saved once it was submitted
+    uint64_t m_bakedEnvironmentKey{0};
+    math::SH9Color m_bakedIrradianceSH{};
+    uint64_t m_bakedBrdfLutKey{0};
+    bool m_brdfLutReady{false};
 };
 }
\ No newline at end of file
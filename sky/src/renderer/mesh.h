@@ -68,6 +68,29 @@ struct Mesh
     math::AABB              boundingBox;
 };
 
+// Vertices and indices that live somewhere else, in a mapped cooked file or in a Mesh. They are copied
+// byte for byte into the upload buffer, so they need not be aligned.
+struct MeshDataView
+{
+    std::span<const uint8_t> vertices; // Vertex
+    std::span<const uint8_t> indices;  // uint32_t
+    MaterialID material = NULL_MATERIAL_ID;
+    std::string name;
+
+    size_t getVertexCount() const { return vertices.size() / sizeof(Vertex); }
+    size_t getIndexCount() const { return indices.size() / sizeof(uint32_t); }
+
+    static MeshDataView fromMesh(const Mesh &mesh)
+    {
+        return {
+            .vertices = {reinterpret_cast<const uint8_t *>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex)},
+            .indices = {reinterpret_cast<const uint8_t *>(mesh.indices.data()), mesh.indices.size() * sizeof(uint32_t)},
+            .material = mesh.material,
+            .name = mesh.name,
+        };
+    }
+};
+
 using MeshID = UUID;
 struct Model : public Asset
 {
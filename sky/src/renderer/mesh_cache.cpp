@@ -1,5 +1,7 @@
 #include "mesh_cache.h"
 
+#include <cstring>
+
 #include "core/math/math.h"
 
 namespace sky
@@ -15,20 +17,52 @@ void MeshCache::cleanup(gfx::Device &device)
 
 MeshID MeshCache::addMesh(gfx::Device &device, const Mesh &mesh) 
 {
-    auto n = mesh.name;
+    return addMesh(device, MeshDataView::fromMesh(mesh));
+}
+
+MeshID MeshCache::addMesh(gfx::Device &device, const MeshDataView &mesh)
+{
+    const auto id = UUID::generate();
+    storeMesh(device, id, mesh);
+    return id;
+}
+
+void MeshCache::replaceMesh(gfx::Device &device, MeshID id, const MeshDataView &mesh)
+{
+    removeMesh(device, id);
+    storeMesh(device, id, mesh);
+}
+
+void MeshCache::removeMesh(gfx::Device &device, MeshID id)
+{
+    auto it = m_meshes.find(id);
+    if (it == m_meshes.end()) return;
+
+    // frames in flight may still read the old buffers
+    vkDeviceWaitIdle(device.getDevice());
+    device.destroyBuffer(it->second.vertexBuffer);
+    device.destroyBuffer(it->second.indexBuffer);
+    m_meshes.erase(it);
+    m_CPUMeshes.erase(id);
+}
+
+void MeshCache::storeMesh(gfx::Device &device, MeshID id, const MeshDataView &mesh)
+{
     auto gpuMesh = gfx::GPUMeshBuffers{
-        .numIndices = static_cast<uint32_t>(mesh.indices.size()),
+        .numIndices = static_cast<uint32_t>(mesh.getIndexCount()),
         .materialId = mesh.material,
     };
 
-    std::vector<glm::vec3> positions(mesh.vertices.size());
+    std::vector<glm::vec3> positions(mesh.getVertexCount());
     
     glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
     glm::vec3 max = glm::vec3(std::numeric_limits<float>::min());
 
-    for (std::size_t i = 0; i < mesh.vertices.size(); ++i)
+    for (std::size_t i = 0; i < positions.size(); ++i)
     {
-        positions[i] = mesh.vertices[i].position;
+        // the view may be unaligned
+        std::memcpy(&positions[i], mesh.vertices.data() + i * sizeof(Vertex) + offsetof(Vertex, position),
+            sizeof(glm::vec3));
         min = glm::min(min, positions[i]);
         max = glm::max(max, positions[i]);
     }
@@ -36,18 +70,13 @@ MeshID MeshCache::addMesh(gfx::Device &device, const Mesh &mesh)
     gpuMesh.boundingBox = math::AABB{.min = min, .max = max};
     
     uploadMesh(device, mesh, gpuMesh);
-    const auto id = UUID::generate();
     m_meshes[id] = gpuMesh;
 
     m_CPUMeshes[id] = Mesh{
-        .vertices = mesh.vertices,
-        .indices = mesh.indices,
         .material = mesh.material,
 	    .name = mesh.name,
 	    .boundingBox = gpuMesh.boundingBox,
     };
-
-    return id;
 }
 
 const gfx::GPUMeshBuffers &MeshCache::getMesh(MeshID id) const
@@ -55,10 +84,10 @@ const gfx::GPUMeshBuffers &MeshCache::getMesh(MeshID id) const
     return m_meshes.at(id);
 }   
 
-void MeshCache::uploadMesh(gfx::Device &device, const Mesh &mesh, gfx::GPUMeshBuffers &gpuMesh) const 
+void MeshCache::uploadMesh(gfx::Device &device, const MeshDataView &mesh, gfx::GPUMeshBuffers &gpuMesh) const 
 {
-    const size_t vertexBufferSize = mesh.vertices.size() * sizeof(Vertex);
-    const size_t indexBufferSize = mesh.indices.size() * sizeof(uint32_t);
+    const size_t vertexBufferSize = mesh.vertices.size();
+    const size_t indexBufferSize = mesh.indices.size();
 
     // create vertex buffer
     gpuMesh.vertexBuffer = device.createBuffer(vertexBufferSize,
@@ -77,7 +106,7 @@ void MeshCache::uploadMesh(gfx::Device &device, const Mesh &mesh, gfx::GPUMeshBu
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
             VMA_MEMORY_USAGE_CPU_ONLY);
 
-    // ?         staging.allocation.GetMappedData()   
+    // the only copy on the CPU, a mapped file goes straight from the page cache into the staging buffer
     void *data = staging.info.pMappedData;
     memcpy(data, mesh.vertices.data(), vertexBufferSize);
     memcpy((char *)data + vertexBufferSize, mesh.indices.data(), indexBufferSize);
@@ -17,11 +17,18 @@ class MeshCache
     void cleanup(gfx::Device &gfxDevice);
 
     MeshID addMesh(gfx::Device &gfxDevice, const Mesh &mesh);
+    // Copies the data straight into the upload buffer, it only has to live for the call
+    MeshID addMesh(gfx::Device &gfxDevice, const MeshDataView &mesh);
+    // Uploads new buffers for id, draw commands keep using the same id
+    void replaceMesh(gfx::Device &gfxDevice, MeshID id, const MeshDataView &mesh);
+    void removeMesh(gfx::Device &gfxDevice, MeshID id);
     const gfx::GPUMeshBuffers &getMesh(MeshID id) const;
+    // Material, name and bounds, the vertices and indices are only kept on the GPU
     const Mesh& getCPUMesh(MeshID id) const { return m_CPUMeshes.at(id); }
 
   private:
-    void uploadMesh(gfx::Device &gfxDevice, const Mesh &mesh, gfx::GPUMeshBuffers &gpuMesh) const;
+    void storeMesh(gfx::Device &gfxDevice, MeshID id, const MeshDataView &mesh);
+    void uploadMesh(gfx::Device &gfxDevice, const MeshDataView &mesh, gfx::GPUMeshBuffers &gpuMesh) const;
 
     std::unordered_map<MeshID, gfx::GPUMeshBuffers> m_meshes;
     std::unordered_map<MeshID, Mesh> m_CPUMeshes;
@@ -65,9 +65,17 @@ void ForwardRendererPass::draw(
     gfx::vkutil::setViewportAndScissor(cmd, extent);
 
 	const auto frustum = edge::createFrustumFromCamera(camera);
-    for (const auto &dc : drawCommands)
+
+    // cull on the task pool, small scenes stay under the grain size and run inline
+    std::vector<uint8_t> inFrustum(drawCommands.size());
+    Application::getTaskManager()->parallelFor(0, drawCommands.size(), [&](size_t i) {
+        inFrustum[i] = edge::isInFrustum(frustum, drawCommands[i].worldBoundingSphere);
+    }, CULLING_GRAIN_SIZE);
+
+    for (size_t i = 0; i < drawCommands.size(); i++)
     {
-        if (!edge::isInFrustum(frustum, dc.worldBoundingSphere)) continue;
+        const auto &dc = drawCommands[i];
+        if (!inFrustum[i]) continue;
 
         if (dc.isVisible)
         {    
@@ -50,6 +50,8 @@ class ForwardRendererPass : public Pass
     bool initialized{false};
 
   private:
+    static constexpr size_t CULLING_GRAIN_SIZE = 256;
+
     struct PushConstants
 	{
         glm::mat4 transform;
@@ -37,7 +37,7 @@ void BrdfLutPass::init(gfx::Device& device, VkFormat format, uint32_t size)
     // Create BRDF LUT texture (2D, single mip level)
     auto imageInfo = gfx::vkutil::CreateImageInfo{
         .format = format,
-        .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
         .flags = 0, // Not a cubemap
         .extent = {size, size, 1},
         .numLayers = 1,
@@ -40,7 +40,7 @@ void EquirectangularToCubemapPass::init(gfx::Device &device, VkFormat format, Vk
     // Create a cubemap texture
     auto imageInfo = gfx::vkutil::CreateImageInfo{
         .format = format,
-        .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
         .flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
         .extent = {extent.width, extent.height, 1},
         .numLayers = 6,
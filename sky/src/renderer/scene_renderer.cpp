@@ -43,6 +43,7 @@ SceneRenderer::~SceneRenderer()
     m_ibl.cleanup(m_device);
     m_imguiBackend.cleanup(m_device);
     m_debugLineRenderer.cleanup(m_device);
+    m_textureStreamer.cleanup(m_device);
 }
 
 bool SceneRenderer::isMultisamplingEnabled() const
@@ -151,6 +152,21 @@ MeshID SceneRenderer::addMeshToCache(const Mesh& mesh)
     return m_meshCache.addMesh(m_device, mesh);
 }
 
+MeshID SceneRenderer::addMeshToCache(const MeshDataView &mesh)
+{
+    return m_meshCache.addMesh(m_device, mesh);
+}
+
+void SceneRenderer::replaceMeshInCache(MeshID id, const MeshDataView &mesh)
+{
+    m_meshCache.replaceMesh(m_device, id, mesh);
+}
+
+void SceneRenderer::removeMeshFromCache(MeshID id)
+{
+    m_meshCache.removeMesh(m_device, id);
+}
+
 MaterialID SceneRenderer::addMaterialToCache(const Material &material)
 {
     return m_materialCache.addMaterial(m_device, material);
@@ -304,12 +320,37 @@ void SceneRenderer::drawModel(Ref<Model> model, const glm::mat4 &transform)
     }
 }
 
+Camera *SceneRenderer::getRenderCamera(Ref<Scene> scene, RenderMode mode)
+{
+    return mode == RenderMode::Scene 
+        ? static_cast<Camera*>(SceneManager::get().getEditorCamera())
+        : static_cast<Camera*>(scene->getCameraSystem()->getActiveCameraForRendering());
+}
+
+math::Sphere SceneRenderer::getModelBounds(const Model &model) const
+{
+    // smallest sphere around the mesh spheres that keeps the first center, good enough for scoring
+    if (model.meshes.empty()) return {};
+
+    auto bounds = m_meshCache.getMesh(model.meshes[0]).boundingSphere;
+    for (const auto &id : model.meshes)
+    {
+        const auto &sphere = m_meshCache.getMesh(id).boundingSphere;
+        bounds.radius = std::max(bounds.radius, glm::length(sphere.center - bounds.center) + sphere.radius);
+    }
+    return bounds;
+}
+
+void SceneRenderer::updateStreaming()
+{
+    m_streamingManager.update(*Application::getTaskManager());
+    m_textureStreamer.update(m_device);
+}
+
 void SceneRenderer::render(gfx::CommandBuffer &cmd, Ref<Scene> scene, RenderMode mode) 
 {    
     auto camSystem = scene->getCameraSystem();
-    Camera* cam = mode == RenderMode::Scene 
-        ? static_cast<Camera*>(SceneManager::get().getEditorCamera())
-        : static_cast<Camera*>(camSystem->getActiveCameraForRendering());
+    Camera* cam = getRenderCamera(scene, mode);
 
     if (!cam)
     {
@@ -331,7 +372,7 @@ void SceneRenderer::render(gfx::CommandBuffer &cmd, Ref<Scene> scene, RenderMode
             .mousePos = EditorInfo::get().viewportMousePos,
             .ambientColor = LinearColorNoAlpha::white(),
             .ambientIntensity = 0.3f,
-            .irradianceMapId = m_ibl.getIrradianceMapId(),
+            .irradianceSH = m_ibl.getIrradianceSH(),
             .prefilterMapId = m_ibl.getPrefilterMapId(),
             .brdfLutId = m_ibl.getBrdfLutId(),
             .lightsBuffer = m_lightCache.getBuffer().address,
@@ -355,6 +396,9 @@ void SceneRenderer::render(gfx::CommandBuffer &cmd, Ref<Scene> scene, RenderMode
     const auto &depthImage = m_device.getImage(targets.depth);
     const auto &postFXImage = m_device.getImage(targets.postFX);
 
+    m_textureStreamer.request(m_meshDrawCommands, m_materialCache, *cam, edge::createFrustumFromCamera(*cam),
+        float(drawImage.getExtent2D().height));
+
     gfx::vkutil::transitionImage(cmd, 
         drawImage.image, 
         VK_IMAGE_LAYOUT_UNDEFINED,
@@ -521,10 +565,13 @@ void SceneRenderer::renderImgui(gfx::CommandBuffer &cmd,
     gfx::vkutil::transitionImage(cmd, swapchainImage, swapchainLayout, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 }
 
-void SceneRenderer::update(Ref<Scene> scene) 
+void SceneRenderer::update(Ref<Scene> scene, RenderMode mode) 
 {
     ZoneScopedN("Scene Renderer");
 
+    auto cam = getRenderCamera(scene, mode);
+    const auto frustum = cam ? edge::createFrustumFromCamera(*cam) : Frustum{};
+
     {
 		auto view = scene->getRegistry().view<TransformComponent, ModelComponent, VisibilityComponent>();
 		for (auto &e : view)
@@ -535,19 +582,33 @@ void SceneRenderer::update(Ref<Scene> scene)
 
             if (modelComponent.type == ModelType::Custom)
             {
-				AssetManager::getAssetAsync<Model>(modelComponent.handle, [=, this](const Ref<Model> &model){
-					for (size_t i = 0; i < model->meshes.size(); i++) 
-					{
-                        const auto &mesh = model->meshes[i];
-                        const auto material = modelComponent.customMaterialOverrides.contains(i) 
-                            ? AssetManager::getAsset<MaterialAsset>(modelComponent.customMaterialOverrides.at(i))->material 
-                            : getMesh(mesh).material;
-                        
-                        //! transform.getModelMatrix() will affect parent/child transforms
-                        drawMesh(mesh, transform.getModelMatrix(), visibility,
-                            static_cast<uint32_t>(e), material);
-					}
-				});
+                // not loaded yet, the streaming manager decides when it is
+                if (!AssetManager::isAssetLoaded(modelComponent.handle))
+                {
+                    if (cam && modelComponent.handle != NULL_UUID)
+                    {
+                        const auto bounds = m_streamingManager.estimateWorldBounds(modelComponent.handle,
+                            transform.getModelMatrix());
+                        m_streamingManager.request(modelComponent.handle, bounds, *cam, frustum);
+                    }
+                    continue;
+                }
+
+                const auto model = AssetManager::getAsset<Model>(modelComponent.handle);
+                if (!m_streamingManager.hasModelBounds(modelComponent.handle))
+                    m_streamingManager.setModelBounds(modelComponent.handle, getModelBounds(*model));
+
+                for (size_t i = 0; i < model->meshes.size(); i++) 
+                {
+                    const auto &mesh = model->meshes[i];
+                    const auto material = modelComponent.customMaterialOverrides.contains(i) 
+                        ? AssetManager::getAsset<MaterialAsset>(modelComponent.customMaterialOverrides.at(i))->material 
+                        : getMesh(mesh).material;
+                    
+                    //! transform.getModelMatrix() will affect parent/child transforms
+                    drawMesh(mesh, transform.getModelMatrix(), visibility,
+                        static_cast<uint32_t>(e), material);
+                }
             }
             else
             {
@@ -564,19 +625,34 @@ void SceneRenderer::update(Ref<Scene> scene)
     }
     {
         auto view = scene->getRegistry().view<TransformComponent, SpriteRendererComponent, VisibilityComponent>();
+
+        // every texture is requested before any region is read, packing can move them
+        m_spriteTextures.clear();
+        for (auto &e : view)
+        {
+            const auto &spriteRenderer = view.get<SpriteRendererComponent>(e);
+            auto texture = AssetManager::getAsset<Texture2D>(spriteRenderer.textureHandle);
+            m_spriteAtlas.request(m_device, spriteRenderer.textureHandle, texture);
+            m_spriteTextures.push_back(std::move(texture));
+        }
+        m_spriteAtlas.update(m_device);
+
+        size_t index = 0;
         for (auto &e : view)
         {
             auto [t, spriteRenderer, visibility] =
                 view.get<TransformComponent, SpriteRendererComponent, VisibilityComponent>(e);
             auto transform = t.transform;
 
-            auto texture = AssetManager::getAsset<Texture2D>(spriteRenderer.textureHandle);
+            const auto region = m_spriteAtlas.getRegion(spriteRenderer.textureHandle, m_spriteTextures[index++]);
 			m_spriteRenderer.drawSprite(m_device, {
 				.position = {transform.getPosition().x - 0.5, transform.getPosition().y - 0.5},
 				.size = {transform.getScale().x, transform.getScale().y},
 				.color = spriteRenderer.tint,
 				.rotation = transform.getRotation().z,
-				.textureId = helper::loadImageFromTexture(texture, VK_FORMAT_R8G8B8A8_SRGB),
+				.textureId = region.imageId,
+				.texCoord = region.uvOffset,
+				.texScale = region.uvScale,
                 .uniqueId = static_cast<uint32_t>(e) + 1,
 			});
 		}
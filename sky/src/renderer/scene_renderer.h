@@ -15,7 +15,10 @@
 #include "scene/scene.h"
 #include "material_cache.h"
 #include "renderer/passes/sky_atmosphere.h"
+#include "sprite_atlas.h"
 #include "sprite_renderer.h"
+#include "streaming_manager.h"
+#include "texture_streamer.h"
 
 namespace sky
 {
@@ -49,7 +52,9 @@ class SceneRenderer
     void init(glm::ivec2 size);
     void render(gfx::CommandBuffer &cmd, Ref<Scene> scene, RenderMode mode);
     void renderImgui(gfx::CommandBuffer &cmd, VkImage swapchainImage, uint32_t swapchainImageIndex);
-    void update(Ref<Scene> scene);
+    void update(Ref<Scene> scene, RenderMode mode);
+    // once per frame after every scene was updated, starts the model loads and texture mips the views asked for
+    void updateStreaming();
 
     void initBuiltins();
     void drawMesh(MeshID id, const glm::mat4 &transform, bool visibility, uint32_t uniqueId, MaterialID mat = NULL_MATERIAL_ID);
@@ -57,6 +62,9 @@ class SceneRenderer
     void clearDrawCommands() { m_meshDrawCommands.clear(); }
 
     MeshID addMeshToCache(const Mesh &mesh);
+    MeshID addMeshToCache(const MeshDataView &mesh);
+    void replaceMeshInCache(MeshID id, const MeshDataView &mesh);
+    void removeMeshFromCache(MeshID id);
     MaterialID addMaterialToCache(const Material &material);
     void updateMaterial(MaterialID id, Material material);
     ImageID createImage(const gfx::vkutil::CreateImageInfo &createInfo, void *pixelData);
@@ -83,6 +91,8 @@ class SceneRenderer
     auto getSphereMesh() const { return m_builtinModels.at(ModelType::Sphere); }
     auto getCubeMesh() const { return m_builtinModels.at(ModelType::Cube); }
 
+    StreamingManager &getStreamingManager() { return m_streamingManager; }
+    TextureStreamer &getTextureStreamer() { return m_textureStreamer; }
     LightCache &getLightCache() { return m_lightCache; }
     bool hasDirectionalLight() const { return m_lightCache.getSunlightIndex() > -1; }
 
@@ -96,6 +106,8 @@ class SceneRenderer
     void initSceneData();
     std::vector<std::pair<Light, Transform>> collectLights(Ref<Scene> scene);
     void mousePicking(Ref<Scene> scene);
+    Camera *getRenderCamera(Ref<Scene> scene, RenderMode mode);
+    math::Sphere getModelBounds(const Model &model) const;
     bool isMultisamplingEnabled() const;
 
   private:
@@ -105,6 +117,8 @@ class SceneRenderer
 
     MeshCache m_meshCache;
     MaterialCache m_materialCache;
+    StreamingManager m_streamingManager;
+    TextureStreamer m_textureStreamer;
 
   public:
     struct GPUSceneData
@@ -122,7 +136,7 @@ class SceneRenderer
         float ambientIntensity;
 
         // ibl
-        ImageID irradianceMapId;
+        math::SH9Color irradianceSH;
         ImageID prefilterMapId;
         ImageID brdfLutId;
 
@@ -152,6 +166,8 @@ class SceneRenderer
     PostFXPass m_postFXPass;
     // SkyboxPass m_skyboxPass;
     SpriteBatchRenderer m_spriteRenderer;
+    SpriteAtlas m_spriteAtlas;
+    std::vector<Ref<Texture2D>> m_spriteTextures; // of this update's sprites, in view order
 	gfx::ImGuiBackend m_imguiBackend;
     DebugLineRenderer m_debugLineRenderer;
 
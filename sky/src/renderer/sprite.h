@@ -25,6 +25,7 @@ struct Sprite
 	glm::vec2	origin{-0.5f, -0.5f};
 	ImageID		textureId;
 	glm::vec2	texCoord{0.f, 0.f};
+	glm::vec2	texScale{1.f, 1.f}; // of the texture the quad shows, less than 1 in an atlas
 	uint32_t	uniqueId;
 };
 }
\ No newline at end of file
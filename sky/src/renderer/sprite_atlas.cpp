@@ -0,0 +1,312 @@
+#include "sprite_atlas.h"
+
+#include "core/helpers/image.h"
+#include "graphics/vulkan/vk_images.h"
+#include "graphics/vulkan/vk_utils.h"
+
+#include <tracy/Tracy.hpp>
+
+namespace sky
+{
+namespace
+{
+constexpr uint32_t ATLAS_PAGE_SIZE = 2048;
+constexpr uint32_t MAX_ATLAS_PAGES = 4;
+// larger textures are drawn from their own image
+constexpr uint32_t MAX_ATLAS_SPRITE_SIZE = 256;
+// the edge texels are repeated into it, so sampling at a sprite's border never reads its neighbour
+constexpr uint32_t ATLAS_PADDING = 1;
+// updates (one per rendered view a frame) a texture can go unrequested before it is evicted
+constexpr uint64_t ATLAS_EVICT_AFTER = 600;
+} // namespace
+
+void SkylinePacker::reset(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+    m_skyline.assign(1, Segment{0, 0, width});
+}
+
+bool SkylinePacker::fits(size_t index, uint32_t width, uint32_t height, uint32_t &y) const
+{
+    if (m_skyline[index].x + width > m_width) return false;
+
+    // the rect rests on the highest segment under it
+    y = 0;
+    for (uint32_t covered = 0; covered < width; covered += m_skyline[index++].width)
+    {
+        y = std::max(y, m_skyline[index].y);
+        if (y + height > m_height) return false;
+    }
+    return true;
+}
+
+bool SkylinePacker::insert(uint32_t width, uint32_t height, Rect &rect)
+{
+    size_t best = m_skyline.size();
+    uint32_t bestTop = UINT32_MAX, bestWidth = UINT32_MAX;
+    for (size_t i = 0; i < m_skyline.size(); ++i)
+    {
+        uint32_t y;
+        if (!fits(i, width, height, y)) continue;
+
+        // the lowest top, then the narrowest segment, which leaves the least gap
+        if (y + height < bestTop || (y + height == bestTop && m_skyline[i].width < bestWidth))
+        {
+            best = i;
+            bestTop = y + height;
+            bestWidth = m_skyline[i].width;
+            rect = {m_skyline[i].x, y, width, height};
+        }
+    }
+    if (best == m_skyline.size()) return false;
+
+    // the rect's top becomes a segment, the ones under it shrink or go
+    m_skyline.insert(m_skyline.begin() + best, Segment{rect.x, bestTop, width});
+    const uint32_t right = rect.x + width;
+    for (size_t i = best + 1; i < m_skyline.size() && m_skyline[i].x < right;)
+    {
+        auto &segment = m_skyline[i];
+        const uint32_t segmentRight = segment.x + segment.width;
+        if (segmentRight <= right)
+        {
+            m_skyline.erase(m_skyline.begin() + i);
+            continue;
+        }
+        segment.width = segmentRight - right;
+        segment.x = right;
+        break;
+    }
+
+    for (size_t i = 0; i + 1 < m_skyline.size();)
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else ++i;
+    }
+    return true;
+}
+
+bool SpriteAtlas::isAtlasable(gfx::Device &device, const Texture2D &texture) const
+{
+    if (texture.vkImageID == NULL_IMAGE_ID || texture.width <= 0 || texture.height <= 0) return false;
+    if (uint32_t(texture.width) > MAX_ATLAS_SPRITE_SIZE || uint32_t(texture.height) > MAX_ATLAS_SPRITE_SIZE)
+        return false;
+
+    // copied texel for texel, block compressed textures and ones a material streams keep their own image
+    const auto image = device.getImage(texture.vkImageID);
+    if (image.imageExtent.width != uint32_t(texture.width) || image.imageExtent.height != uint32_t(texture.height))
+        return false;
+    // the pages are SRGB, a copy doesn't convert, so UNORM ones would be decoded twice when sampled
+    return image.imageFormat == VK_FORMAT_R8G8B8A8_SRGB;
+}
+
+void SpriteAtlas::request(gfx::Device &device, AssetHandle handle, const Ref<Texture2D> &texture)
+{
+    if (texture == nullptr) return;
+    helper::loadImageFromTexture(texture, VK_FORMAT_R8G8B8A8_SRGB);
+    // a reload can make it too large to stay
+    if (!isAtlasable(device, *texture))
+    {
+        m_entries.erase(handle);
+        return;
+    }
+
+    auto &entry = m_entries[handle];
+    // reloaded (a new texture, or new pixels and size moved into the same one), packed like a new texture,
+    // the old rect stays unused until the pages are packed again
+    if (entry.texture != texture || entry.version != texture->version)
+    {
+        entry.texture = texture;
+        entry.version = texture->version;
+        entry.placed = false;
+        entry.overflowed = false;
+    }
+    entry.lastUsed = m_frame;
+}
+
+void SpriteAtlas::update(gfx::Device &device)
+{
+    ZoneScopedN("Sprite atlas update");
+    const auto evicted =
+        std::erase_if(m_entries, [&](const auto &item) { return item.second.lastUsed + ATLAS_EVICT_AFTER < m_frame; });
+    ++m_frame;
+
+    std::vector<Entry *> pending;
+    for (auto &[handle, entry] : m_entries)
+    {
+        // what did not fit is only tried again once something made room
+        if (evicted > 0) entry.overflowed = false;
+        if (!entry.placed && !entry.overflowed) pending.push_back(&entry);
+    }
+    if (pending.empty()) return;
+
+    // tallest first, the skyline stays flatter
+    const auto byHeight = [](const Entry *a, const Entry *b)
+    {
+        if (a->texture->height != b->texture->height) return a->texture->height > b->texture->height;
+        return a->texture->width > b->texture->width;
+    };
+    std::sort(pending.begin(), pending.end(), byHeight);
+
+    // stops at the first that does not fit
+    const bool full = std::any_of(pending.begin(), pending.end(), [&](Entry *entry) { return !place(device, *entry); });
+    if (full)
+    {
+        // out of room, every texture is packed again, which also drops the rects of evicted and changed ones
+        ZoneScopedN("Sprite atlas repack");
+        repackAll();
+        pending.clear();
+        for (auto &[handle, entry] : m_entries) pending.push_back(&entry);
+        std::sort(pending.begin(), pending.end(), byHeight);
+        for (auto *entry : pending) entry->overflowed = !place(device, *entry);
+        std::erase_if(pending, [](const Entry *entry) { return entry->overflowed; });
+    }
+
+    copyToPages(device, pending);
+}
+
+SpriteAtlas::Region SpriteAtlas::getRegion(AssetHandle handle, const Ref<Texture2D> &texture) const
+{
+    if (texture == nullptr) return {};
+
+    const auto it = m_entries.find(handle);
+    if (it == m_entries.end()) return {texture->vkImageID};
+    const auto &entry = it->second;
+    // not copied in yet, or reloaded since
+    if (!entry.placed || entry.texture != texture || entry.version != texture->version) return {texture->vkImageID};
+
+    const auto &rect = entry.rect;
+    constexpr float pageSize = float(ATLAS_PAGE_SIZE);
+    return {
+        m_pages[entry.page].imageId,
+        glm::vec2(rect.x + ATLAS_PADDING, rect.y + ATLAS_PADDING) / pageSize,
+        glm::vec2(texture->width, texture->height) / pageSize,
+    };
+}
+
+bool SpriteAtlas::place(gfx::Device &device, Entry &entry)
+{
+    const uint32_t width = entry.texture->width + 2 * ATLAS_PADDING;
+    const uint32_t height = entry.texture->height + 2 * ATLAS_PADDING;
+    for (uint32_t i = 0; i < m_pages.size(); ++i)
+    {
+        if (m_pages[i].packer.insert(width, height, entry.rect))
+        {
+            entry.page = i;
+            entry.placed = true;
+            return true;
+        }
+    }
+    if (m_pages.size() == MAX_ATLAS_PAGES) return false;
+
+    auto &page = m_pages.emplace_back();
+    page.imageId = device.createImage(gfx::vkutil::CreateImageInfo{
+        .format = VK_FORMAT_R8G8B8A8_SRGB,
+        .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .extent = {ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, 1},
+    });
+    page.packer.reset(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+    page.cleared = true;
+
+    entry.page = uint32_t(m_pages.size() - 1);
+    entry.placed = page.packer.insert(width, height, entry.rect);
+    return entry.placed;
+}
+
+void SpriteAtlas::repackAll()
+{
+    for (auto &page : m_pages)
+    {
+        page.packer.reset(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+        page.cleared = true;
+    }
+    for (auto &[handle, entry] : m_entries)
+    {
+        entry.placed = false;
+        entry.overflowed = false;
+    }
+}
+
+void SpriteAtlas::copyToPages(gfx::Device &device, std::span<Entry *const> entries)
+{
+    ZoneScopedN("Sprite atlas copy");
+    device.immediateSubmit(
+        [&](VkCommandBuffer cmd)
+        {
+            for (const auto &page : m_pages)
+            {
+                const auto image = device.getImage(page.imageId).image;
+                if (!page.cleared)
+                {
+                    gfx::vkutil::transitionImage(cmd, image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                    continue;
+                }
+
+                // the padding around sprites has to be transparent
+                gfx::vkutil::transitionImage(cmd, image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                const VkClearColorValue clear{};
+                const auto range = VkImageSubresourceRange{
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .levelCount = 1,
+                    .layerCount = 1,
+                };
+                vkCmdClearColorImage(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clear, 1, &range);
+            }
+
+            for (const auto *entry : entries)
+            {
+                const auto source = device.getImage(entry->texture->vkImageID).image;
+                const auto destination = device.getImage(m_pages[entry->page].imageId).image;
+                const int32_t width = entry->texture->width, height = entry->texture->height;
+                const int32_t x = int32_t(entry->rect.x + ATLAS_PADDING), y = int32_t(entry->rect.y + ATLAS_PADDING);
+
+                const auto region = [](int32_t srcX, int32_t srcY, int32_t dstX, int32_t dstY, int32_t w, int32_t h)
+                {
+                    const auto layer = VkImageSubresourceLayers{
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .layerCount = 1,
+                    };
+                    return VkImageCopy{
+                        .srcSubresource = layer,
+                        .srcOffset = {srcX, srcY, 0},
+                        .dstSubresource = layer,
+                        .dstOffset = {dstX, dstY, 0},
+                        .extent = {uint32_t(w), uint32_t(h), 1},
+                    };
+                };
+                // the sprite, then its edges and corners repeated into the padding
+                const VkImageCopy regions[] = {
+                    region(0, 0, x, y, width, height),
+                    region(0, 0, x - 1, y, 1, height),
+                    region(width - 1, 0, x + width, y, 1, height),
+                    region(0, 0, x, y - 1, width, 1),
+                    region(0, height - 1, x, y + height, width, 1),
+                    region(0, 0, x - 1, y - 1, 1, 1),
+                    region(width - 1, 0, x + width, y - 1, 1, 1),
+                    region(0, height - 1, x - 1, y + height, 1, 1),
+                    region(width - 1, height - 1, x + width, y + height, 1, 1),
+                };
+
+                gfx::vkutil::transitionImage(cmd, source, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+                vkCmdCopyImage(cmd, source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, destination,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, uint32_t(std::size(regions)), regions);
+                gfx::vkutil::transitionImage(cmd, source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            }
+
+            for (const auto &page : m_pages)
+            {
+                gfx::vkutil::transitionImage(cmd, device.getImage(page.imageId).image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            }
+        });
+
+    for (auto &page : m_pages) page.cleared = false;
+}
+} // namespace sky
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <skypch.h>
+
+#include <glm/glm.hpp>
+#include "asset_management/asset.h"
+#include "graphics/vulkan/vk_device.h"
+#include "renderer/texture.h"
+
+namespace sky
+{
+// Bottom left skyline packing of rectangles into a fixed size page. Rects can't be freed one by one, a
+// page is reset and packed again instead.
+class SkylinePacker
+{
+  public:
+    struct Rect
+    {
+        uint32_t x, y, width, height;
+    };
+
+    void reset(uint32_t width, uint32_t height);
+    // false when the rect fits nowhere
+    bool insert(uint32_t width, uint32_t height, Rect &rect);
+
+  private:
+    // the top of the packed rects, sorted by x and covering the page's width
+    struct Segment
+    {
+        uint32_t x, y, width;
+    };
+
+    bool fits(size_t index, uint32_t width, uint32_t height, uint32_t &y) const;
+
+    std::vector<Segment> m_skyline;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+};
+
+// Packs the small SRGB RGBA8 sprite textures of a scene into a few large pages, so thousands of sprites sample
+// a handful of images. Textures are copied in on the GPU, new and changed ones are added to the pages as
+// they come and the pages are only packed again when they run out of room.
+class SpriteAtlas
+{
+  public:
+    struct Region
+    {
+        ImageID imageId = NULL_IMAGE_ID;
+        glm::vec2 uvOffset{0.f};
+        glm::vec2 uvScale{1.f};
+    };
+
+    // Marks the sprite's texture as used this frame, it is packed by the next update when it is new or changed
+    void request(gfx::Device &device, AssetHandle handle, const Ref<Texture2D> &texture);
+    // Evicts textures that were not requested for a while and copies the requested ones into the pages.
+    // Regions only move here, call it between the frame's requests and getRegion.
+    void update(gfx::Device &device);
+    // Where the texture is in the atlas, or its own image when it is not in one
+    Region getRegion(AssetHandle handle, const Ref<Texture2D> &texture) const;
+
+  private:
+    struct Entry
+    {
+        Ref<Texture2D> texture;
+        uint32_t version = 0; // the texture's version when it was copied in
+        uint32_t page = 0;
+        SkylinePacker::Rect rect{};
+        bool placed = false;
+        bool overflowed = false; // did not fit when every page was packed again
+        uint64_t lastUsed = 0;
+    };
+
+    struct Page
+    {
+        ImageID imageId = NULL_IMAGE_ID;
+        SkylinePacker packer;
+        bool cleared = false; // packed again, the old sprites are still in the image
+    };
+
+    bool isAtlasable(gfx::Device &device, const Texture2D &texture) const;
+    bool place(gfx::Device &device, Entry &entry);
+    void repackAll();
+    void copyToPages(gfx::Device &device, std::span<Entry *const> entries);
+
+  private:
+    std::unordered_map<AssetHandle, Entry> m_entries;
+    std::vector<Page> m_pages;
+    uint64_t m_frame = 0;
+};
+} // namespace sky
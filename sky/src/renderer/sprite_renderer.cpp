@@ -109,9 +109,9 @@ void SpriteBatchRenderer::drawSprite(gfx::Device &device, const Sprite &sprite)
    auto transformedVertices = calculateTransformedVertices(sprite);
 
     m_vertices.push_back({transformedVertices[0], sprite.texCoord, sprite.color, textureId, sprite.uniqueId});
-    m_vertices.push_back({transformedVertices[1], sprite.texCoord + glm::vec2(1.0f, 0.0f), sprite.color, textureId, sprite.uniqueId});
-    m_vertices.push_back({transformedVertices[2], sprite.texCoord + glm::vec2(1.0f, 1.0f), sprite.color, textureId, sprite.uniqueId});
-    m_vertices.push_back({transformedVertices[3], sprite.texCoord + glm::vec2(0.0f, 1.0f), sprite.color, textureId, sprite.uniqueId});
+    m_vertices.push_back({transformedVertices[1], sprite.texCoord + glm::vec2(1.0f, 0.0f) * sprite.texScale, sprite.color, textureId, sprite.uniqueId});
+    m_vertices.push_back({transformedVertices[2], sprite.texCoord + glm::vec2(1.0f, 1.0f) * sprite.texScale, sprite.color, textureId, sprite.uniqueId});
+    m_vertices.push_back({transformedVertices[3], sprite.texCoord + glm::vec2(0.0f, 1.0f) * sprite.texScale, sprite.color, textureId, sprite.uniqueId});
 
     m_currentVertexCount += VERTICES_PER_QUAD;
 }
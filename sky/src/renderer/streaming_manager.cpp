@@ -0,0 +1,113 @@
+#include "streaming_manager.h"
+
+#include <tracy/Tracy.hpp>
+
+#include "asset_management/asset_manager.h"
+#include "camera/camera.h"
+#include "core/tasks/task_manager.h"
+
+namespace sky
+{
+float StreamingManager::score(const math::Sphere &worldBounds, const Camera &camera, bool visible)
+{
+    // projected radius as a fraction of the viewport height, proj[1][1] is 1 / tan(fov / 2)
+    const auto &proj = camera.getProjection();
+    float screenSize;
+    if (proj[2][3] == 0.f) screenSize = worldBounds.radius * proj[1][1]; // orthographic, no perspective divide
+    else
+    {
+        const float distance = glm::length(worldBounds.center - camera.getPosition());
+        // the camera is inside the bounds, it covers the whole view
+        screenSize = distance <= worldBounds.radius ? 1.f : worldBounds.radius * proj[1][1] / distance;
+    }
+    return std::min(std::abs(screenSize), 1.f) * (visible ? 1.f : OFFSCREEN_WEIGHT);
+}
+
+void StreamingManager::request(AssetHandle handle, const math::Sphere &worldBounds, const Camera &camera,
+    const Frustum &frustum)
+{
+    const bool visible = edge::isInFrustum(frustum, worldBounds);
+    const float requestScore = score(worldBounds, camera, visible);
+
+    auto [it, inserted] = m_requests.try_emplace(handle, Request{handle, requestScore, visible});
+    if (inserted) return;
+
+    it->second.score = std::max(it->second.score, requestScore);
+    it->second.visible |= visible;
+}
+
+math::Sphere StreamingManager::estimateWorldBounds(AssetHandle handle, const glm::mat4 &transform) const
+{
+    auto it = m_modelBounds.find(handle);
+    const auto bounds = it != m_modelBounds.end() ? it->second : math::Sphere{.center = {}, .radius = 1.f};
+    return edge::calculateBoundingSphereWorld(transform, bounds, false);
+}
+
+void StreamingManager::update(TaskManager &taskManager)
+{
+    ZoneScopedN("Asset streaming");
+
+    std::vector<Request> requests;
+    requests.reserve(m_requests.size());
+    for (const auto &[handle, request] : m_requests) requests.push_back(request);
+    m_requests.clear();
+
+    std::sort(requests.begin(), requests.end(),
+        [](const Request &a, const Request &b) { return a.score > b.score; });
+
+    std::unordered_set<AssetHandle> wanted;
+    for (size_t i = 0; i < std::min(requests.size(), m_maxInFlight); ++i) wanted.insert(requests[i].handle);
+
+    // finished loads free their slot, queued ones that fell out of the best set give theirs up
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();)
+    {
+        auto &[handle, inFlight] = *it;
+        const auto status = inFlight.task->getStatus();
+        const bool finished = status != Task<Ref<Model>>::Status::Pending &&
+            status != Task<Ref<Model>>::Status::Running;
+        if (finished)
+        {
+            it = m_inFlight.erase(it);
+            continue;
+        }
+
+        if (inFlight.owned && status == Task<Ref<Model>>::Status::Pending && !wanted.contains(handle))
+        {
+            inFlight.task->cancel();
+            it = m_inFlight.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    for (const auto &request : requests)
+    {
+        const auto priority = request.visible ? TaskPriority::Visible : TaskPriority::Background;
+
+        auto inFlight = m_inFlight.find(request.handle);
+        if (inFlight != m_inFlight.end())
+        {
+            if (inFlight->second.visible != request.visible)
+            {
+                taskManager.reprioritize(TaskKey{TaskType::AssetLoad, request.handle}, priority);
+                inFlight->second.visible = request.visible;
+            }
+            continue;
+        }
+
+        if (m_inFlight.size() >= m_maxInFlight) continue;
+        // done in the meantime, the entity draws it next frame
+        if (AssetManager::isAssetLoaded(request.handle)) continue;
+
+        const auto key = TaskKey{TaskType::AssetLoad, request.handle};
+        const auto existing = taskManager.getTask<Ref<Model>>(key);
+        const bool owned = !existing || existing->getStatus() == Task<Ref<Model>>::Status::Cancelled;
+
+        auto task = AssetManager::getAssetAsync<Model>(request.handle, nullptr, priority);
+        m_inFlight[request.handle] = InFlight{task, owned, request.visible};
+    }
+
+    m_pendingCount = requests.size();
+    TracyPlot("Streaming requests", static_cast<int64_t>(m_pendingCount));
+}
+} // namespace sky
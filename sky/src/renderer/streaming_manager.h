@@ -0,0 +1,69 @@
+#pragma once
+
+#include <skypch.h>
+#include <glm/glm.hpp>
+
+#include "asset_management/asset.h"
+#include "core/math/sphere.h"
+#include "core/tasks/task.h"
+#include "renderer/frustum_culling.h"
+#include "renderer/mesh.h"
+
+namespace sky
+{
+class Camera;
+class TaskManager;
+
+// Decides which models get loaded first. Entities ask for their model every frame with their world
+// bounds, the requests are scored by screen size and frustum visibility and only the best scored ones
+// are handed to the task pool. Queued loads that dropped out of that set are cancelled, so a model
+// behind the camera far away never holds up the one in front of it.
+class StreamingManager
+{
+  public:
+    static constexpr size_t DEFAULT_MAX_IN_FLIGHT = 4;
+    // off-screen models still load, but only ahead of visible ones this many times smaller
+    static constexpr float OFFSCREEN_WEIGHT = 0.1f;
+
+    // Called for every unloaded model an entity wants drawn. Several requests for the same model, from
+    // other entities or views, keep the best score.
+    void request(AssetHandle handle, const math::Sphere &worldBounds, const Camera &camera, const Frustum &frustum);
+
+    // Once per frame after every view made its requests: submits the best scored loads, reprioritizes
+    // and cancels the queued ones, then forgets this frame's requests
+    void update(TaskManager &taskManager);
+
+    // Model space bounds of a model that was loaded before, used to score it again after an eviction.
+    // Unknown models are scored as a unit sphere at the entity's position.
+    void setModelBounds(AssetHandle handle, const math::Sphere &bounds) { m_modelBounds[handle] = bounds; }
+    bool hasModelBounds(AssetHandle handle) const { return m_modelBounds.contains(handle); }
+    math::Sphere estimateWorldBounds(AssetHandle handle, const glm::mat4 &transform) const;
+
+    void setMaxInFlight(size_t count) { m_maxInFlight = std::max<size_t>(1, count); }
+    size_t getPendingCount() const { return m_pendingCount; }
+
+  private:
+    struct Request
+    {
+        AssetHandle handle;
+        float score = 0.f;
+        bool visible = false;
+    };
+
+    struct InFlight
+    {
+        Ref<Task<Ref<Model>>> task;
+        bool owned = false; // submitted by us, someone else's load is never cancelled
+        bool visible = false;
+    };
+
+    static float score(const math::Sphere &worldBounds, const Camera &camera, bool visible);
+
+  private:
+    std::unordered_map<AssetHandle, Request> m_requests;
+    std::unordered_map<AssetHandle, InFlight> m_inFlight;
+    std::unordered_map<AssetHandle, math::Sphere> m_modelBounds;
+    size_t m_maxInFlight = DEFAULT_MAX_IN_FLIGHT;
+    size_t m_pendingCount = 0;
+};
+} // namespace sky
@@ -1,5 +1,149 @@
 #include "texture.h"
 
+#include <stb_image.h>
+
+#include "core/helpers/hash.h"
+
 namespace sky
 {
-} // namespace sky
\ No newline at end of file
+bool isBlockCompressed(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::RGBA8Unorm:
+    case TextureFormat::RGBA8Srgb:
+    case TextureFormat::RGBA32Float:
+    case TextureFormat::RGBA16Float:
+    case TextureFormat::RGB9E5Float: return false;
+    default: return true;
+    }
+}
+
+bool isSrgbFormat(TextureFormat format)
+{
+    return format == TextureFormat::RGBA8Srgb || format == TextureFormat::BC1Srgb ||
+        format == TextureFormat::BC3Srgb || format == TextureFormat::BC7Srgb;
+}
+
+uint64_t getTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+    const uint64_t pixels = uint64_t(width) * height;
+    if (format == TextureFormat::RGBA32Float) return pixels * 16;
+    if (format == TextureFormat::RGBA16Float) return pixels * 8;
+    if (!isBlockCompressed(format)) return pixels * 4;
+
+    // partial blocks at the edges are stored whole
+    const uint64_t blocks = uint64_t((width + 3) / 4) * ((height + 3) / 4);
+    const bool halfBlocks = format == TextureFormat::BC1Unorm || format == TextureFormat::BC1Srgb ||
+        format == TextureFormat::BC4Unorm;
+    return blocks * (halfBlocks ? 8 : 16);
+}
+
+const char *toString(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::RGBA8Unorm: return "RGBA8";
+    case TextureFormat::RGBA8Srgb: return "RGBA8 sRGB";
+    case TextureFormat::BC1Unorm: return "BC1";
+    case TextureFormat::BC1Srgb: return "BC1 sRGB";
+    case TextureFormat::BC3Unorm: return "BC3";
+    case TextureFormat::BC3Srgb: return "BC3 sRGB";
+    case TextureFormat::BC4Unorm: return "BC4";
+    case TextureFormat::BC5Unorm: return "BC5";
+    case TextureFormat::BC7Unorm: return "BC7";
+    case TextureFormat::BC7Srgb: return "BC7 sRGB";
+    case TextureFormat::RGBA32Float: return "RGBA32F";
+    case TextureFormat::RGBA16Float: return "RGBA16F";
+    case TextureFormat::RGB9E5Float: return "RGB9E5";
+    case TextureFormat::BC6HUfloat: return "BC6H";
+    }
+    return "Unknown";
+}
+
+Texture2D::Texture2D(Texture2D &&o) noexcept
+    : Asset(o), pixels(std::exchange(o.pixels, nullptr)), width(o.width), height(o.height), channels(o.channels),
+      mips(std::move(o.mips)), format(o.format), shouldSTBFree(o.shouldSTBFree), pixelOwner(std::move(o.pixelOwner)),
+      vkImageID(o.vkImageID), version(o.version)
+{
+}
+
+Texture2D &Texture2D::operator=(Texture2D &&o) noexcept
+{
+    if (this != &o)
+    {
+        releasePixels();
+        handle = o.handle;
+        pixels = std::exchange(o.pixels, nullptr);
+        width = o.width;
+        height = o.height;
+        channels = o.channels;
+        mips = std::move(o.mips);
+        format = o.format;
+        shouldSTBFree = o.shouldSTBFree;
+        pixelOwner = std::move(o.pixelOwner);
+        vkImageID = o.vkImageID;
+        ++version;
+    }
+    return *this;
+}
+
+void Texture2D::releasePixels()
+{
+    if (!pixels) return;
+
+    // stb allocates with malloc, the serializer with new[]
+    if (pixelOwner) pixelOwner = nullptr;
+    else if (shouldSTBFree) stbi_image_free(pixels);
+    else delete[] pixels;
+    pixels = nullptr;
+}
+
+TextureCube::TextureCube(TextureCube &&o) noexcept
+    : Asset(o), pixels(std::exchange(o.pixels, nullptr)), width(o.width), height(o.height), channels(o.channels),
+      format(o.format), shouldSTBFree(o.shouldSTBFree), pixelOwner(std::move(o.pixelOwner)), vkImageID(o.vkImageID),
+      contentHash(o.contentHash), irradianceSH(o.irradianceSH)
+{
+}
+
+TextureCube &TextureCube::operator=(TextureCube &&o) noexcept
+{
+    if (this != &o)
+    {
+        releasePixels();
+        handle = o.handle;
+        pixels = std::exchange(o.pixels, nullptr);
+        width = o.width;
+        height = o.height;
+        channels = o.channels;
+        format = o.format;
+        shouldSTBFree = o.shouldSTBFree;
+        pixelOwner = std::move(o.pixelOwner);
+        vkImageID = o.vkImageID;
+        contentHash = o.contentHash;
+        irradianceSH = o.irradianceSH;
+    }
+    return *this;
+}
+
+uint64_t TextureCube::getContentHash()
+{
+    if (contentHash == 0 && pixels)
+    {
+        contentHash = helper::hashBytes(pixels, getPixelDataSize());
+        contentHash = helper::hashCombine(contentHash, static_cast<uint64_t>(format));
+        contentHash = helper::hashCombine(contentHash, uint64_t(width) << 32 | uint32_t(height));
+    }
+    return contentHash;
+}
+
+void TextureCube::releasePixels()
+{
+    if (!pixels) return;
+
+    if (pixelOwner) pixelOwner = nullptr;
+    else if (shouldSTBFree) stbi_image_free(pixels);
+    else delete[] pixels;
+    pixels = nullptr;
+}
+} // namespace sky
@@ -3,18 +3,46 @@
 #include <skypch.h>
 
 #include "asset_management/asset.h"
+#include "core/math/spherical_harmonics.h"
 #include "graphics/vulkan/vk_types.h"
 
 namespace sky
 {
+// Pixel format of cooked texture data, stored in the texture container
+enum class TextureFormat : uint32_t
+{
+    RGBA8Unorm = 0,
+    RGBA8Srgb, // the mips were filtered in linear space
+    BC1Unorm,  // opaque color
+    BC1Srgb,
+    BC3Unorm,  // color with alpha
+    BC3Srgb,
+    BC4Unorm,  // red only, single channel maps
+    BC5Unorm,  // red and green, normal maps
+    BC7Unorm,
+    BC7Srgb,
+    // HDR, only cube textures (equirectangular environments) use them
+    RGBA32Float,
+    RGBA16Float,
+    RGB9E5Float, // RGB with 9 bit mantissas and a shared 5 bit exponent, no alpha
+    BC6HUfloat,  // unsigned half float RGB blocks
+};
+
+// block compressed formats store 4x4 pixel blocks, every other format whole pixels
+bool isBlockCompressed(TextureFormat format);
+bool isSrgbFormat(TextureFormat format);
+// bytes taken by one level of the given size
+uint64_t getTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+const char *toString(TextureFormat format);
+
 struct Texture2D : public Asset
 {
     Texture2D() = default;
-    ~Texture2D() = default;
+    ~Texture2D() { releasePixels(); }
 
     // move only
-    Texture2D(Texture2D &&o) = default;
-    Texture2D &operator=(Texture2D &&o) = default;
+    Texture2D(Texture2D &&o) noexcept;
+    Texture2D &operator=(Texture2D &&o) noexcept;
 
     // no copies
     Texture2D(const Texture2D &o) = delete;
@@ -26,38 +54,71 @@ struct Texture2D : public Asset
     int height{0};
     int channels{0};
 
+    // cooked textures carry their whole mip chain in pixels, level 0 first. Empty when pixels only
+    // hold an RGBA8 level 0, block compressed textures always list their levels.
+    std::vector<gfx::ImageMipLevel> mips;
+    TextureFormat format{TextureFormat::RGBA8Unorm};
+
 	bool shouldSTBFree{false};
+    // set when pixels point into memory owned by someone else (a mapped asset pack), which is kept
+    // alive instead of freeing pixels
+    Ref<const void> pixelOwner;
 
     // for vulkan
     ImageID vkImageID = NULL_IMAGE_ID;
+    // bumped each time a texture is moved over this one (a hot reload), so copies of its image can tell
+    uint32_t version = 0;
+
+    // frees the CPU copy, done once the pixels have been uploaded to vkImageID
+    void releasePixels();
+    size_t getPixelDataSize() const
+    {
+        return mips.empty() ? size_t(width) * height * channels : mips.back().offset + mips.back().size;
+    }
 
 	AssetType getType() const override { return AssetType::Texture2D; }
+    // borrowed pixels count too, the mapped pages they touched stay resident until the texture goes
+    size_t getMemoryUsage() const override { return pixels ? getPixelDataSize() : 0; }
 };
 
 struct TextureCube : public Asset
 {
     TextureCube() = default;
-    ~TextureCube() = default;
+    ~TextureCube() { releasePixels(); }
 
     // move only
-    TextureCube(TextureCube &&o) = default;
-    TextureCube &operator=(TextureCube &&o) = default;
+    TextureCube(TextureCube &&o) noexcept;
+    TextureCube &operator=(TextureCube &&o) noexcept;
 
     // no copies
     TextureCube(const TextureCube &o) = delete;
     TextureCube &operator=(const TextureCube &o) = delete;
 
-    // data
-    float *pixels{nullptr};
+    // data, level 0 in format
+    unsigned char *pixels{nullptr};
     int width{0};
     int height{0};
     int channels{0};
+    TextureFormat format{TextureFormat::RGBA32Float};
 
 	bool shouldSTBFree{false};
+    // set when pixels point into memory owned by someone else (a mapped asset pack), which is kept
+    // alive instead of freeing pixels
+    Ref<const void> pixelOwner;
 
     // for vulkan
     ImageID vkImageID = NULL_IMAGE_ID;
+    // of the pixels, kept once they are released, 0 until getContentHash is called with pixels loaded
+    uint64_t contentHash = 0;
+    // diffuse lighting of the environment, set by ImageBasedLighting::prepareEnvironment when the cube is loaded
+    std::optional<math::SH9Color> irradianceSH;
+
+    // frees the CPU copy, done once the pixels have been uploaded to vkImageID
+    void releasePixels();
+    uint64_t getContentHash();
 
 	AssetType getType() const override { return AssetType::TextureCube; }
+    size_t getPixelDataSize() const { return getTextureLevelSize(format, width, height); }
+    size_t getMemoryUsage() const override { return pixels ? getPixelDataSize() : 0; }
 };
 }
\ No newline at end of file
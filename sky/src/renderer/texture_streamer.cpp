@@ -0,0 +1,283 @@
+#include "texture_streamer.h"
+
+#include "core/helpers/image.h"
+#include "core/math/sphere.h"
+#include "core/project_management/project_manager.h"
+#include "renderer/camera/camera.h"
+#include "renderer/material_cache.h"
+
+#include <cmath>
+#include <tracy/Tracy.hpp>
+
+namespace sky
+{
+uint32_t TextureStreamer::getTailMip(const Texture2D &texture)
+{
+    const auto &mips = texture.mips;
+    for (uint32_t i = 0; i < mips.size(); ++i)
+    {
+        if (std::max(mips[i].width, mips[i].height) <= INITIAL_MIP_SIZE) return i;
+    }
+    return uint32_t(mips.size() - 1);
+}
+
+uint64_t TextureStreamer::getLevelsSize(std::span<const gfx::ImageMipLevel> mips, uint32_t firstMip)
+{
+    uint64_t size = 0;
+    for (uint32_t i = firstMip; i < mips.size(); ++i) size += mips[i].size;
+    return size;
+}
+
+ImageID TextureStreamer::load(gfx::Device &device, const Ref<Texture2D> &texture, VkFormat format)
+{
+    std::lock_guard lock(m_mutex);
+    // another material loaded it first
+    if (texture->vkImageID != NULL_IMAGE_ID) return texture->vkImageID;
+
+    const auto tailMip = getTailMip(*texture);
+    texture->vkImageID = helper::createImageFromTextureMips(*texture, format, tailMip);
+    if (texture->vkImageID == NULL_IMAGE_ID) return NULL_IMAGE_ID;
+
+    m_entries[texture->vkImageID] = Entry{
+        .texture = texture,
+        .mips = texture->mips,
+        .format = format,
+        .residentMip = tailMip,
+        .tailMip = tailMip,
+        .wantedMip = tailMip,
+        .lastRequested = m_frame,
+    };
+    m_residentSize += getLevelsSize(texture->mips, tailMip);
+    return texture->vkImageID;
+}
+
+void TextureStreamer::remove(ImageID id)
+{
+    std::lock_guard lock(m_mutex);
+    const auto it = m_entries.find(id);
+    if (it == m_entries.end()) return;
+
+    m_residentSize -= getLevelsSize(it->second.mips, it->second.residentMip);
+    m_entries.erase(it);
+}
+
+void TextureStreamer::request(std::span<const MeshDrawCommand> drawCommands, const MaterialCache &materials,
+    const Camera &camera, const Frustum &frustum, float viewportHeight)
+{
+    ZoneScopedN("Texture streaming requests");
+    const auto &proj = camera.getProjection();
+    const bool orthographic = proj[2][3] == 0.f;
+
+    // the largest size of every material, then of their textures
+    std::unordered_map<MaterialID, float> materialSizes;
+    for (const auto &dc : drawCommands)
+    {
+        if (!dc.isVisible || dc.material == NULL_MATERIAL_ID) continue;
+
+        // the bounds' projected diameter in pixels, proj[1][1] is 1 / tan(fov / 2)
+        const auto &bounds = dc.worldBoundingSphere;
+        float size;
+        if (orthographic) size = bounds.radius * std::abs(proj[1][1]) * viewportHeight;
+        else
+        {
+            const float distance = glm::length(bounds.center - camera.getPosition());
+            // the camera is inside the bounds, it wants every level
+            size = distance <= bounds.radius ? std::numeric_limits<float>::max()
+                                             : bounds.radius * std::abs(proj[1][1]) / distance * viewportHeight;
+        }
+        if (!edge::isInFrustum(frustum, bounds)) size *= OFFSCREEN_WEIGHT;
+
+        auto &materialSize = materialSizes[dc.material];
+        materialSize = std::max(materialSize, size);
+    }
+
+    std::lock_guard lock(m_mutex);
+    for (const auto &[id, size] : materialSizes)
+    {
+        const auto &material = materials.getMaterial(id);
+        for (const auto image : {material.albedoTexture, material.normalMapTexture, material.metallicTexture,
+                 material.roughnessTexture, material.ambientOcclusionTexture, material.emissiveTexture})
+        {
+            const auto it = m_entries.find(image);
+            if (it == m_entries.end()) continue;
+
+            it->second.screenSize = std::max(it->second.screenSize, size);
+            it->second.lastRequested = m_frame;
+        }
+    }
+}
+
+uint32_t TextureStreamer::getWantedMip(const Entry &entry) const
+{
+    // not drawn for a while, only the tail stays
+    if (entry.lastRequested + EVICT_AFTER < m_frame) return entry.tailMip;
+    // not drawn this frame, it keeps what it has
+    if (entry.lastRequested != m_frame) return entry.residentMip;
+    if (entry.screenSize <= 0.f) return entry.tailMip;
+
+    // the level with about as many texels across as pixels the bounds cover. How the UVs spread over the
+    // mesh is unknown, one level sharper keeps tiled textures from going blurry.
+    const auto &top = entry.mips.front();
+    const float texels = float(std::max(top.width, top.height));
+    const float mip = std::floor(std::log2(texels / entry.screenSize)) - 1.f;
+    return uint32_t(std::clamp(mip, 0.f, float(entry.tailMip)));
+}
+
+void TextureStreamer::fitBudget(std::span<Entry *> entries, uint64_t budget)
+{
+    uint64_t total = 0;
+    for (const auto *entry : entries) total += getLevelsSize(entry->mips, entry->wantedMip);
+    if (total <= budget) return;
+
+    // the smallest on screen first, the ones not drawn this frame before any of them
+    const auto priority = [&](const Entry *entry) { return entry->lastRequested == m_frame ? entry->screenSize : -1.f; };
+    std::sort(entries.begin(), entries.end(),
+        [&](const Entry *a, const Entry *b) { return priority(a) < priority(b); });
+
+    // a texture goes down to its tail before a larger one on screen loses a level
+    for (auto *entry : entries)
+    {
+        while (total > budget && entry->wantedMip < entry->tailMip)
+            total -= entry->mips[entry->wantedMip++].size;
+        if (total <= budget) return;
+    }
+}
+
+bool TextureStreamer::stageResidentMip(gfx::Device &device, gfx::CommandBuffer &cmd, ImageID id, Entry &entry,
+    uint32_t mip)
+{
+    ZoneScopedN("Stream texture mips");
+    // evicted, the entry is dropped by the next update
+    const auto texture = entry.texture.lock();
+    if (texture == nullptr) return false;
+
+    // the frame's first change starts its upload commands
+    if (cmd.handle == VK_NULL_HANDLE) cmd = device.beginOffscreenFrame();
+
+    auto &staged = m_staged.emplace_back(StagedImage{.id = id, .mip = mip, .frame = m_frame});
+    staged.image = helper::createImageFromTextureMips(cmd, *texture, entry.format, mip, staged.uploadBuffer);
+    entry.staging = true;
+    return true;
+}
+
+void TextureStreamer::swapStagedImages(gfx::Device &device)
+{
+    // Every frame slot has waited on its fence since the upload was submitted, and a fence also covers what
+    // was queued before it, so the upload has run. The old image is retired from here, the frames recorded
+    // since still sample it.
+    std::erase_if(m_staged,
+        [&](const StagedImage &staged)
+        {
+            if (staged.frame + gfx::FRAME_OVERLAP + 1 > m_frame) return false;
+            device.destroyBuffer(staged.uploadBuffer);
+
+            // the texture went away or its image was replaced whole meanwhile
+            const auto it = m_entries.find(staged.id);
+            if (it == m_entries.end())
+            {
+                device.destroyImage(staged.image);
+                return true;
+            }
+
+            m_retired.push_back({device.swapImage(staged.id, staged.image), m_frame});
+            auto &entry = it->second;
+            m_residentSize -= getLevelsSize(entry.mips, entry.residentMip);
+            m_residentSize += getLevelsSize(entry.mips, staged.mip);
+            entry.residentMip = staged.mip;
+            entry.staging = false;
+            return true;
+        });
+}
+
+void TextureStreamer::update(gfx::Device &device)
+{
+    ZoneScopedN("Texture streaming");
+
+    // the frames that could sample a replaced image have finished by now
+    std::erase_if(m_retired,
+        [&](const RetiredImage &retired)
+        {
+            if (retired.frame + gfx::FRAME_OVERLAP + 1 > m_frame) return false;
+            device.destroyImage(retired.image);
+            return true;
+        });
+
+    std::lock_guard lock(m_mutex);
+    swapStagedImages(device);
+
+    // textures the asset cache let go of, their images stay with the levels they have
+    std::erase_if(m_entries,
+        [&](const auto &item)
+        {
+            if (!item.second.texture.expired()) return false;
+            m_residentSize -= getLevelsSize(item.second.mips, item.second.residentMip);
+            return true;
+        });
+
+    // a texture with a new image on its way keeps it until it is in, the budget sees its old levels till then
+    std::vector<Entry *> entries;
+    entries.reserve(m_entries.size());
+    for (auto &[id, entry] : m_entries)
+    {
+        if (entry.staging) continue;
+        entry.wantedMip = getWantedMip(entry);
+        entries.push_back(&entry);
+    }
+    fitBudget(entries, uint64_t(ProjectManager::getConfig().textureStreamingBudget) << 20);
+
+    // every change of the frame is recorded into one submission, queued after the frame's views, no upload
+    // waits for the GPU
+    gfx::CommandBuffer cmd{VK_NULL_HANDLE};
+
+    // dropping levels only uploads the tail that stays, it is not held back by the allowance
+    std::vector<std::pair<ImageID, Entry *>> raises;
+    for (auto &[id, entry] : m_entries)
+    {
+        if (entry.staging) continue;
+        if (entry.wantedMip > entry.residentMip) stageResidentMip(device, cmd, id, entry, entry.wantedMip);
+        else if (entry.wantedMip < entry.residentMip) raises.emplace_back(id, &entry);
+    }
+
+    // the largest on screen first, with as many levels as the frame's uploads allow
+    std::sort(raises.begin(), raises.end(),
+        [](const auto &a, const auto &b) { return a.second->screenSize > b.second->screenSize; });
+    uint64_t uploaded = 0;
+    for (auto &[id, entry] : raises)
+    {
+        const auto &mips = entry->mips;
+        uint32_t mip = entry->residentMip;
+        uint64_t size = getLevelsSize(mips, mip);
+        while (mip > entry->wantedMip)
+        {
+            // a level larger than the whole allowance still comes in, alone
+            const uint64_t next = size + mips[mip - 1].size;
+            if (uploaded + next > MAX_UPLOAD_PER_FRAME && (uploaded > 0 || mip < entry->residentMip)) break;
+            size = next;
+            --mip;
+        }
+        if (mip == entry->residentMip) break;
+
+        if (stageResidentMip(device, cmd, id, *entry, mip)) uploaded += size;
+    }
+    if (cmd.handle != VK_NULL_HANDLE) device.endOffscreenFrame(cmd);
+
+    for (auto &[id, entry] : m_entries) entry.screenSize = 0.f;
+    ++m_frame;
+}
+
+void TextureStreamer::cleanup(gfx::Device &device)
+{
+    for (const auto &retired : m_retired) device.destroyImage(retired.image);
+    m_retired.clear();
+
+    std::lock_guard lock(m_mutex);
+    for (const auto &staged : m_staged)
+    {
+        device.destroyImage(staged.image);
+        device.destroyBuffer(staged.uploadBuffer);
+    }
+    m_staged.clear();
+    m_entries.clear();
+    m_residentSize = 0;
+}
+} // namespace sky
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <skypch.h>
+#include <glm/glm.hpp>
+
+#include "graphics/vulkan/vk_device.h"
+#include "renderer/frustum_culling.h"
+#include "renderer/mesh.h"
+#include "renderer/texture.h"
+
+namespace sky
+{
+class Camera;
+class MaterialCache;
+
+// Streams the mip chains of cooked material textures. A texture's image starts with only its small tail
+// mips, so it can be sampled as soon as it is loaded, and the higher levels follow over the next frames as
+// far as the screen size of the materials using it asks for. Above the project's budget the highest levels
+// of the textures that are smallest on screen are dropped again. Images keep their ImageID throughout, a
+// texture's new image is uploaded on the side and only takes the id once no frame in flight can be using it.
+class TextureStreamer
+{
+  public:
+    // the first upload holds the levels up to this size
+    static constexpr uint32_t INITIAL_MIP_SIZE = 64;
+    // level bytes uploaded a frame, a texture streams in over several frames rather than stalling one
+    static constexpr uint64_t MAX_UPLOAD_PER_FRAME = 16ull << 20;
+    // updates a texture can go unrequested before it falls back to its tail mips
+    static constexpr uint64_t EVICT_AFTER = 300;
+    // textures of off-screen materials are wanted as if they were this many times smaller
+    static constexpr float OFFSCREEN_WEIGHT = 0.25f;
+
+    // Creates the texture's image with its tail mips and streams the rest in later. Textures that can't
+    // stream are uploaded whole, as by loadImageFromTexture. Called from loading threads.
+    ImageID load(gfx::Device &device, const Ref<Texture2D> &texture, VkFormat format);
+    // The image was replaced with a whole texture, it is not streamed anymore
+    void remove(ImageID id);
+
+    // Called for every view before its draw commands are drawn, keeps the largest screen size of every
+    // material's textures this frame
+    void request(std::span<const MeshDrawCommand> drawCommands, const MaterialCache &materials, const Camera &camera,
+        const Frustum &frustum, float viewportHeight);
+    // Once per frame after every view made its requests: picks the levels each texture should have within
+    // the budget, streams some of them in and drops the rest. The new images are uploaded in a single
+    // submission after the frame's views, and swapped in a few updates later.
+    void update(gfx::Device &device);
+    void cleanup(gfx::Device &device);
+
+    uint64_t getResidentSize() const { return m_residentSize; }
+
+  private:
+    struct Entry
+    {
+        // not kept alive, the asset cache evicts streamed textures like any other and the entry goes with them
+        std::weak_ptr<Texture2D> texture;
+        std::vector<gfx::ImageMipLevel> mips; // the texture's
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t residentMip = 0; // the highest level on the GPU
+        uint32_t tailMip = 0;     // the first level of the initial upload, never dropped
+        uint32_t wantedMip = 0;
+        bool staging = false;     // a new image is on its way, the levels stay as they are until it is in
+        float screenSize = 0.f;   // in pixels, the largest requested this frame
+        uint64_t lastRequested = 0;
+    };
+
+    // uploaded, waiting for the frames that could sample the id's old image
+    struct StagedImage
+    {
+        ImageID id = NULL_IMAGE_ID;
+        gfx::AllocatedImage image;
+        gfx::AllocatedBuffer uploadBuffer;
+        uint32_t mip = 0;
+        uint64_t frame = 0;
+    };
+
+    struct RetiredImage
+    {
+        gfx::AllocatedImage image;
+        uint64_t frame = 0;
+    };
+
+    static uint32_t getTailMip(const Texture2D &texture);
+    static uint64_t getLevelsSize(std::span<const gfx::ImageMipLevel> mips, uint32_t firstMip);
+    uint32_t getWantedMip(const Entry &entry) const;
+    void fitBudget(std::span<Entry *> entries, uint64_t budget);
+    // Records the upload of a new image with the levels from mip on into cmd, which is begun by the first call
+    // of a frame. False when the texture is gone.
+    bool stageResidentMip(gfx::Device &device, gfx::CommandBuffer &cmd, ImageID id, Entry &entry, uint32_t mip);
+    void swapStagedImages(gfx::Device &device);
+
+  private:
+    // guards m_entries and m_residentSize, textures are loaded on the task pool
+    mutable std::mutex m_mutex;
+    std::unordered_map<ImageID, Entry> m_entries;
+    std::vector<StagedImage> m_staged;
+    std::vector<RetiredImage> m_retired;
+    uint64_t m_residentSize = 0;
+    uint64_t m_frame = 0;
+};
+} // namespace sky
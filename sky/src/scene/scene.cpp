@@ -119,8 +119,7 @@ void Scene::useEnvironment()
     if (env.skyboxHandle != NULL_UUID)
     {
         AssetManager::getAssetAsync<TextureCube>(env.skyboxHandle, [=](const Ref<TextureCube> &hdrTex){
-            auto hdrImageId = helper::loadImageFromTexture(hdrTex, VK_FORMAT_R32G32B32A32_SFLOAT);
-            renderer->getIBL().setHdrImageId(hdrImageId);
+            renderer->getIBL().setEnvironment(hdrTex);
         });
     }
     else 
@@ -40,7 +40,12 @@ bool SceneSerializer::deserialize(const fs::path &filepath)
     std::stringstream strStream;
     strStream << stream.rdbuf();
 
-    YAML::Node data = YAML::Load(strStream.str());
+    return deserializeFromMemory(strStream.str());
+}
+
+bool SceneSerializer::deserializeFromMemory(std::string_view source)
+{
+    YAML::Node data = YAML::Load(std::string(source));
 
     if (data["name"]) m_scene->setName(data["name"].as<std::string>());
     if (data["type"]) m_scene->setSceneType(sceneTypeFromString(data["type"].as<std::string>()));
@@ -17,6 +17,7 @@ class SceneSerializer
 
     void serialize(const fs::path &filepath, AssetHandle handle = NULL_UUID);
     bool deserialize(const fs::path &filepath);
+    bool deserializeFromMemory(std::string_view source);
 
   public:
     void serializeEntity(YAML::Emitter &out, Entity entity, AssetHandle handle);
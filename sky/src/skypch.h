@@ -1,6 +1,7 @@
 #pragma once
 // Precompailed headers
 #include <condition_variable>
+#include <coroutine>
 #include <initializer_list>
 #include <unordered_set>
 #include <xmmintrin.h>
@@ -23,6 +24,10 @@
 #include <random>
 #include <regex>
 #include <queue>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <array>
 #include <map>
 #include <set>